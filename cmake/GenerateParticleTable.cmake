@@ -0,0 +1,91 @@
+########################################################
+# Generate the particle data compiled into MarlinUtil::ParticleDataTable
+# from the PDG mass_width csv file. Usage:
+#   cmake -DINPUT=mass_width_2006.csv -DOUTPUT=<file> -P GenerateParticleTable.cmake
+# The output contains one aggregate initialiser per particle state, sorted by
+# PDG code. States without MC code are skipped and for codes listed more than
+# once the first entry is kept.
+########################################################
+
+IF( NOT INPUT OR NOT OUTPUT )
+    MESSAGE( FATAL_ERROR "GenerateParticleTable.cmake: INPUT and OUTPUT have to be set" )
+ENDIF()
+
+# documentation lines start with '*'
+FILE( STRINGS ${INPUT} lines REGEX "^[^*]" )
+
+SET( seen_codes "" )
+SET( entries "" )
+
+FOREACH( line ${lines} )
+
+    STRING( REPLACE "," ";" fields "${line}" )
+    LIST( LENGTH fields nfields )
+    IF( nfields LESS 18 )
+        CONTINUE()
+    ENDIF()
+
+    LIST( GET fields 0 mass )
+    LIST( GET fields 3 width )
+    LIST( GET fields 9 parity )
+    LIST( GET fields 11 anti )
+    LIST( GET fields 12 code )
+    LIST( GET fields 13 charge )
+    LIST( GET fields 16 name )
+    FOREACH( var mass width parity anti code charge name )
+        STRING( STRIP "${${var}}" ${var} )
+    ENDFOREACH()
+
+    IF( NOT ( parity STREQUAL "+" OR parity STREQUAL "-" OR parity STREQUAL "?" OR parity STREQUAL "" ) )
+        CONTINUE()
+    ENDIF()
+    IF( charge STREQUAL "" OR code STREQUAL "" OR code STREQUAL "0" )
+        CONTINUE()
+    ENDIF()
+
+    LIST( FIND seen_codes ${code} found )
+    IF( NOT found EQUAL -1 )
+        CONTINUE()
+    ENDIF()
+    LIST( APPEND seen_codes ${code} )
+
+    # name without anything after the first blank
+    STRING( REGEX REPLACE " .*$" "" name "${name}" )
+    IF( name STREQUAL "" )
+        SET( name "unknown" )
+    ENDIF()
+    IF( mass STREQUAL "" )
+        SET( mass "0.0" )
+    ENDIF()
+    IF( width STREQUAL "" )
+        SET( width "0.0" )
+    ENDIF()
+    IF( anti STREQUAL "" )
+        SET( anti " " )
+    ENDIF()
+
+    # zero padded code as sort key, all codes in the table are positive
+    SET( key "${code}" )
+    STRING( LENGTH "${key}" key_length )
+    WHILE( key_length LESS 10 )
+        SET( key "0${key}" )
+        MATH( EXPR key_length "${key_length} + 1" )
+    ENDWHILE()
+
+    LIST( APPEND entries "${key}|  { ${code}, ${mass}, ${width}, \"${name}\", \"${charge}\", '${anti}' }," )
+
+ENDFOREACH()
+
+LIST( SORT entries )
+
+SET( content "// Generated from ${INPUT} by GenerateParticleTable.cmake - do not edit.\n" )
+SET( content "${content}// pdgCode, mass [MeV], width [MeV], name, charge, antiparticle flag - sorted by pdgCode\n" )
+FOREACH( entry ${entries} )
+    STRING( REGEX REPLACE "^[0-9]+\\|" "" entry "${entry}" )
+    SET( content "${content}${entry}\n" )
+ENDFOREACH()
+
+# only touch the output if it changed, to avoid recompilation
+FILE( WRITE ${OUTPUT}.tmp "${content}" )
+EXECUTE_PROCESS( COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT} )
+FILE( REMOVE ${OUTPUT}.tmp )
@@ -92,9 +92,12 @@ public:
 	virtual void print(int level, ostream &out);// print node
 	virtual void dump(ostream &out);			// dump node
 
-	virtual void ann_search(ANNdist);			// standard search
-	virtual void ann_pri_search(ANNdist);		// priority search
-	virtual void ann_FR_search(ANNdist); 		// fixed-radius search
+												// standard search
+	virtual void ann_search(ANNdist, ANNkd_search_ctx &);
+												// priority search
+	virtual void ann_pri_search(ANNdist, ANNkd_pr_search_ctx &);
+												// fixed-radius search
+	virtual void ann_FR_search(ANNdist, ANNkd_FR_search_ctx &);
 };
 
 #endif
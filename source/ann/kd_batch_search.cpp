@@ -0,0 +1,260 @@
+//----------------------------------------------------------------------
+// File:			kd_batch_search.cpp
+// Description:		Batched kd-tree kNN and fixed-radius searches
+//----------------------------------------------------------------------
+// Part of the copy of the Approximate Nearest Neighbor Library (ANN)
+// in MarlinUtil, provided under the provisions of the Lesser GNU Public
+// License (LGPL).  See the file Copyright.txt for further information.
+//----------------------------------------------------------------------
+
+#include "kd_search.h"					// kd-search declarations
+#include "kd_fix_rad_search.h"			// kd fixed-radius search declarations
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------
+//	Batched searches
+//		The queries of a batch are searched one after the other with
+//		the same search state and the same set of closest points, so
+//		nothing is allocated per query.  The search of each query is
+//		exactly the one of annkSearch() and annkFRSearch().
+//
+//		The queries are first sorted along a Z-order (Morton) curve in
+//		the bounding box of the tree, so consecutive queries are close
+//		to each other and visit mostly the same nodes and points, which
+//		are then still in the cache.  The sorted queries are handed out
+//		in blocks to the threads.  Every result is stored at the index
+//		of its query, so the results do not depend on the order or on
+//		the number of threads.
+//----------------------------------------------------------------------
+
+namespace {
+
+const int		ANNbatchBlock = 64;		// queries handed out at once
+
+//----------------------------------------------------------------------
+//	annSpatialOrder - order of the queries along a Z-order curve
+//----------------------------------------------------------------------
+
+void annSpatialOrder(
+	ANNpointArray		q,				// the query points
+	int					nq,				// number of query points
+	int					dim,			// dimension of space
+	ANNpoint			lo,				// bounding box low point
+	ANNpoint			hi,				// bounding box high point
+	std::vector<int>	&order)			// query indices (returned)
+{
+	int n_dims = std::min(dim, 63);		// dimensions used for the code
+	int n_bits = std::min(63/n_dims, 21);	// bits per dimension
+	double max_cell = (double) ((1 << n_bits) - 1);
+
+	std::vector<std::pair<unsigned long long, int> > codes(nq);
+	std::vector<unsigned int> cells(n_dims);
+
+	for (int i = 0; i < nq; i++) {
+		for (int d = 0; d < n_dims; d++) {	// cell in the bounding box
+			double width = hi[d] - lo[d];
+			double x = (width > 0 ? (q[i][d] - lo[d]) / width : 0);
+			x = std::max(0.0, std::min(1.0, x));
+			cells[d] = (unsigned int) (x * max_cell);
+		}
+		unsigned long long code = 0;	// interleave the bits
+		for (int b = n_bits-1; b >= 0; b--) {
+			for (int d = 0; d < n_dims; d++) {
+				code = (code << 1) | ((cells[d] >> b) & 1);
+			}
+		}
+		codes[i] = std::make_pair(code, i);
+	}
+	std::sort(codes.begin(), codes.end());
+
+	order.resize(nq);
+	for (int i = 0; i < nq; i++) order[i] = codes[i].second;
+}
+
+//----------------------------------------------------------------------
+//	annRunBatch - run search(query) for all queries in spatial order
+//		search is copied to every thread, so it can hold the search
+//		state of its thread.
+//----------------------------------------------------------------------
+
+template <class Search>
+void annRunBatch(
+	const std::vector<int>	&order,		// query indices in spatial order
+	int					n_threads,		// number of threads (0 = all cores)
+	const Search		&search)		// search of one query
+{
+	int nq = (int) order.size();
+	int n_blocks = (nq + ANNbatchBlock - 1) / ANNbatchBlock;
+
+	if (n_threads <= 0) n_threads = (int) std::thread::hardware_concurrency();
+	n_threads = std::max(1, std::min(n_threads, n_blocks));
+
+	std::atomic<int> next_block(0);		// next block to be searched
+	auto run = [&order, &next_block, n_blocks, nq, &search]() {
+		Search thread_search(search);	// search state of this thread
+		int b;
+		while ((b = next_block++) < n_blocks) {
+			int end = std::min(nq, (b+1)*ANNbatchBlock);
+			for (int i = b*ANNbatchBlock; i < end; i++) {
+				thread_search(order[i]);
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int t = 1; t < n_threads; t++) threads.emplace_back(run);
+	run();								// the calling thread searches too
+	for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+}
+
+//----------------------------------------------------------------------
+//	Search of one query for annkSearchBatch, with its own search state
+//----------------------------------------------------------------------
+
+class ANNkd_batch_search {
+	ANNkd_ptr			root;			// root of the tree
+	ANNpointArray		q;				// the query points
+	ANNpoint			lo, hi;			// bounding box of the tree
+	int					k;				// number of near neighbors
+	ANNidxArray			nn_idx;			// nearest neighbors (returned)
+	ANNdistArray		dd;				// distances (returned)
+	ANNkd_search_ctx	ctx;			// search state
+	ANNmin_k			pointMK;		// set of k closest points
+
+public:
+	ANNkd_batch_search(ANNkd_ptr r, ANNpointArray qa, ANNpoint l, ANNpoint h,
+			int kk, ANNidxArray idx, ANNdistArray d, const ANNkd_search_ctx &c)
+		: root(r), q(qa), lo(l), hi(h), k(kk), nn_idx(idx), dd(d), ctx(c), pointMK(kk)
+		{ ctx.pointMK = &pointMK; }
+
+	ANNkd_batch_search(const ANNkd_batch_search &s)		// copy, with own set
+		: root(s.root), q(s.q), lo(s.lo), hi(s.hi), k(s.k), nn_idx(s.nn_idx),
+		  dd(s.dd), ctx(s.ctx), pointMK(s.k)
+		{ ctx.pointMK = &pointMK; }
+
+	void operator()(int i)
+		{
+			ctx.q = q[i];
+			ctx.ptsVisited = 0;
+			pointMK.reset();
+			root->ann_search(annBoxDistance(q[i], lo, hi, ctx.dim), ctx);
+
+			for (int j = 0; j < k; j++) {	// extract the k-th closest points
+				dd[i*k+j] = pointMK.ith_smallest_key(j);
+				nn_idx[i*k+j] = pointMK.ith_smallest_info(j);
+			}
+		}
+};
+
+//----------------------------------------------------------------------
+//	Search of one query for annkFRSearchBatch, with its own search state
+//----------------------------------------------------------------------
+
+class ANNkd_FR_batch_search {
+	ANNkd_ptr			root;			// root of the tree
+	ANNpointArray		q;				// the query points
+	ANNpoint			lo, hi;			// bounding box of the tree
+	int					k;				// number of near neighbors
+	ANNidxArray			nn_idx;			// nearest neighbors (returned)
+	ANNdistArray		dd;				// distances (returned)
+	int					*n_in_range;	// points in range (returned)
+	ANNkd_FR_search_ctx	ctx;			// search state
+	ANNmin_k			pointMK;		// set of k closest points
+
+public:
+	ANNkd_FR_batch_search(ANNkd_ptr r, ANNpointArray qa, ANNpoint l, ANNpoint h,
+			int kk, ANNidxArray idx, ANNdistArray d, int *n_in,
+			const ANNkd_FR_search_ctx &c)
+		: root(r), q(qa), lo(l), hi(h), k(kk), nn_idx(idx), dd(d),
+		  n_in_range(n_in), ctx(c), pointMK(kk)
+		{ ctx.pointMK = &pointMK; }
+
+	ANNkd_FR_batch_search(const ANNkd_FR_batch_search &s)	// copy, with own set
+		: root(s.root), q(s.q), lo(s.lo), hi(s.hi), k(s.k), nn_idx(s.nn_idx),
+		  dd(s.dd), n_in_range(s.n_in_range), ctx(s.ctx), pointMK(s.k)
+		{ ctx.pointMK = &pointMK; }
+
+	void operator()(int i)
+		{
+			ctx.q = q[i];
+			ctx.ptsVisited = 0;
+			ctx.ptsInRange = 0;
+			pointMK.reset();
+			root->ann_FR_search(annBoxDistance(q[i], lo, hi, ctx.dim), ctx);
+
+			for (int j = 0; j < k; j++) {	// extract the k-th closest points
+				if (dd != NULL)
+					dd[i*k+j] = pointMK.ith_smallest_key(j);
+				if (nn_idx != NULL)
+					nn_idx[i*k+j] = pointMK.ith_smallest_info(j);
+			}
+			if (n_in_range != NULL)
+				n_in_range[i] = ctx.ptsInRange;
+		}
+};
+
+}
+
+//----------------------------------------------------------------------
+//	annkSearchBatch - search for the k nearest neighbors of many points
+//----------------------------------------------------------------------
+
+void ANNkd_tree::annkSearchBatch(
+	ANNpointArray		q,				// the query points
+	int					nq,				// number of query points
+	int					k,				// number of near neighbors to return
+	ANNidxArray			nn_idx,			// nearest neighbor indices (returned)
+	ANNdistArray		dd,				// the approximate nearest neighbors
+	double				eps,			// the error bound
+	int					n_threads)		// number of threads
+{
+	if (k > n_pts) {					// too many near neighbors?
+		annError("Requesting more near neighbors than data points", ANNabort);
+	}
+	if (nq <= 0) return;
+
+	ANNkd_search_ctx ctx;				// state common to all queries
+	ctx.dim = dim;
+	ctx.pts = pts;
+	ctx.maxErr = ANN_POW(1.0 + eps);
+
+	std::vector<int> order;
+	annSpatialOrder(q, nq, dim, bnd_box_lo, bnd_box_hi, order);
+	annRunBatch(order, n_threads,
+			ANNkd_batch_search(root, q, bnd_box_lo, bnd_box_hi, k, nn_idx, dd, ctx));
+}
+
+//----------------------------------------------------------------------
+//	annkFRSearchBatch - fixed radius search for many points
+//----------------------------------------------------------------------
+
+void ANNkd_tree::annkFRSearchBatch(
+	ANNpointArray		q,				// the query points
+	int					nq,				// number of query points
+	ANNdist				sqRad,			// squared radius search bound
+	int					k,				// number of near neighbors to return
+	ANNidxArray			nn_idx,			// nearest neighbor indices (returned)
+	ANNdistArray		dd,				// the approximate nearest neighbors
+	int					*n_in_range,	// points in range (returned)
+	double				eps,			// the error bound
+	int					n_threads)		// number of threads
+{
+	if (nq <= 0) return;
+
+	ANNkd_FR_search_ctx ctx;			// state common to all queries
+	ctx.dim = dim;
+	ctx.pts = pts;
+	ctx.sqRad = sqRad;
+	ctx.maxErr = ANN_POW(1.0 + eps);
+
+	std::vector<int> order;
+	annSpatialOrder(q, nq, dim, bnd_box_lo, bnd_box_hi, order);
+	annRunBatch(order, n_threads,
+			ANNkd_FR_batch_search(root, q, bnd_box_lo, bnd_box_hi, k, nn_idx, dd,
+					n_in_range, ctx));
+}
@@ -32,13 +32,22 @@
 #include <ANN/ANNperf.h>				// performance evaluation
 
 //----------------------------------------------------------------------
-//	Global variables
-//		These are active for the life of each call to
-//		annRangeSearch().  They are set to save the number of
-//		variables that need to be passed among the various search
-//		procedures.
+//	Search state
+//		This is active for the life of each call to annkFRSearch().
+//		It is passed to the recursive search procedures to save the
+//		number of arguments, and replaces the global variables used
+//		before, so that concurrent searches do not interfere.
 //----------------------------------------------------------------------
 
-extern ANNpoint			ANNkdFRQ;			// query point (static copy)
+struct ANNkd_FR_search_ctx {
+	int				dim;				// dimension of space
+	ANNpoint		q;					// query point
+	ANNdist			sqRad;				// squared radius search bound
+	double			maxErr;				// max tolerable squared error
+	ANNpointArray	pts;				// the points
+	ANNmin_k		*pointMK;			// set of k closest points
+	int				ptsVisited;			// total points visited
+	int				ptsInRange;			// number of points in the range
+};
 
 #endif
@@ -33,17 +33,20 @@
 #include <ANN/ANNperf.h>				// performance evaluation
 
 //----------------------------------------------------------------------
-//	Global variables
-//		Active for the life of each call to Appx_Near_Neigh() or
-//		Appx_k_Near_Neigh().
+//	Search state
+//		Active for the life of each call to annkPriSearch(), and passed
+//		to the recursive search procedures instead of global variables,
+//		so that concurrent searches do not interfere.
 //----------------------------------------------------------------------
 
-extern double			ANNprEps;		// the error bound
-extern int				ANNprDim;		// dimension of space
-extern ANNpoint			ANNprQ;			// query point
-extern double			ANNprMaxErr;	// max tolerable squared error
-extern ANNpointArray	ANNprPts;		// the points
-extern ANNpr_queue		*ANNprBoxPQ;	// priority queue for boxes
-extern ANNmin_k			*ANNprPointMK;	// set of k closest points
+struct ANNkd_pr_search_ctx {
+	int				dim;				// dimension of space
+	ANNpoint		q;					// query point
+	double			maxErr;				// max tolerable squared error
+	ANNpointArray	pts;				// the points
+	ANNpr_queue		*boxPQ;				// priority queue for boxes
+	ANNmin_k		*pointMK;			// set of k closest points
+	int				ptsVisited;			// number of points visited
+};
 
 #endif
@@ -43,13 +43,26 @@ using namespace std;					// make std:: available
 //		this.
 //----------------------------------------------------------------------
 
+//----------------------------------------------------------------------
+//	The state of one search is passed down the recursive search calls,
+//	so that searches in different threads do not interfere, even on
+//	the same tree.  The search states are declared with the searches.
+//----------------------------------------------------------------------
+
+struct ANNkd_search_ctx;				// standard search (kd_search.h)
+struct ANNkd_pr_search_ctx;				// priority search (kd_pr_search.h)
+struct ANNkd_FR_search_ctx;				// fixed-radius search (kd_fix_rad_search.h)
+
 class ANNkd_node{						// generic kd-tree node (empty shell)
 public:
 	virtual ~ANNkd_node() {}					// virtual distroyer
 
-	virtual void ann_search(ANNdist) = 0;		// tree search
-	virtual void ann_pri_search(ANNdist) = 0;	// priority search
-	virtual void ann_FR_search(ANNdist) = 0;	// fixed-radius search
+												// tree search
+	virtual void ann_search(ANNdist, ANNkd_search_ctx &) = 0;
+												// priority search
+	virtual void ann_pri_search(ANNdist, ANNkd_pr_search_ctx &) = 0;
+												// fixed-radius search
+	virtual void ann_FR_search(ANNdist, ANNkd_FR_search_ctx &) = 0;
 
 	virtual void getStats(						// get tree statistics
 				int dim,						// dimension of space
@@ -110,9 +123,12 @@ public:
 	virtual void print(int level, ostream &out);// print node
 	virtual void dump(ostream &out);			// dump node
 
-	virtual void ann_search(ANNdist);			// standard search
-	virtual void ann_pri_search(ANNdist);		// priority search
-	virtual void ann_FR_search(ANNdist);		// fixed-radius search
+												// standard search
+	virtual void ann_search(ANNdist, ANNkd_search_ctx &);
+												// priority search
+	virtual void ann_pri_search(ANNdist, ANNkd_pr_search_ctx &);
+												// fixed-radius search
+	virtual void ann_FR_search(ANNdist, ANNkd_FR_search_ctx &);
 };
 
 //----------------------------------------------------------------------
@@ -176,9 +192,12 @@ public:
 	virtual void print(int level, ostream &out);// print node
 	virtual void dump(ostream &out);			// dump node
 
-	virtual void ann_search(ANNdist);			// standard search
-	virtual void ann_pri_search(ANNdist);		// priority search
-	virtual void ann_FR_search(ANNdist);		// fixed-radius search
+												// standard search
+	virtual void ann_search(ANNdist, ANNkd_search_ctx &);
+												// priority search
+	virtual void ann_pri_search(ANNdist, ANNkd_pr_search_ctx &);
+												// fixed-radius search
+	virtual void ann_FR_search(ANNdist, ANNkd_FR_search_ctx &);
 };
 
 //----------------------------------------------------------------------
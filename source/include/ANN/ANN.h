@@ -483,6 +483,21 @@ DLL_API ANNpoint annCopyPt(
 //		outside a ball of radius r/(1+epsilon), where r is the given
 //		(unsquared) radius bound.
 //
+//		The searches of the kd- and bd-trees keep their state per call,
+//		so a tree may be searched from several threads at the same time
+//		(with different result arrays).  Building or deleting a tree,
+//		annMaxPtsVisit() and the ANN_PERF statistics are not thread safe.
+//
+//		The batched searches annkSearchBatch and annkFRSearchBatch of
+//		the kd- and bd-trees answer nq queries at once.  The results of
+//		query i are stored at [i*k ... i*k+k-1] of nn_idx and dd, which
+//		the caller allocates with nq*k entries, and the number of points
+//		in range of a fixed-radius query at n_in_range[i].  The queries
+//		are processed in an order that keeps neighboring queries
+//		together, so tree nodes are reused from the cache, and are split
+//		among n_threads threads.  The results are the same as those of
+//		single queries, in any order and with any number of threads.
+//
 //		The generic object from which all the search structures are
 //		dervied is given below.  It is a virtual object, and is useless
 //		by itself.
@@ -760,6 +775,27 @@ public:
 		ANNdistArray	dd = NULL,		// dist to near neighbors (modified)
 		double			eps=0.0);		// error bound
 
+										// batched searches, described above the class
+	void annkSearchBatch(				// approx k near neighbor search
+		ANNpointArray	q,				// query points
+		int				nq,				// number of query points
+		int				k,				// number of near neighbors per query
+		ANNidxArray		nn_idx,			// k near neighbors per query (modified)
+		ANNdistArray	dd,				// k distances per query (modified)
+		double			eps=0.0,		// error bound
+		int				n_threads=1);	// number of threads (0 = all cores)
+
+	void annkFRSearchBatch(				// approx fixed-radius kNN search
+		ANNpointArray	q,				// query points
+		int				nq,				// number of query points
+		ANNdist			sqRad,			// squared radius of query balls
+		int				k,				// number of neighbors per query
+		ANNidxArray		nn_idx = NULL,	// k near neighbors per query (modified)
+		ANNdistArray	dd = NULL,		// k distances per query (modified)
+		int				*n_in_range = NULL,	// points in range per query (modified)
+		double			eps=0.0,		// error bound
+		int				n_threads=1);	// number of threads (0 = all cores)
+
 	int theDim()						// return dimension of space
 		{ return dim; }
 
@@ -56,7 +56,9 @@ enum ANNerr {ANNwarn = 0, ANNabort = 1};
 //----------------------------------------------------------------------
 
 extern int		ANNmaxPtsVisited;	// maximum number of pts visited
-extern int		ANNptsVisited;		// number of pts visited in search
+										// number of pts visited in the last
+										// search of the calling thread
+extern thread_local int	ANNptsVisited;
 
 //----------------------------------------------------------------------
 //	Global function declarations
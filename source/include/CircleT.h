@@ -0,0 +1,48 @@
+#ifndef CircleT_H
+#define CircleT_H 1
+
+#include "Vector3T.h"
+
+#include <cmath>
+
+/** Header-only, templated version of Circle: the circle in the x-y plane
+ *  passing through three points. The z components of the points are ignored.
+ *  As for Circle, GetRadius() returns -1 if the points are colinear.
+ */
+
+template<typename FloatT>
+class CircleT {
+public:
+  using float_type = FloatT;
+  using vector_type = Vector3T<FloatT>;
+
+  CircleT() = default;
+
+  CircleT(const vector_type& p1, const vector_type& p2, const vector_type& p3) {
+    // circumcentre from the perpendicular bisectors, relative to p1 to limit rounding
+    const FloatT bx = p2.x() - p1.x(), by = p2.y() - p1.y();
+    const FloatT cx = p3.x() - p1.x(), cy = p3.y() - p1.y();
+    const FloatT det = 2 * (bx*cy - by*cx);
+
+    const FloatT scale = (bx*bx + by*by) * (cx*cx + cy*cy);
+    if (std::fabs(det) <= FloatT(1e-9) * std::sqrt(scale) || scale == 0) {
+      return;
+    }
+
+    const FloatT b2 = bx*bx + by*by, c2 = cx*cx + cy*cy;
+    const FloatT ux = (cy*b2 - by*c2) / det;
+    const FloatT uy = (bx*c2 - cx*b2) / det;
+
+    _center.set(p1.x() + ux, p1.y() + uy, 0);
+    _radius = std::sqrt(ux*ux + uy*uy);
+  }
+
+  FloatT GetRadius() const { return _radius; }
+  vector_type GetCenter() const { return _center; }
+
+private:
+  FloatT _radius = -1; // error checking
+  vector_type _center{};
+};
+
+#endif /* ifndef CircleT_H */
@@ -49,6 +49,7 @@ class CutOnGEANT4Bug : public Processor {
 
   std::vector<float> _calibrCoeffECAL{};
   std::vector<float> _calibrCoeffHCAL{};
+  std::vector<float> _calibration{};  ///< ECAL followed by HCAL coefficients, indexed by the hit type
 
   int _nRun=-1;
   int _nEvt=-1;
@@ -0,0 +1,67 @@
+#ifndef FPCCDClusterFinder_h
+#define FPCCDClusterFinder_h 1
+
+#include "FPCCDPixelHit.h"
+#include "FPCCDPixelStore.h"
+
+#include <vector>
+
+class FPCCDData;
+
+/** ======= FPCCDPixelCluster ========== <br>
+ * A cluster of connected fired pixels of one ladder, found by
+ * FPCCDClusterFinder. xi and zeta are the edep weighted centroid in units
+ * of pixels, in the local coordinates of the ladder described in
+ * FPCCDPixelHit.h, i.e. pixel ( xiID, zetaID ) has its centre at
+ * ( xiID, zetaID ).
+ *
+ * quality combines the quality of the pixels:
+ *    kSingle        : signal pixels made by single SimTrackerHits only
+ *    kSignalOverlap : signal pixels only, at least one of them made by
+ *                     several SimTrackerHits
+ *    kBKGOverlap    : signal and background
+ *    kBKG           : background pixels only
+ */
+struct FPCCDPixelCluster {
+  unsigned short layer;
+  unsigned short ladder;
+  float xi;
+  float zeta;
+  float edep;
+  unsigned int nPixels;
+  unsigned short xiMin, xiMax;
+  unsigned short zetaMin, zetaMax;
+  FPCCDPixelHit::HitQuality_t quality;
+};
+
+
+/** ======= FPCCDClusterFinder ========== <br>
+ * Connected component clustering of the fired pixels of FPCCDData. <br>
+ *
+ * The pixels of a ladder are sorted by xi and then zeta, so one scan over
+ * the pixels, comparing each pixel only with the previous pixel of its
+ * column and with the pixels of the previous column in the zeta range of
+ * the neighbours, finds all pairs of neighbouring pixels. Pixels are joined
+ * with a union-find structure. Ladders are clustered in parallel when
+ * FPCCDData::setNumberOfThreads(...) allows more than one thread (the
+ * default is one), see FPCCDData::forEachLadder(...). The result does not
+ * depend on the number of threads.
+ */
+// =================================================================
+class FPCCDClusterFinder {
+ public:
+  // diagonal=true connects pixels sharing a corner (8 neighbours), otherwise
+  // only pixels sharing an edge (4 neighbours)
+  FPCCDClusterFinder(bool diagonal=true);
+
+  // Clusters of all ladders, ordered by layer, ladder and first pixel
+  void findClusters(FPCCDData &data, std::vector<FPCCDPixelCluster> &clusters);
+
+  // Clusters of one ladder, appended to clusters
+  void findClusters(FPCCDPixelStore &store, int layer, int ladder, std::vector<FPCCDPixelCluster> &clusters) const;
+
+ protected:
+  bool _diagonal;
+};
+
+#endif
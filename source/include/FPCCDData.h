@@ -1,14 +1,17 @@
 #ifndef FPCCDData_h
 #define FPCCDData_h 1
 
+#include "FPCCDPixelLibrary.h"
+#include "FPCCDPixelStore.h"
+
+#include <functional>
 #include <vector>
-#include <map>
 
 /** ======= FPCCDData ========== <br>
  * A class to store all FPCCD's data. <br>
  * Used by FPCCDDigitizer and FPCCDClustering 
  *
- * packPixelHits(...) copies PixelHit data in _pxHits(PixelDataBuf_t) 
+ * packPixelHits(...) copies PixelHit data in _pxHits(PixelStoreBuf_t)
  * to LCGenericObject of name VTXPixelHits as integer data and 
  * unpackPixelHits(...) copies LCGenericObject to _pxHits.
  *
@@ -17,7 +20,8 @@
  *  - First 32 bit word contains layerID and ladderID of the element.
  *    Counting bit position from left to right, layerID and ladderID
  *    information are stored as follows. 
- *      bit 31-16: reserved for future use
+ *      bit 31-16: format version, 0 for the format below, 1 for the
+ *                 compressed format described further down
  *      bit 15-8 : layerID
  *      bit 7-0  : ladderID
  *  - Last words are for pixel hits in a ladder. Two word is used 
@@ -37,7 +41,38 @@
  *       bit 15-0  : zetaID
  *    -- Second word
  *       dEdx value given by SimTrackerHit object.
- *       Float value is stored with a help of union.
+ *       Float value is stored as its bit pattern.
+ *    -- Third word
+ *       number of order IDs of the hit, followed by one word per order ID.
+ *
+ * Compressed format (version 1), written if selected with setPackFormat(...):
+ *  - First word as above.
+ *  - Second word : number of pixel hits in the ladder.
+ *  - Third word  : edep quantum as float bit pattern, 0 if edep is stored
+ *                  without loss.
+ *  - Last words are a byte stream, byte k is stored in bit 8*(k%4)+7 to
+ *    8*(k%4) of the k/4-th of these words. Hits are in increasing order of the
+ *    cellID ( bit 28-16 : xiID, bit 15-0 : zetaID ), each hit is
+ *      -- varint of the cellID minus the cellID of the previous hit (0 for
+ *         the first hit)
+ *      -- varint of ( number of order IDs << 2 | hit quality bits )
+ *      -- edep, 4 bytes of the float bit pattern (least significant byte
+ *         first), or with a quantum the zigzag varint of round(edep/quantum),
+ *         so |edep| has to stay below about 2^31*quantum, larger values are
+ *         stored as the largest value of that range
+ *      -- one zigzag varint per order ID of the difference to the previous
+ *         order ID in the ladder (to 0 for the first one)
+ *    A varint stores 7 bits per byte, least significant first, the highest
+ *    bit of a byte is set if more bytes follow. zigzag maps 0,-1,1,-2,...
+ *    to 0,1,2,3,...
+ *  unpackPixelHits(...) reads both formats.
+ *
+ * In memory the hits of each ladder are kept in a FPCCDPixelStore, a
+ * vector sorted by the encoded cell ID, instead of one map node and one
+ * FPCCDPixelHit object per hit. Add(...) merges the sorted hits ladder by
+ * ladder in a single pass, single threaded unless more threads are allowed
+ * with setNumberOfThreads(...). Background from a memory mapped
+ * FPCCDPixelLibrary is overlaid the same way, directly from the file.
  *
  * <br>
  * @author Akiya Miyamoto, KEK: 2010-04-19
@@ -48,23 +83,36 @@ namespace IMPL {  class LCCollectionVec; }
 namespace EVENT {  class LCCollection; }
 class FPCCDPixelHit;
 
-typedef std::map<unsigned int, FPCCDPixelHit*> PixelHitMap_t; //key will be encorded cellID. 
-typedef std::vector< std::vector<PixelHitMap_t> > PixelDataBuf_t;
+typedef std::vector< std::vector<FPCCDPixelStore> > PixelStoreBuf_t;
+typedef FPCCDPixelStore::const_iterator PixelIterator_t;
 
 
 // =================================================================
 class FPCCDData {
+ public:
+  // Formats of the LCGenericObjects, the value is stored in bit 31-16 of the first word
+  typedef enum { kPlainFormat=0, kCompressedFormat=1 } PackFormat_t;
+
  protected:
   int _maxlayer;
   int _maxladder;
-  PixelDataBuf_t _pxHits; // Hit map for each layer/ladder
+  PixelStoreBuf_t _pxHits; // Hits of each layer/ladder
+  unsigned int _nThreads;
+  PackFormat_t _packFormat;
+  float _edepQuantum;
+
+  // words of the LCGenericObject of one ladder, see above for the format
+  void packLadder(int layer, int ladder, std::vector<int> &words);
+  int unpackLadder(const int *words, int nWords);
+  void packLadderCompressed(int layer, int ladder, std::vector<int> &words);
+  int unpackLadderCompressed(const int *words, int nWords);
 
  public:
   FPCCDData(int max_layer, int max_ladder);
 
   // Add
   //  if same hit exists, add ADC values
-  //  if new hit, create a new Pixel hit and store in map
+  //  if new hit, create a new Pixel hit
   void addPixelHit(FPCCDPixelHit &aHit, bool isSignal);
 
   // Clear
@@ -76,18 +124,48 @@ class FPCCDData {
   // Copy pixelhit info in _pxHits;
   int unpackPixelHits(EVENT::LCCollection &col);
 
-  //
+  // Add all hits of bkgHit, hits of quality kSingle as signal, others as background
   void Add(FPCCDData &bkgHit);
 
   void Add(FPCCDData &bkgHit, int layer, int ladder);
-  // iterators to get pixel hit.
-  PixelHitMap_t::iterator itBegin(int layer, int ladder){ 
+
+  // Add all hits of one entry of a background library, with the same rules.
+  // Layers and ladders that are not in both are skipped.
+  void Add(const FPCCDPixelLibrary::Entry &bkgEntry);
+
+  int getMaxLayer() const { return _maxlayer; }
+  int getMaxLadder() const { return _maxladder; }
+  // iterators to get pixel hit, ordered by the encoded cellID.
+  PixelIterator_t itBegin(int layer, int ladder){ 
 	return _pxHits[layer][ladder].begin();
   }
-  PixelHitMap_t::iterator itEnd(int layer, int ladder){
+  PixelIterator_t itEnd(int layer, int ladder){
 	return _pxHits[layer][ladder].end();
   }
 
+  // all hits of a ladder
+  FPCCDPixelStore &getLadder(int layer, int ladder){ return _pxHits[layer][ladder]; }
+
+  // the pixel hit an iterator of a ladder points to, as FPCCDPixelHit
+  FPCCDPixelHit getPixelHit(int layer, int ladder, const FPCCDPixel &pixel);
+
+
+  // Format written by packPixelHits(...). With kCompressedFormat edep is
+  // rounded to a multiple of edepQuantum if that is above 0, which limits
+  // |edep| to about 2^31*edepQuantum.
+  void setPackFormat(PackFormat_t format, float edepQuantum=0.0){ _packFormat=format; _edepQuantum=edepQuantum; }
+
+  // Call func(layer, ladder) for every ladder. nPixels is the number of
+  // pixels to be processed, the ladders are distributed over several
+  // threads if it is large enough. func must only access the given ladder.
+  void forEachLadder(const std::function<void(int, int)> &func, std::size_t nPixels);
+
+  // Number of pixels in all ladders, before merging deposits in the same pixel
+  std::size_t sizeHint() const;
+
+  // Maximum number of threads used to process ladders in parallel, 1 (the
+  // default) to stay single threaded, 0 for the number of cores.
+  void setNumberOfThreads(unsigned int nThreads){ _nThreads=nThreads; }
 
   // dump
   void dump();
@@ -95,6 +173,3 @@ class FPCCDData {
 };
 
 #endif
-
-
-
@@ -0,0 +1,151 @@
+#ifndef FPCCDPixelLibrary_h
+#define FPCCDPixelLibrary_h 1
+
+#include "FPCCDPixelStore.h"
+#include "MappedRecordFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class FPCCDData;
+
+/** ======= FPCCDPixelLibrary ========== <br>
+ * Library of background pixel hits, e.g. of many bunch crossings of pair
+ * background, prepared for the overlay with FPCCDData::Add(...). <br>
+ *
+ * The file is memory mapped and the pixels are overlaid directly from the
+ * mapped pages, without decoding LCGenericObjects or allocating memory per
+ * pixel. Files are written by FPCCDPixelLibraryWriter, see
+ * FPCCDPixelLibraryWriter::convert(...) for the conversion of background
+ * files in the LCGenericObject format of FPCCDData.h.
+ *
+ * Format of the file:
+ *  FileHeader, followed by one entry per background event (bunch crossing)
+ *  that is only ever appended. An entry is an EntryHeader followed by
+ *    uint32     ladderBegin [nLayers*nLadders+1]
+ *    FPCCDPixel pixels      [nPixels]
+ *    int32      orderIDs    [nOrderIDs]
+ *  The pixels of ladder ( layer, ladder ) are
+ *  pixels[ ladderBegin[i] ... ladderBegin[i+1] ) with i = layer*nLadders+ladder,
+ *  sorted by cell word as in FPCCDPixelStore. orderBegin of a pixel is the
+ *  index of its first order ID in orderIDs of the entry.
+ *  Every array starts at a multiple of 8 bytes from the start of the file.
+ *  All numbers are in native byte order.
+ */
+namespace FPCCDLibraryFormat {
+
+  const char fileMagic[8] = { 'F', 'P', 'C', 'C', 'D', 'B', 'K', 'G' } ;
+  const uint32_t entryMagic = 0x544e4542 ;  // "BENT"
+  const uint32_t formatVersion = 1 ;
+
+  struct FileHeader {
+    char magic[8] ;
+    uint32_t version ;
+    uint32_t headerSize ;
+    uint32_t nLayers ;
+    uint32_t nLadders ;
+  } ;
+
+  struct EntryHeader {
+    uint32_t magic ;
+    uint32_t headerSize ;
+    uint64_t recordSize ;      // in bytes, including this header
+    uint32_t nPixels ;
+    uint32_t nOrderIDs ;
+  } ;
+
+  static_assert( sizeof( FileHeader ) % 8 == 0 && sizeof( EntryHeader ) % 8 == 0, "headers have to keep the arrays aligned" ) ;
+  static_assert( offsetof( FileHeader, headerSize ) == offsetof( MarlinUtil::RecordFileHeader, headerSize )
+                 && offsetof( EntryHeader, recordSize ) == offsetof( MarlinUtil::RecordHeader, recordSize ),
+                 "headers have to start as in MappedRecordFile" ) ;
+  static_assert( sizeof( FPCCDPixel ) == 20, "FPCCDPixel is stored as is in the file" ) ;
+
+  // Byte offsets of the arrays from the start of an entry
+  struct EntryLayout {
+    uint64_t ladderBegin, pixels, orderIDs ;
+    uint64_t size ;            // total size of the entry
+  } ;
+
+  EntryLayout entryLayout( const EntryHeader &header, uint32_t nLadderSlots ) ;
+
+}
+
+
+// =================================================================
+class FPCCDPixelLibrary {
+ public:
+
+  // One background event, pointing into the mapped file
+  struct Entry {
+    const FPCCDLibraryFormat::EntryHeader *header;
+    const uint32_t *ladderBegin;
+    const FPCCDPixel *pixels;
+    const int *orderIDs;
+    int nLayers;
+    int nLadders;
+
+    unsigned int getNPixels() const { return header->nPixels; }
+    const FPCCDPixel *begin(int layer, int ladder) const { return pixels + ladderBegin[layer*nLadders+ladder]; }
+    const FPCCDPixel *end(int layer, int ladder) const { return pixels + ladderBegin[layer*nLadders+ladder+1]; }
+  };
+
+  // Maps the file, throws std::runtime_error if it cannot be opened, is not
+  // a pixel library or has an entry whose ladders or order IDs point outside
+  // of the entry
+  FPCCDPixelLibrary(const std::string &fileName);
+
+  FPCCDPixelLibrary(const FPCCDPixelLibrary&) = delete;
+  FPCCDPixelLibrary& operator=(const FPCCDPixelLibrary&) = delete;
+
+  int getNLayers() const { return _nLayers; }
+  int getNLadders() const { return _nLadders; }
+
+  // Complete entries in the file, an incomplete last entry is ignored
+  std::size_t getNumberOfEntries() const { return _entries.size(); }
+
+  Entry getEntry(std::size_t i) const;
+
+  // File size up to the end of the last complete entry
+  std::size_t getEndOfRecords() const { return _file.getEndOfRecords(); }
+
+ protected:
+  MarlinUtil::MappedRecordFile _file;
+  int _nLayers=0;
+  int _nLadders=0;
+  std::vector<std::size_t> _entries{};  // file offsets of the complete entries
+};
+
+
+// =================================================================
+class FPCCDPixelLibraryWriter {
+ public:
+  // Opens the file for appending, creating it if needed. An incomplete last
+  // entry, left by a job that did not finish, is cut off first. Throws
+  // std::runtime_error if that fails or the file has a different geometry.
+  FPCCDPixelLibraryWriter(const std::string &fileName, int nLayers, int nLadders);
+
+  FPCCDPixelLibraryWriter(const FPCCDPixelLibraryWriter&) = delete;
+  FPCCDPixelLibraryWriter& operator=(const FPCCDPixelLibraryWriter&) = delete;
+
+  // Append all pixel hits of data as one entry
+  void write(FPCCDData &data);
+
+  void flush();
+
+  // Convert the collection colName of every event in the LCIO files, in the
+  // LCGenericObject format of FPCCDData.h, to entries of the library
+  // libraryName. Returns the number of converted events.
+  static int convert(const std::vector<std::string> &lcioFileNames, const std::string &colName,
+                     const std::string &libraryName, int nLayers, int nLadders);
+
+ protected:
+  std::ofstream _file{};
+  int _nLayers;
+  int _nLadders;
+  std::vector<uint64_t> _buffer{};     // entry under construction, 8 byte aligned
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef FPCCDPixelStore_h
+#define FPCCDPixelStore_h 1
+
+#include "FPCCDPixelHit.h"
+
+#include <vector>
+
+/** ======= FPCCDPixel ========== <br>
+ * One fired pixel of a ladder as kept in FPCCDPixelStore. <br>
+ * cellWord is the cell ID as given by FPCCDPixelHit::encodeCellWord(),
+ * i.e. bit 28-16 : xiID and bit 15-0 : zetaID. The order IDs of the pixel
+ * are the nOrderIDs entries starting at orderBegin in the order ID pool
+ * of the ladder, see FPCCDPixelStore::getOrderIDs().
+ */
+struct FPCCDPixel {
+  unsigned int cellWord;
+  float        edep;
+  FPCCDPixelHit::HitQuality_t quality;
+  unsigned int orderBegin;
+  unsigned int nOrderIDs;
+
+  int getXiID() const { return ( cellWord >> 16 ) & 0x1FFF; }
+  int getZetaID() const { return cellWord & 0xFFFF; }
+  float getEdep() const { return edep; }
+  FPCCDPixelHit::HitQuality_t getQuality() const { return quality; }
+  unsigned int getSizeOfOrderID() const { return nOrderIDs; }
+};
+
+
+/** ======= FPCCDPixelStore ========== <br>
+ * Fired pixels of one FPCCD ladder, kept in a contiguous vector sorted by
+ * cell word, with the order IDs of all pixels in one pool. <br>
+ *
+ * New pixels are appended and only sorted and merged with the existing
+ * ones when the pixels are accessed, so filling a ladder costs no lookup
+ * per pixel. Deposits in the same cell are merged in the order they were
+ * added, with the same rules as FPCCDPixelHit::addPixelHit().
+ *
+ * Iterators are invalidated by addPixel() and clear().
+ */
+// =================================================================
+class FPCCDPixelStore {
+ public:
+  typedef std::vector<FPCCDPixel>::const_iterator const_iterator;
+
+  // Add a deposit in the given cell. The quality of a new pixel is set to
+  // quality, the one of an existing pixel is combined with it.
+  void addPixel(unsigned int cellWord, float edep, FPCCDPixelHit::HitQuality_t quality,
+                const int *orderIDs=0, unsigned int nOrderIDs=0);
+
+  // Add all pixels of bgStore in one pass over both sorted stores. As in
+  // FPCCDData::Add(...), a pixel of quality kSingle is added as signal and
+  // any other as background.
+  void overlay(FPCCDPixelStore &bgStore);
+
+  // Same for pixels given as an array sorted by cell word without duplicates,
+  // e.g. from a FPCCDPixelLibrary. The orderBegin of the pixels refers to bgOrderIDs.
+  void overlay(const FPCCDPixel *bgPixels, std::size_t nBgPixels, const int *bgOrderIDs);
+
+  // Reserve memory for pixels and order IDs to be added
+  void reserve(std::size_t nPixels, std::size_t nOrderIDs){
+    _pixels.reserve(_pixels.size()+nPixels);
+    _orderIDs.reserve(_orderIDs.size()+nOrderIDs);
+  }
+
+  // Remove all pixels, keeping the allocated memory for the next event
+  void clear();
+
+  bool empty() const { return _pixels.empty(); }
+
+  // Number of distinct fired pixels
+  unsigned int size(){ sort(); return _pixels.size(); }
+
+  // Number of pixels added, without merging deposits in the same cell
+  std::size_t sizeHint() const { return _pixels.size(); }
+
+  // Pixels in increasing order of the cell word
+  const_iterator begin(){ sort(); return _pixels.begin(); }
+  const_iterator end(){ sort(); return _pixels.end(); }
+
+  // First of the pixel.getSizeOfOrderID() order IDs of a pixel of this store
+  const int *getOrderIDs(const FPCCDPixel &pixel) const { return _orderIDs.data() + pixel.orderBegin; }
+
+  // Sort the pixels and merge deposits in the same cell, done implicitly
+  void sort();
+
+ protected:
+  // Append pixel with its order IDs from pool to the scratch vectors
+  void appendScratch(const FPCCDPixel &pixel, const int *pool);
+
+  std::vector<FPCCDPixel> _pixels{};
+  std::vector<int> _orderIDs{};
+  std::size_t _nSorted=0;          // leading pixels that are sorted and merged
+
+  std::vector<FPCCDPixel> _scratchPixels{};
+  std::vector<int> _scratchOrderIDs{};
+};
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef LCCylinderT_H
+#define LCCylinderT_H 1
+
+#include "Vector3T.h"
+#include "LCLine3DT.h"
+#include "LCPlane3DT.h"
+
+#include <cmath>
+
+/** Header-only version of LCCylinder on Vector3T, templated in the floating
+ *  point type. Same conventions as LCCylinder.
+ */
+
+template<typename FloatT>
+class LCCylinderT {
+public:
+  using float_type = FloatT;
+  using vector_type = Vector3T<FloatT>;
+
+  /**
+   * Constructor from the start and end point of the axis and a radius.
+   * @param endPlane switches if cylinder is open or not
+   */
+  LCCylinderT(const vector_type& point1, const vector_type& point2, FloatT radiusVal, bool endPlane = false)
+    : _radius(std::fabs(radiusVal)), _endPlane(endPlane), _axisStartPoint(point1), _axisEndPoint(point2) {}
+
+  /**
+   * Constructor from the centre of the axis, the half-length axis vector and the radius.
+   */
+  LCCylinderT(FloatT radiusVal, const vector_type& point, const vector_type& axis, bool endPlane)
+    : _radius(std::fabs(radiusVal)), _endPlane(endPlane), _axisStartPoint(point - axis), _axisEndPoint(point + axis) {}
+
+  vector_type startPoint() const { return _axisStartPoint; }
+  vector_type endPoint() const { return _axisEndPoint; }
+  vector_type axisDirection() const { return (_axisEndPoint - _axisStartPoint).unit(); }
+  FloatT length() const { return (_axisEndPoint - _axisStartPoint).mag(); }
+  FloatT radius() const { return _radius; }
+
+  /** Distance of a point to the cylinder. */
+  FloatT distance(const vector_type& point) const {
+    int dummy;
+    return (point - projectPoint(point, dummy)).mag();
+  }
+
+  /**
+   * Projection of a point on to the surface of the cylinder, with the same
+   * region codes as LCCylinder::projectPoint:
+   * 0 : no projection possible, 1 : plane at start point,
+   * 2 : plane at end point, 3 : the tube of the cylinder
+   */
+  vector_type projectPoint(const vector_type& point, int& code) const {
+    const LCLine3DT<FloatT> a(_axisStartPoint, axisDirection());
+    const FloatT s = a.projectPoint(_axisStartPoint);
+    const FloatT e = a.projectPoint(_axisEndPoint);
+    const FloatT p = a.projectPoint(point);
+    const FloatT d = a.distance(point);
+
+    const FloatT drp = std::fabs(d - _radius);
+    const FloatT dsp = std::fabs(s - p);
+    const FloatT dep = std::fabs(e - p);
+
+    if (_endPlane && d <= _radius) {
+      bool inside = (p >= s && p <= e);
+      if (inside && drp <= dsp && drp <= dep) {
+        code = 3;
+        return tubePoint(a, point, p, p);
+      }
+      if ((inside && dsp <= dep) || (!inside && p < s)) {
+        code = 1;
+        return LCPlane3DT<FloatT>(-axisDirection(), _axisStartPoint).projectPoint(point);
+      }
+      code = 2;
+      return LCPlane3DT<FloatT>(axisDirection(), _axisEndPoint).projectPoint(point);
+    }
+
+    if (p >= s && p <= e) {
+      code = 3;
+      return tubePoint(a, point, p, p);
+    }
+    code = 0;
+    return tubePoint(a, point, p, p < s ? s : e);
+  }
+
+  /** Checks if a given point is inside the cylinder. */
+  bool isInside(const vector_type& point) const {
+    const LCLine3DT<FloatT> a(_axisStartPoint, axisDirection());
+    if (_radius < a.distance(point)) return false;
+    const FloatT p = a.projectPoint(point);
+    return !(p < a.projectPoint(_axisStartPoint) || p > a.projectPoint(_axisEndPoint));
+  }
+
+  bool operator==(const LCCylinderT& rhs) const {
+    return _radius == rhs._radius && _axisStartPoint == rhs._axisStartPoint &&
+           _axisEndPoint == rhs._axisEndPoint && _endPlane == rhs._endPlane;
+  }
+  bool operator!=(const LCCylinderT& rhs) const { return !(*this == rhs); }
+
+private:
+  /** Point on the tube at axis path length sAxis, in the radial direction of point
+   *  seen from the axis position at sPoint.
+   */
+  vector_type tubePoint(const LCLine3DT<FloatT>& a, const vector_type& point, FloatT sPoint, FloatT sAxis) const {
+    vector_type radial = (point - a.position(sPoint)).unit();
+    if (radial.mag() < FloatT(0.00001)) radial = axisDirection().orthogonal().unit();
+    return a.position(sAxis) + radial * _radius;
+  }
+
+  FloatT _radius = 0;
+  bool _endPlane = false;
+  vector_type _axisStartPoint{};
+  vector_type _axisEndPoint{};
+};
+
+#endif /* ifndef LCCylinderT_H */
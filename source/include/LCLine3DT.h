@@ -0,0 +1,115 @@
+#ifndef LCLine3DT_H
+#define LCLine3DT_H 1
+
+#include "Vector3T.h"
+#include "LCPlane3DT.h"
+
+#include <limits>
+
+/** Header-only version of LCLine3D on Vector3T, templated in the floating
+ *  point type. Same conventions as LCLine3D: the line is stored as its point
+ *  of closest approach to the reference point (LC-LC-DET-2006-004) and a
+ *  normalised direction, and s is the path length along the line.
+ */
+
+template<typename FloatT>
+class LCLine3DT {
+public:
+  using float_type = FloatT;
+  using vector_type = Vector3T<FloatT>;
+
+  /** Standard constructor: a line along the x-axis. */
+  LCLine3DT() : _direction(1, 0, 0) {}
+
+  /** Constructor from a point and a direction. */
+  LCLine3DT(const vector_type& point, const vector_type& lineDirection) {
+    set(point, lineDirection, vector_type());
+  }
+
+  /** Constructor from a point, a direction and the reference point of the line. */
+  LCLine3DT(const vector_type& point, const vector_type& lineDirection, const vector_type& reference) {
+    set(point, lineDirection, reference);
+  }
+
+  /** Constructor using the canonical parameterization, see LCLine3D. */
+  LCLine3DT(FloatT d0, FloatT phi0, FloatT z0, FloatT tanLambda,
+            const vector_type& reference = vector_type()) {
+    set(d0, phi0, z0, tanLambda, reference);
+  }
+
+  /** Set the line from a point, a direction and a reference point. */
+  bool set(const vector_type& point, const vector_type& lineDirection, const vector_type& reference) {
+    _reference = reference;
+    _direction = lineDirection.unit();
+    if (_direction.mag2() == 0) {
+      return false;
+    }
+
+    vector_type p = point, d = _direction;
+    p.setZ(0);
+    d.setZ(0);
+
+    FloatT dMag = d.mag();
+    if (dMag != 0) {
+      d = d.unit();
+      FloatT s = -p.dot(d) / d.mag2();
+      _point = point + _direction * (s / dMag);
+    } else {
+      _point = point;
+      _point.setZ(0);
+    }
+    return true;
+  }
+
+  /** Set the line using the canonical parameterization. */
+  bool set(FloatT d0, FloatT phi0, FloatT z0, FloatT tanLambda, const vector_type& reference) {
+    _reference = reference;
+    _direction = vector_type(std::cos(phi0), std::sin(phi0), tanLambda).unit();
+    if (d0 == 0) {
+      _point.set(0, 0, z0);
+    } else {
+      _point.set(d0*std::sin(phi0), d0*std::cos(phi0), z0);
+    }
+    return true;
+  }
+
+  /** Position after a path length s along the line. */
+  vector_type position(FloatT s = 0) const { return _reference + _point + _direction * s; }
+
+  /** Direction of the line. */
+  vector_type direction() const { return _direction; }
+
+  /** Distance of a point to the line. */
+  FloatT distance(const vector_type& point) const { return (point - position(projectPoint(point))).mag(); }
+
+  /** Path length of the projection of a point on to the line. */
+  FloatT projectPoint(const vector_type& point) const {
+    return (point.dot(_direction) - (_reference + _point).dot(_direction)) / _direction.mag2();
+  }
+
+  /** Path length at the intersection point with a plane - undefined
+   *  if pointExists==false.
+   */
+  FloatT intersectionWithPlane(const LCPlane3DT<FloatT>& plane, bool& pointExists) const {
+    vector_type n = plane.normal();
+    FloatT c = _direction.dot(n);
+    if (c == 0) {
+      pointExists = false;
+      return std::numeric_limits<FloatT>::max();
+    }
+    pointExists = true;
+    return -(position().dot(n) + plane.d()) / c;
+  }
+
+  bool operator==(const LCLine3DT& rhs) const {
+    return _point == rhs._point && _direction == rhs._direction && _reference == rhs._reference;
+  }
+  bool operator!=(const LCLine3DT& rhs) const { return !(*this == rhs); }
+
+private:
+  vector_type _point{};
+  vector_type _direction{};
+  vector_type _reference{};
+};
+
+#endif /* ifndef LCLine3DT_H */
@@ -0,0 +1,100 @@
+#ifndef LCPlane3DT_H
+#define LCPlane3DT_H 1
+
+#include "Vector3T.h"
+
+/** Header-only version of LCPlane3D on Vector3T, templated in the floating
+ *  point type. Same conventions as LCPlane3D: the plane is a*x+b*y+c*z+d=0 with
+ *  a normalised normal vector (a,b,c).
+ */
+
+template<typename FloatT>
+class LCPlane3DT {
+public:
+  using float_type = FloatT;
+  using vector_type = Vector3T<FloatT>;
+
+  /**
+   * Constructor from four numbers - creates plane a*x+b*y+c*z+d=0.
+   * The sign is chosen such that d <= 0, as for LCPlane3D.
+   */
+  LCPlane3DT(FloatT aVal = 0, FloatT bVal = 0, FloatT cVal = 1, FloatT dVal = 0)
+    : _a(aVal), _b(bVal), _c(cVal), _d(dVal) {
+    normalize();
+    if (_d > 0) {
+      _a = -_a; _b = -_b; _c = -_c; _d = -_d;
+    }
+  }
+
+  /**
+   * Constructor from normal and point.
+   * @param normal vector pointing in the direction of the normal, does not have to be normalised.
+   * @param point Point on the plane.
+   */
+  LCPlane3DT(const vector_type& normalVector, const vector_type& point) {
+    setNormal(normalVector.unit());
+    _d = -normal().dot(point);
+  }
+
+  /**
+   * Constructor from three different points on the plane.
+   */
+  LCPlane3DT(const vector_type& point1, const vector_type& point2, const vector_type& point3) {
+    vector_type n = (point2 - point1).cross(point3 - point1).unit();
+    setNormal(n);
+    _d = -n.dot(point1);
+  }
+
+  /** Constructor from a normal and the distance between origin and plane. */
+  LCPlane3DT(const vector_type& normalVector, FloatT dist) {
+    setNormal(normalVector.unit());
+    _d = -dist;
+  }
+
+  FloatT a() const { return _a; }
+  FloatT b() const { return _b; }
+  FloatT c() const { return _c; }
+  FloatT d() const { return _d; }
+
+  /** Returns normal. */
+  vector_type normal() const { return vector_type(_a, _b, _c).unit(); }
+
+  /** Normalization. */
+  LCPlane3DT& normalize() {
+    FloatT norm = std::sqrt(_a*_a + _b*_b + _c*_c);
+    if (norm > 0) {
+      _a /= norm; _b /= norm; _c /= norm; _d /= norm;
+    }
+    return *this;
+  }
+
+  /**
+   * Signed distance of a point to the plane, negative if the point and the
+   * origin are on the same side of the plane.
+   */
+  FloatT distance(const vector_type& point) const {
+    return _a*point.x() + _b*point.y() + _c*point.z() + _d;
+  }
+
+  /** Projection of a point on to the plane. */
+  vector_type projectPoint(const vector_type& point) const {
+    FloatT k = distance(point) / (_a*_a + _b*_b + _c*_c);
+    return vector_type(point.x() - _a*k, point.y() - _b*k, point.z() - _c*k);
+  }
+
+  /** Projection of the origin onto the plane. */
+  vector_type projectPoint() const {
+    FloatT k = -_d / (_a*_a + _b*_b + _c*_c);
+    return vector_type(_a*k, _b*k, _c*k);
+  }
+
+  bool operator==(const LCPlane3DT& rhs) const { return _a == rhs._a && _b == rhs._b && _c == rhs._c && _d == rhs._d; }
+  bool operator!=(const LCPlane3DT& rhs) const { return !(*this == rhs); }
+
+private:
+  void setNormal(const vector_type& n) { _a = n.x(); _b = n.y(); _c = n.z(); }
+
+  FloatT _a = 0, _b = 0, _c = 0, _d = 0;
+};
+
+#endif /* ifndef LCPlane3DT_H */
@@ -0,0 +1,51 @@
+#ifndef LINECLASST_H
+#define LINECLASST_H 1
+
+#include "Vector3T.h"
+
+#include <algorithm>
+#include <cmath>
+
+/** Header-only, templated version of LineClass: a line given by a reference
+ *  point and a (not necessarily normalised) directional vector.
+ */
+
+template<typename FloatT>
+class LineClassT {
+public:
+  using float_type = FloatT;
+  using vector_type = Vector3T<FloatT>;
+
+  LineClassT(FloatT x0, FloatT y0, FloatT z0, FloatT ax, FloatT ay, FloatT az)
+    : _x0(x0, y0, z0), _ax(ax, ay, az) {}
+
+  LineClassT(const FloatT* x0, const FloatT* ax) : _x0(x0), _ax(ax) {}
+
+  LineClassT(const vector_type& x0, const vector_type& ax) : _x0(x0), _ax(ax) {}
+
+  const vector_type& getReferencePoint() const { return _x0; }
+  void setReferencePoint(const vector_type& x0) { _x0 = x0; }
+  const vector_type& getDirectionalVector() const { return _ax; }
+  void setDirectionalVector(const vector_type& ax) { _ax = ax; }
+
+  /** Distance of xpoint to the line, pos is the point of closest approach. */
+  FloatT getDistanceToPoint(const vector_type& xpoint, vector_type& pos) const {
+    const FloatT time = _ax.dot(xpoint - _x0) / std::max(FloatT(1e-10), _ax.mag2());
+    pos = _x0 + _ax * time;
+    return (xpoint - pos).mag();
+  }
+
+  /** Same as above with arrays of three numbers, as for LineClass. */
+  FloatT getDistanceToPoint(const FloatT* xpoint, FloatT* pos) const {
+    vector_type p;
+    FloatT dist = getDistanceToPoint(vector_type(xpoint), p);
+    p.copyTo(pos);
+    return dist;
+  }
+
+private:
+  vector_type _x0{};
+  vector_type _ax{};
+};
+
+#endif /* ifndef LINECLASST_H */
@@ -0,0 +1,143 @@
+#ifndef MCBalance_h
+#define MCBalance_h 1
+
+#include <lcio.h>
+#include <EVENT/LCCollection.h>
+#include <EVENT/LCEvent.h>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace MarlinUtil {
+
+  /** Energy and momentum balance of the stable (generator status 1) MC
+   *  particles of an event, split into categories that are given as a table
+   *  of simple predicates on the PDG code, the charge and the angle to the
+   *  beam axis.
+   *
+   *  Every particle is assigned to the first category in the table that it
+   *  matches, particles matching none are summed as unclassified. The
+   *  particles are first copied into a structure of arrays, then classified
+   *  and summed in separate loops without a per category chain of branches.
+   *  The scratch arrays are kept between events, so one MCBalance should be
+   *  reused for all events of a job.
+   */
+  class MCBalance {
+
+  public:
+
+    enum class Charge { any, neutral, charged } ;
+
+    /** Predicates of one category, all of them have to be fulfilled. */
+    struct Category {
+      std::string name{} ;
+      std::vector<int> pdgCodes{} ;     ///< absolute values of the PDG codes, empty for any code
+      std::vector<int> excludedPdgCodes{} ;  ///< absolute values of PDG codes that never match
+      Charge charge = Charge::any ;
+      double minBeamAngle = 0. ;        ///< lower limit of min( theta, pi - theta ) in rad
+      double maxBeamAngle = std::numeric_limits<double>::max() ;  ///< upper limit (exclusive)
+    } ;
+
+    /** Summed energy, momentum and number of the particles of one category. */
+    struct Sum {
+      double energy = 0. ;
+      double px = 0. ;
+      double py = 0. ;
+      double pz = 0. ;
+      int n = 0 ;
+    } ;
+
+    struct Result {
+      std::vector<Sum> categories{} ;            ///< in the order of the category table
+      Sum unclassified{} ;
+      std::vector<int> unclassifiedPDGCodes{} ;
+    } ;
+
+    /** Indices of the categories in defaultCategories() */
+    enum DefaultCategory { beamTube, neutrinos, muons, electrons, pi0s, photons,
+                           longLivedNeutralHadrons, shortLivedNeutralHadrons, chargedHadrons, nDefaultCategories } ;
+
+    /** The categories used by getMCEnergyBalance(): particles within 0.1 rad
+     *  of the beam axis, neutrinos, muons, electrons, pi0s, photons, long lived
+     *  neutral hadrons (n, K0L), short lived neutral hadrons (K0S, Lambda0,
+     *  Sigma0, Xi0) and any other charged particle.
+     */
+    static std::vector<Category> defaultCategories() ;
+
+    /** The categories of getMC_Balance(): the same as defaultCategories(), but
+     *  the charged hadrons are any other particle except K0 (311), whatever its
+     *  charge, e.g. also a neutralino (1000022).
+     */
+    static std::vector<Category> legacyCategories() ;
+
+    MCBalance( std::vector<Category> categories = defaultCategories() ) ;
+
+    const std::vector<Category>& getCategories() const { return _categories ; }
+
+    /** Balance of the stable particles in the given MCParticle collection. */
+    Result compute( const lcio::LCCollection* mcParticles ) ;
+
+  private:
+
+    std::vector<Category> _categories ;
+
+    // snapshot of the stable particles of the current event
+    std::vector<int> _pdg{} ;
+    std::vector<float> _charge{} ;
+    std::vector<double> _energy{}, _px{}, _py{}, _pz{}, _beamAngle{} ;
+    std::vector<int> _category{} ;
+  };
+
+
+  /** The quantities returned by getMC_Balance(), see there. */
+  struct MCEnergyBalance {
+    double measurableEnergy = 0. ;     ///< [0] measurable in the calorimeter, muons counted with 1.6 GeV
+    double beamTubeEnergy = 0. ;       ///< [1]
+    double neutrinoEnergy = 0. ;       ///< [2]
+    double electronEnergy = 0. ;       ///< [3]
+    double muonEnergy = 0. ;           ///< [4]
+    double photonEnergy = 0. ;         ///< [5]
+    double pi0Energy = 0. ;            ///< [6]
+    double longLivedNeutralHadronEnergy = 0. ;   ///< [7]
+    double shortLivedNeutralHadronEnergy = 0. ;  ///< [8]
+    double chargedHadronEnergy = 0. ;  ///< [9]
+    int nMeasurable = 0 ;              ///< [10]
+    int nBeamTube = 0 ;                ///< [11]
+    int nNeutrinos = 0 ;               ///< [12]
+    int nElectrons = 0 ;               ///< [13]
+    int nMuons = 0 ;                   ///< [14]
+    int nPhotons = 0 ;                 ///< [15]
+    int nPi0s = 0 ;                    ///< [16]
+    int nLongLivedNeutralHadrons = 0 ; ///< [17]
+    int nShortLivedNeutralHadrons = 0 ;///< [18]
+    int nChargedHadrons = 0 ;          ///< [19]
+    double visibleEnergy = 0. ;        ///< [20] totalEnergy - neutrinoEnergy - beamTubeEnergy
+    double totalEnergy = 0. ;          ///< sum of all categories but the beam tube
+    double muonEnergyLost = 0. ;       ///< muon energy not deposited in the calorimeter
+    double lostEnergy = 0. ;           ///< neutrinos, beam tube and muonEnergyLost
+    std::vector<int> unclassifiedPDGCodes{} ;  ///< absolute PDG codes of particles in no category
+  };
+
+  /** Energy balance of the stable MC particles of the given collection, computed
+   *  with the default categories of MCBalance. Throws lcio::DataNotAvailableException
+   *  if the collection is not in the event.
+   *
+   *  NOTE: this is not the classification of MarlinUtil::getMC_Balance(). Here only
+   *  charged particles fall into the charged hadron catch-all. A neutral particle in
+   *  none of the other categories, e.g. a neutralino or a K0 (311), is returned in
+   *  unclassifiedPDGCodes and is missing from totalEnergy and measurableEnergy.
+   *  getMC_Balance() counts such particles, except K0, as charged hadrons. Pass an
+   *  MCBalance( MCBalance::legacyCategories() ) to get its numbers.
+   */
+  MCEnergyBalance getMCEnergyBalance( const lcio::LCEvent* evt, const std::string& colNameMC = "MCParticle" ) ;
+
+  /** Same, reusing the scratch space of balance. The first nDefaultCategories categories of
+   *  balance are taken as the ones of defaultCategories(), std::runtime_error is thrown if it
+   *  has fewer categories.
+   */
+  MCEnergyBalance getMCEnergyBalance( const lcio::LCEvent* evt, MCBalance& balance, const std::string& colNameMC = "MCParticle" ) ;
+
+}
+
+#endif
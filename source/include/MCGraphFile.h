@@ -0,0 +1,131 @@
+#ifndef MCGraphFile_h
+#define MCGraphFile_h 1
+
+#include "MappedRecordFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MarlinUtil {
+
+  /** Binary file format for the MC particle graph of events, written by
+   *  MCGraphWriter and read by MCGraphReader.
+   *
+   *  The file starts with a FileHeader, followed by one record per event that
+   *  is only ever appended. A record is an EventHeader followed by columns,
+   *  one entry per MC particle in the order of the MCParticle collection, i.e.
+   *  the row number is the collection index:
+   *
+   *    double   px, py, pz, energy, mass, vx, vy, vz   [nParticles] each
+   *    int32    pdg, generatorStatus, simulatorStatus  [nParticles] each
+   *    int32    trueJet                                [nParticles] only with hasTrueJet, -1 if none
+   *    uint32   parentOffsets                          [nParticles+1]
+   *    int32    parents                                [nParentLinks]
+   *    uint32   daughterOffsets                        [nParticles+1]
+   *    int32    daughters                              [nDaughterLinks]
+   *
+   *  The parents of particle i are parents[ parentOffsets[i] ... parentOffsets[i+1] ),
+   *  the same for the daughters (compressed sparse rows). Every column starts at
+   *  a multiple of 8 bytes from the start of the file, so that a memory mapped
+   *  file can be accessed in place. All numbers are in native byte order.
+   */
+  namespace MCGraph {
+
+    constexpr char fileMagic[8] = { 'M', 'U', 'M', 'C', 'G', 'R', 'P', 'H' } ;
+    constexpr uint32_t eventMagic = 0x5645434d ;  // "MCEV"
+    constexpr uint32_t formatVersion = 1 ;
+
+    enum Flags : uint32_t {
+      hasTrueJet = 1    ///< the record contains the trueJet column
+    } ;
+
+    struct FileHeader {
+      char magic[8] ;
+      uint32_t version ;
+      uint32_t headerSize ;
+    } ;
+
+    struct EventHeader {
+      uint32_t magic ;
+      uint32_t headerSize ;
+      uint64_t recordSize ;      ///< in bytes, including this header
+      int32_t runNumber ;
+      int32_t eventNumber ;
+      uint32_t nParticles ;
+      uint32_t nParentLinks ;
+      uint32_t nDaughterLinks ;
+      uint32_t flags ;
+    } ;
+
+    static_assert( sizeof( FileHeader ) % 8 == 0 && sizeof( EventHeader ) % 8 == 0, "headers have to keep the columns aligned" ) ;
+    static_assert( offsetof( FileHeader, headerSize ) == offsetof( RecordFileHeader, headerSize )
+                   && offsetof( EventHeader, recordSize ) == offsetof( RecordHeader, recordSize ), "headers have to start as in MappedRecordFile" ) ;
+
+    /** Byte offsets of the columns from the start of a record. */
+    struct RecordLayout {
+      uint64_t px, py, pz, energy, mass, vx, vy, vz ;
+      uint64_t pdg, generatorStatus, simulatorStatus, trueJet ;
+      uint64_t parentOffsets, parents, daughterOffsets, daughters ;
+      uint64_t size ;            ///< total size of the record
+    } ;
+
+    /** Layout of the record described by the given header. */
+    RecordLayout recordLayout( const EventHeader& header ) ;
+
+  }
+
+
+  /** Memory mapped, read only access to a file written by MCGraphWriter.
+   *  Events are returned as views into the mapped file, no data is copied.
+   *  An incomplete record at the end of the file, e.g. from a job that did
+   *  not finish, is ignored. The records are checked when the file is
+   *  opened, see MappedRecordFile.
+   */
+  class MCGraphReader {
+
+  public:
+
+    /** Columns of one event, see MCGraph for their meaning. trueJet is NULL
+     *  if the event was written without TrueJet assignment.
+     */
+    struct Event {
+      const MCGraph::EventHeader* header = nullptr ;
+      const double *px = nullptr, *py = nullptr, *pz = nullptr, *energy = nullptr, *mass = nullptr ;
+      const double *vx = nullptr, *vy = nullptr, *vz = nullptr ;
+      const int32_t *pdg = nullptr, *generatorStatus = nullptr, *simulatorStatus = nullptr, *trueJet = nullptr ;
+      const uint32_t* parentOffsets = nullptr ;
+      const int32_t* parents = nullptr ;
+      const uint32_t* daughterOffsets = nullptr ;
+      const int32_t* daughters = nullptr ;
+
+      unsigned size() const { return header->nParticles ; }
+      unsigned numberOfParents( unsigned i ) const { return parentOffsets[i+1] - parentOffsets[i] ; }
+      unsigned numberOfDaughters( unsigned i ) const { return daughterOffsets[i+1] - daughterOffsets[i] ; }
+    } ;
+
+    /** Maps the file, throws std::runtime_error if it cannot be opened, is not
+     *  an MC graph file or contains a record that is not consistent.
+     */
+    MCGraphReader( const std::string& fileName ) ;
+
+    MCGraphReader( const MCGraphReader& ) = delete ;
+    MCGraphReader& operator=( const MCGraphReader& ) = delete ;
+
+    size_t getNumberOfEvents() const { return _records.size() ; }
+
+    Event getEvent( size_t i ) const ;
+
+    /** File size up to the end of the last complete record. */
+    size_t getEndOfRecords() const { return _file.getEndOfRecords() ; }
+
+  private:
+
+    MappedRecordFile _file ;
+    std::vector<size_t> _records{} ;  ///< file offsets of the complete records
+  };
+
+}
+
+#endif
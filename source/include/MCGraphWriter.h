@@ -0,0 +1,57 @@
+#ifndef MCGraphWriter_h
+#define MCGraphWriter_h 1
+
+#include "MCGraphFile.h"
+
+#include <lcio.h>
+#include <EVENT/LCCollection.h>
+#include <EVENT/LCEvent.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+class TrueJet_Parser ;
+
+namespace MarlinUtil {
+
+  /** Appends the MC particle graph of events to a binary file in the columnar
+   *  format described in MCGraphFile.h, to be read back with MCGraphReader
+   *  without LCIO.
+   *
+   *  The file is opened for appending, so several jobs can write to the same
+   *  file one after the other, and every event is written with a single call
+   *  to keep the records complete. An incomplete last record, left by a job
+   *  that did not finish, is cut off when the file is opened again.
+   */
+  class MCGraphWriter {
+
+  public:
+
+    /** Opens the file for appending, throws std::runtime_error if that fails
+     *  or if an existing file is not an MC graph file.
+     */
+    MCGraphWriter( const std::string& fileName ) ;
+
+    MCGraphWriter( const MCGraphWriter& ) = delete ;
+    MCGraphWriter& operator=( const MCGraphWriter& ) = delete ;
+
+    /** Appends the particles of the MCParticle collection of the event. Links
+     *  to particles that are not in the collection are dropped. If trueJets is
+     *  given, getall() has to have been called for the event and the TrueJet
+     *  index of every particle is written as well.
+     */
+    void write( const lcio::LCEvent* evt, const lcio::LCCollection* mcParticles, TrueJet_Parser* trueJets = nullptr ) ;
+
+    /** Flushes the written events to the file. */
+    void flush() ;
+
+  private:
+
+    std::ofstream _file{} ;
+    std::vector<uint64_t> _buffer{} ;   ///< record under construction, 8 byte aligned
+  };
+
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef MCParticleIndex_h
+#define MCParticleIndex_h 1
+
+#include <lcio.h>
+#include <EVENT/LCCollection.h>
+#include <EVENT/MCParticle.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace MarlinUtil {
+
+  /** Ancestry index of the MC particle graph of one event, to be built once per
+   *  event and then used for any number of isDaughterOf(), getAllMCDaughters()
+   *  and getAllMCParents() queries.
+   *
+   *  The graph is traversed once depth first, starting from the particles
+   *  without parents, and every particle is labelled with its preorder number.
+   *  The descendants of a particle are stored as a list of disjoint preorder
+   *  intervals in one flat array. As long as the graph is a tree below a
+   *  particle this is a single interval, i.e. an ancestor test is a range
+   *  check; particles with several parents only add further intervals, which
+   *  are binary searched.
+   *
+   *  Daughter links that close a loop in the graph are detected during the
+   *  traversal and ignored for all queries, see hasCycles().
+   *
+   *  The particles of the collection (and any particle reachable from them
+   *  via parent or daughter links) must not be modified while the index is
+   *  in use.
+   */
+  class MCParticleIndex {
+
+  public:
+
+    /** Index of all particles in the given MCParticle collection. */
+    MCParticleIndex( const lcio::LCCollection* col ) ;
+
+    /** Index of the given particles and all particles connected to them. */
+    MCParticleIndex( const lcio::MCParticleVec& particles ) ;
+
+    /** Number of particles in the index. */
+    unsigned size() const { return _particles.size() ; }
+
+    /** True if the particle is part of the index. */
+    bool contains( const lcio::MCParticle* mcPart ) const { return _idOf.count( mcPart ) != 0 ; }
+
+    /** True if daughter is a (direct or indirect) daughter of parent. */
+    bool isDaughterOf( const lcio::MCParticle* daughter, const lcio::MCParticle* parent ) const ;
+
+    /** The particle and all its (direct or indirect) daughters, each only once.
+     *  The particle itself is the first element, followed by the daughters in
+     *  depth first order.
+     */
+    lcio::MCParticleVec getAllDaughters( const lcio::MCParticle* mcPart ) const ;
+
+    /** The first ancestors of the particle that are either stable on generator
+     *  level (generator status 1) or have no parents, each only once - same
+     *  definition as MarlinUtil::getAllMCParents(). Returns the particle itself
+     *  if it fulfills the condition.
+     */
+    lcio::MCParticleVec getAllParents( const lcio::MCParticle* mcPart ) const ;
+
+    /** True if the daughter links of the particles form at least one loop. */
+    bool hasCycles() const { return _nCycleLinks != 0 ; }
+
+    /** Number of daughter links that have been ignored to break loops. */
+    unsigned getNumberOfCycleLinks() const { return _nCycleLinks ; }
+
+  private:
+
+    typedef std::pair<int,int> Interval ;
+
+    void build( const lcio::MCParticleVec& particles ) ;
+
+    int id( const lcio::MCParticle* mcPart ) const ;
+
+    lcio::MCParticleVec _particles{} ;                      ///< particles by id
+    std::unordered_map<const lcio::MCParticle*,int> _idOf{} ;
+
+    std::vector<int> _preorder{} ;                          ///< preorder number by id
+    std::vector<int> _byPreorder{} ;                        ///< id by preorder number
+
+    std::vector<Interval> _intervals{} ;                    ///< descendant intervals of all particles
+    std::vector<int> _intervalBegin{} ;                     ///< first interval of each id
+    std::vector<int> _intervalEnd{} ;                       ///< end of the intervals of each id
+
+    std::vector<int> _parentIds{} ;                         ///< getAllParents() of all particles
+    std::vector<int> _parentBegin{} ;
+    std::vector<int> _parentEnd{} ;
+
+    unsigned _nCycleLinks = 0 ;
+  };
+
+}
+
+#endif
@@ -49,6 +49,26 @@ class MCTree {
    */
    void print(int opt);
 
+
+  /**
+   * Options for printTree()
+   */
+  struct PrintOptions {
+    int opt = -1 ;            ///< same as for print(): -1 tree only, 0 status bits, 1 four vector and mass, 2 energy and mass
+    int maxDepth = -1 ;       ///< generations below the first particles that are printed, -1 for all
+    double minEnergy = 0. ;   ///< particles with less energy are skipped together with their daughters
+  };
+
+  /**
+   * Streams the MC Tree into out, e.g. a std::ofstream or std::ostringstream. Other than print() the
+   * tree is walked iteratively and written in chunks of bounded size, so that it can be used for
+   * events with very large generator records. Subtrees failing the depth or energy cut are not
+   * visited at all. Every line starts with the collection index and the information selected by
+   * options.opt, followed by the indented PDG code. A particle with several parents is printed once
+   * with its daughters, further occurrences refer to it by its index.
+   */
+  void printTree(std::ostream& out, const PrintOptions& options) const;
+
  private:
   
   LCCollection* _col;
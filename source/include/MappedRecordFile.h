@@ -0,0 +1,109 @@
+#ifndef MappedRecordFile_h
+#define MappedRecordFile_h 1
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MarlinUtil {
+
+  /** Fields every file header of a MappedRecordFile starts with. */
+  struct RecordFileHeader {
+    char magic[8] ;
+    uint32_t version ;
+    uint32_t headerSize ;
+  } ;
+
+  /** Fields every record header of a MappedRecordFile starts with. */
+  struct RecordHeader {
+    uint32_t magic ;
+    uint32_t headerSize ;
+    uint64_t recordSize ;      ///< in bytes, including the header
+  } ;
+
+
+  /** Read only memory map of a binary file that consists of a file header and
+   *  records that are only ever appended, shared by MCGraphReader and
+   *  FPCCDPixelLibrary. File header and record headers start with the fields
+   *  of RecordFileHeader and RecordHeader, and keep the data following them
+   *  aligned to 8 bytes.
+   *
+   *  The file header and the records are checked once when the file is
+   *  opened, so that the records can be accessed without checks afterwards.
+   */
+  class MappedRecordFile {
+
+  public:
+
+    /** Maps the file and checks its header. Throws std::runtime_error, with a
+     *  message starting with owner, if the file cannot be opened or mapped,
+     *  or if it is not a file of the given magic and version, which is
+     *  described as kind in the message, e.g. "an MC graph file". The file
+     *  header has to be at least minHeaderSize bytes.
+     */
+    MappedRecordFile( const std::string& fileName, const char (&magic)[8], uint32_t version, uint32_t minHeaderSize,
+                      const std::string& owner, const std::string& kind ) ;
+    ~MappedRecordFile() ;
+
+    MappedRecordFile( const MappedRecordFile& ) = delete ;
+    MappedRecordFile& operator=( const MappedRecordFile& ) = delete ;
+
+    const char* data() const { return _data ; }
+    size_t size() const { return _size ; }
+
+    /** Indexes the records after the file header and returns their file
+     *  offsets. The index ends before the first record that does not fit
+     *  into the file or has a different magic, e.g. a record torn by a job
+     *  that did not finish. getEndOfRecords() is the offset of that record.
+     *
+     *  std::runtime_error is thrown for a complete record with headerSize <
+     *  minHeaderSize, recordSize < headerSize, sizes that are not multiples
+     *  of 8, or if checkRecord( record ) returns false. checkRecord has to
+     *  check at least that the data described by the header fit into
+     *  recordSize.
+     */
+    template<class CheckRecord>
+    std::vector<size_t> indexRecords( uint32_t magic, uint32_t minHeaderSize, CheckRecord checkRecord ) ;
+
+    /** File size up to the end of the last complete record, set by indexRecords(). */
+    size_t getEndOfRecords() const { return _endOfRecords ; }
+
+  private:
+
+    [[noreturn]] void corrupt( size_t pos ) const ;
+
+    std::string _fileName ;
+    std::string _owner ;
+    const char* _data = nullptr ;
+    size_t _size = 0 ;
+    size_t _endOfRecords = 0 ;
+  };
+
+
+  template<class CheckRecord>
+  std::vector<size_t> MappedRecordFile::indexRecords( uint32_t magic, uint32_t minHeaderSize, CheckRecord checkRecord ) {
+
+    std::vector<size_t> records ;
+    size_t pos = reinterpret_cast<const RecordFileHeader*>( _data )->headerSize ;
+
+    while( pos + sizeof( RecordHeader ) <= _size ) {
+      const auto* header = reinterpret_cast<const RecordHeader*>( _data + pos ) ;
+      if( header->magic != magic || header->recordSize > _size - pos ) break ;
+
+      if( header->headerSize < minHeaderSize || header->recordSize < header->headerSize
+          || header->headerSize % 8 != 0 || header->recordSize % 8 != 0 || !checkRecord( _data + pos ) ) {
+        corrupt( pos ) ;
+      }
+
+      records.push_back( pos ) ;
+      pos += header->recordSize ;
+    }
+
+    _endOfRecords = pos ;
+    return records ;
+  }
+
+}
+
+#endif
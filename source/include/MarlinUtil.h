@@ -9,6 +9,11 @@
 #include <EVENT/SimCalorimeterHit.h>
 #include <EVENT/ReconstructedParticle.h>
 
+#include "MCBalance.h"
+#include "MCParticleIndex.h"
+#include "ParticleDataTable.h"
+#include "SimHitIndex.h"
+
 #include <string>
 #include <vector>
 #include <fstream>
@@ -23,6 +28,16 @@ namespace MarlinUtil {
   lcio::MCParticleVec getAllMCParents(lcio::MCParticle* mcPart );
   lcio::MCParticleVec getAllMCDaughters(lcio::MCParticle* mcPart);
   bool isDaughterOf( lcio::MCParticle* daughter, lcio::MCParticle* parent );
+
+  /** Same as the functions above, but answered from the ancestry index of the
+   *  event instead of walking the MC graph for every call. Particles are
+   *  returned only once and daughter links forming a loop are ignored. For
+   *  particles that are not part of the index the functions above are used.
+   */
+  lcio::MCParticleVec getAllMCParents( lcio::MCParticle* mcPart, const MCParticleIndex& index );
+  lcio::MCParticleVec getAllMCDaughters( lcio::MCParticle* mcPart, const MCParticleIndex& index );
+  bool isDaughterOf( lcio::MCParticle* daughter, lcio::MCParticle* parent, const MCParticleIndex& index );
+
   bool DecayChainInTree(std::vector<int> DecayChannel, lcio::LCEvent* evt);
 
   /** Function to get the accumulated sum of the energy per event and the number of particles within different categories at IP. The return values are given in the array accumulatedEnergies of size 21 with the following content. Only MC particles with generator status 1 are considered:
@@ -48,6 +63,11 @@ namespace MarlinUtil {
    *  accumulatedEnergies[18] : number of short lived hadrons
    *  accumulatedEnergies[19] : number of charged hadrons
    *  accumulatedEnergies[20] : energy of MC particles which is possible to measure (real sum [see 0])
+   *
+   *  The collection "MCParticle" is used. As always, every stable particle that is in none of the
+   *  other categories, except K0 (311), is counted as charged hadron, whatever its charge. See
+   *  getMCEnergyBalance() in MCBalance.h for the same numbers as a struct with only charged particles
+   *  as charged hadrons, for other collection names and for user defined categories.
    */   
   void getMC_Balance(lcio::LCEvent* evt, double* accumulatedEnergies);
 
@@ -56,10 +76,25 @@ namespace MarlinUtil {
   double getAbsMomentum(lcio::Track* track, double bField=4.0);
   void printCluster(lcio::Cluster* cluster);
   void printRecoParticle(lcio::ReconstructedParticle* recoParticle, double bField=4.0);
+
+  /** Number of SimTrackerHits created by the MC particle in all SimTrackerHit collections of the event. */
   int countAllSimTrackerHits(lcio::LCEvent* evt,lcio::MCParticle* MCP);
+
+  /** Number of contributions of the MC particle to the hits of all SimCalorimeterHit collections of the
+   *  event, their summed energy is returned in accumulatedSimCaloEnergy.
+   */
   int countAllSimCalorimeterHits(lcio::LCEvent* evt,lcio::MCParticle* MCP,double& accumulatedSimCaloEnergy);
+
+  /** Summed energy of the hits in all CalorimeterHit collections of the event. */
   double getEnergyDepositedInFullCalorimeter(lcio::LCEvent* evt);
 
+  /** Same as above, answered from the SimHitIndex of the event. The versions taking the event scan
+   *  all collections for every call, use these when asking for more than one MC particle.
+   */
+  int countAllSimTrackerHits(const SimHitIndex& index,lcio::MCParticle* MCP);
+  int countAllSimCalorimeterHits(const SimHitIndex& index,lcio::MCParticle* MCP,double& accumulatedSimCaloEnergy);
+  double getEnergyDepositedInFullCalorimeter(const SimHitIndex& index);
+
 
 }
 
@@ -73,16 +108,19 @@ class MCParticleHelper {
 
  public: 
 
+  /** All queries are lookups in the MarlinUtil::ParticleDataTable that is
+   *  compiled into the library, i.e. no file is read.
+   */
   MCParticleHelper();
   std::string getMCCharge(int PDGCode);
 
+  /** Mass in MeV as listed in the PDG table, 0 if unknown. */
+  double getMCMass(int PDGCode);
 
- private: 
-
-  std::vector<int> _pdgCodesMCParticles{};
-  std::vector<double> _massMCParticles{};
-  std::vector<std::string> _nameMCParticles{};
-  std::vector<std::string> _chargeMCParticles{};
+  /** Name without charge, "unknown" if not in the table - same as MarlinUtil::getMCName
+   *  but without printing a message for unknown codes.
+   */
+  std::string getMCName(int PDGCode);
 
 
 };
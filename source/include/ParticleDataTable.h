@@ -0,0 +1,72 @@
+#ifndef ParticleDataTable_h
+#define ParticleDataTable_h 1
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace MarlinUtil {
+
+  /** Properties of one particle state as listed in the PDG table mass_width_2006.csv.
+   *  Only particle states are listed, antiparticles have the opposite charge and
+   *  a negative PDG code.
+   */
+  struct ParticleData {
+    int pdgCode = 0 ;          ///< PDG (MC) code of the particle state
+    double mass = 0.0 ;        ///< mass in MeV
+    double width = 0.0 ;       ///< width in MeV
+    std::string_view name{} ;  ///< name without charge, e.g. "pi"
+    std::string_view charge{} ;///< charge as given in the table, e.g. "+", "0", "++", "-1/3"
+    char antiFlag = ' ' ;      ///< rule for the antiparticle name, 'B', 'F' or ' ' (see the table header)
+  };
+
+
+  /** Process wide, immutable table of particle properties, shared by
+   *  getMCName, getPDGCode and MCParticleHelper.
+   *
+   *  The table is generated from mass_width_2006.csv when MarlinUtil is built
+   *  and compiled into the library as a constant array sorted by PDG code, so
+   *  no file is read at run time. Lookups by PDG code are binary searches in
+   *  that array, lookups by name use a hash map that is built on first use.
+   */
+  class ParticleDataTable {
+
+  public:
+
+    /** The table, the name index is built on first call. */
+    static const ParticleDataTable& instance() ;
+
+    /** Entry for the given PDG code - antiparticles are mapped to the particle
+     *  entry, i.e. the code is looked up as |pdgCode|. Returns NULL if the
+     *  particle is not in the table.
+     */
+    static const ParticleData* find( int pdgCode ) ;
+
+    /** PDG code for the given name, 0 if unknown. The name can either be the
+     *  name as returned by getMCName(), e.g. "pi" or "p(P11)", or include the
+     *  charge, e.g. "pi+", "pi-", "pi0", "e+", which also gives the negative
+     *  codes of antiparticles. Antibaryons have "bar" appended to the name,
+     *  e.g. "p(P11)bar-" for the antiproton.
+     */
+    int pdgCode( const std::string& name ) const ;
+
+    /** Iteration over all entries, sorted by PDG code. */
+    static const ParticleData* begin() ;
+    static const ParticleData* end() ;
+    static unsigned size() ;
+
+    /** Charge string of the antiparticle, e.g. "+" -> "-", "++" -> "--", "0" -> "0". */
+    static std::string antiCharge( std::string_view charge ) ;
+
+  private:
+
+    ParticleDataTable() ;
+
+    void addNames( const ParticleData& particle ) ;
+
+    std::unordered_map<std::string,int> _codeByName{} ;
+  };
+
+}
+
+#endif
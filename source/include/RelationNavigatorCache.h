@@ -0,0 +1,70 @@
+#ifndef RelationNavigatorCache_h
+#define RelationNavigatorCache_h 1
+
+#include <lcio.h>
+#include <EVENT/LCCollection.h>
+#include <EVENT/LCEvent.h>
+#include <UTIL/LCRelationNavigator.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace MarlinUtil {
+
+  /** Relation navigators of the current event, keyed on the name of the
+   *  LCRelation collection. Every navigator is built once per event on first
+   *  request and then shared by all users, e.g. TrueJet_Parser and
+   *  CutOnGEANT4Bug, which only hand out references to it.
+   *
+   *  There is one cache per thread. It is emptied as soon as it is asked for a
+   *  different event, so the navigators live until the next event is
+   *  processed and nobody has to delete them. The event is identified by its
+   *  address together with its run and event numbers, so a new event at the
+   *  address of a deleted one still gets new navigators. A thread that asks
+   *  for another event in between, e.g. an overlay event, invalidates the
+   *  navigators of the current one. A navigator is also rebuilt if the
+   *  collection with its name has been replaced in the event. Relation
+   *  collections must not be modified after their navigator has been built.
+   */
+  class RelationNavigatorCache {
+
+  public:
+
+    /** The cache of the current thread, emptied if evt is not the event it was last used for. */
+    static RelationNavigatorCache& forEvent( const lcio::LCEvent* evt ) ;
+
+    /** Navigator for the relation collection with the given name.
+     *  Throws lcio::DataNotAvailableException if the collection is not in the event.
+     */
+    const UTIL::LCRelationNavigator& get( const std::string& collectionName ) ;
+
+    /** Same as get(), but returns NULL if the collection is not in the event. */
+    const UTIL::LCRelationNavigator* find( const std::string& collectionName ) ;
+
+    /** Delete all navigators. */
+    void clear() ;
+
+    RelationNavigatorCache( const RelationNavigatorCache& ) = delete ;
+    RelationNavigatorCache& operator=( const RelationNavigatorCache& ) = delete ;
+
+  private:
+
+    RelationNavigatorCache() = default ;
+
+    struct Entry {
+      const lcio::LCCollection* collection = nullptr ;
+      std::unique_ptr<UTIL::LCRelationNavigator> navigator{} ;
+    };
+
+    const UTIL::LCRelationNavigator& navigator( const std::string& collectionName, const lcio::LCCollection* col ) ;
+
+    const lcio::LCEvent* _evt = nullptr ;
+    int _runNumber = -1 ;
+    int _eventNumber = -1 ;
+    std::unordered_map<std::string,Entry> _navigators{} ;
+  };
+
+}
+
+#endif
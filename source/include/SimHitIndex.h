@@ -0,0 +1,63 @@
+#ifndef SimHitIndex_h
+#define SimHitIndex_h 1
+
+#include <lcio.h>
+#include <EVENT/LCEvent.h>
+#include <EVENT/MCParticle.h>
+#include <EVENT/SimTrackerHit.h>
+#include <EVENT/SimCalorimeterHit.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace MarlinUtil {
+
+  /** Inverted index of the simulated hits of one event: for every MC particle
+   *  the SimTrackerHits it created and its contributions to SimCalorimeterHits.
+   *
+   *  All SimTrackerHit, SimCalorimeterHit and CalorimeterHit collections of
+   *  the event are read in one pass when the index is built, afterwards all
+   *  per particle queries are hash map lookups. Build it once per event, the
+   *  collections must not be modified while the index is in use.
+   */
+  class SimHitIndex {
+
+  public:
+
+    /** One MC contribution to a SimCalorimeterHit, i.e. hit->getParticleCont( index ). */
+    struct CaloContribution {
+      lcio::SimCalorimeterHit* hit = nullptr ;
+      int index = 0 ;
+    };
+
+    SimHitIndex( const lcio::LCEvent* evt ) ;
+
+    /** SimTrackerHits created by the particle, in the order of the collections of the event. */
+    const std::vector<lcio::SimTrackerHit*>& getSimTrackerHits( const lcio::MCParticle* mcPart ) const ;
+
+    /** Contributions of the particle to SimCalorimeterHits. */
+    const std::vector<CaloContribution>& getCaloContributions( const lcio::MCParticle* mcPart ) const ;
+
+    /** Summed energy of all contributions of the particle to SimCalorimeterHits. */
+    double getSimCalorimeterEnergy( const lcio::MCParticle* mcPart ) const ;
+
+    /** Summed energy of all CalorimeterHits of the event. */
+    double getCalorimeterEnergy() const { return _caloEnergy ; }
+
+  private:
+
+    struct Entry {
+      std::vector<lcio::SimTrackerHit*> trackerHits{} ;
+      std::vector<CaloContribution> caloContributions{} ;
+      double simCaloEnergy = 0.0 ;
+    };
+
+    const Entry* find( const lcio::MCParticle* mcPart ) const ;
+
+    std::unordered_map<const lcio::MCParticle*,Entry> _entries{} ;
+    double _caloEnergy = 0.0 ;
+  };
+
+}
+
+#endif
@@ -2,6 +2,9 @@
 #define SimpleHelix_H 1
 
 #include "Trajectory.h"
+#include "CLHEP/Matrix/Matrix.h"
+
+#include <vector>
 
 /** Simple helix trajectory.
  *  @author T.Kraemer, DESY
@@ -12,6 +15,17 @@ class SimpleHelix : public Trajectory {
 
 public:
 
+  /** State of a helix at its intersection with a surface, as returned by
+   *  SimpleHelix::propagateToPlane and SimpleHelix::propagateToCylinder.
+   */
+  struct SurfaceState {
+    bool exists = false ;          ///< false if the helix does not reach the surface
+    double s = 0.0 ;               ///< path length at the intersection
+    LCVector3D position{} ;        ///< intersection point
+    LCVector3D direction{} ;       ///< unit direction at the intersection
+    LCErrorMatrix errors{3,0} ;    ///< 3x3 covariance of the intersection point
+  } ;
+
   virtual ~SimpleHelix() {} 
  
   /** Construct Helix from canonical parameters.
@@ -22,21 +36,54 @@ public:
   
   /** Position at path length s - s==0 corresponds to P.C.A to the origin.
    *  @param s      path length
-   *  @param errors return argument - not computed if NULL
+   *  @param errors return argument, 3x3 covariance of x,y,z propagated from
+   *                the helix parameter errors - not computed if NULL
    */
   virtual LCVector3D getPosition(double s, LCErrorMatrix* errors=0) const ;
   
   /** Direction at path length s, i.e. (dx/ds,dy/ds,dz/ds) 
    *  @param s      path length
-   *  @param errors return argument - not computed if NULL
+   *  @param errors return argument, 3x3 covariance of the unit direction
+   *                propagated from the helix parameter errors - not computed if NULL
    */
   virtual LCVector3D getDirection(double s,  LCErrorMatrix* errors=0) const ;
   
   /** Full covariance Matrix of x,y,z,px,py,pz   
+   *  The momentum part is only filled if the magnetic field has been set 
+   *  with setBz(), otherwise it is zero.
    *  @param s      path length
    */
   virtual LCErrorMatrix getCovarianceMatrix( double s) const ;
 
+  /** Jacobian d(x,y,z,px,py,pz)/d(d0,phi0,omega,z0,tanLambda) at path length s
+   *  (6x5). The momentum rows are zero unless the magnetic field has been set.
+   *  @param s      path length
+   */
+  CLHEP::HepMatrix getJacobian( double s ) const ;
+
+  /** Magnetic field along z in Tesla, used to convert omega into a momentum
+   *  in getCovarianceMatrix() and getJacobian(). Default is 0.
+   */
+  void setBz( double bz ) ;
+  double getBz() const ;
+
+  /** Propagate many helices to a common plane. The position errors are
+   *  evaluated on the surface, i.e. they include the variation of the 
+   *  intersection path length with the helix parameters.
+   *  @param helices helices to propagate
+   *  @param plane   surface to propagate to
+   */
+  static std::vector<SurfaceState> propagateToPlane( const std::vector<const SimpleHelix*>& helices,
+                                                     const LCPlane3D& plane ) ;
+
+  /** Propagate many helices to a common cylinder, see propagateToPlane.
+   *  Only the tube of the cylinder is used for the surface constraint.
+   *  @param helices  helices to propagate
+   *  @param cylinder surface to propagate to
+   */
+  static std::vector<SurfaceState> propagateToCylinder( const std::vector<const SimpleHelix*>& helices,
+                                                        const LCCylinder& cylinder ) ;
+
   /** Pathlength at point on trajectory closest to given position.  
    *  In order to get the distance use for example:  <br>  
    *     LCVector3D pt = t.getPosition( t.getPathAtClosestPoint( p ) ) ; <br>
@@ -87,13 +134,25 @@ protected:
   virtual double getCentreY() const ;
   virtual double getWindingLength() const ;
   virtual double getPitch();
+
+  /** Jacobian d(x,y,z)/d(d0,phi0,omega,z0,tanLambda) at path length s (3x5). */
+  CLHEP::HepMatrix getPositionJacobian( double s ) const ;
+
+  /** Jacobian of the unit direction w.r.t. the helix parameters at path length s (3x5). */
+  CLHEP::HepMatrix getDirectionJacobian( double s ) const ;
+
+  /** Covariance of the position at path length s, constrained to a surface
+   *  with the given normal at that point.
+   */
+  LCErrorMatrix getSurfaceErrors( double s, const LCVector3D& normal ) const ;
+
   double _d0=0.0;
   double _phi0=0.0;
   double _omega=1.0;
   double _z0=0.0;
   double _tanLambda=0.0;
 
-  //  double _Bz;
+  double _Bz=0.0;
 
   double _helixStart=0.0;
   double _helixEnd=0.0;
@@ -11,6 +11,7 @@
 #include <IMPL/ReconstructedParticleImpl.h>
 #include <IMPL/ParticleIDImpl.h>
 #include <string>
+#include <vector>
 
 using namespace lcio ;
 
@@ -40,9 +41,14 @@ class TrueJet_Parser {
 
   void getall(LCEvent* event)  ;  // Convenient method to get all collections needed: no need to call
                                   // the three above individually. Also all navigators are set up
-                                  // with this call - See below.
+                                  // with this call - See below. The true and quark four-vectors
+                                  // of all jets are computed here in one pass, the true-seen ones
+                                  // in one pass on the first call of a *trueseen method. The
+                                  // methods returning them below are lookups.
 
-  void delall() ;                 // Tidy up, to be called at end of each event.
+  void delall() ;                 // Tidy up, to be called at end of each event. The navigators
+                                  // are shared via MarlinUtil::RelationNavigatorCache and are not
+                                  // deleted here, they are valid until the next event.
 
   int njets() { return tjcol->getNumberOfElements(); };
                                   // Get the total number of true jets in the event
@@ -95,10 +101,10 @@ class TrueJet_Parser {
   const double* p4true(int ijet) ;
                                   // True 4-momentum of jet ijet (component 0 is E)
 
-  double Equark(int ijet) {return ( final_elementon(ijet) != NULL ? final_elementon(ijet)->getEnergy() : 0.);};
+  double Equark(int ijet) {return _jetKinematics.at(ijet).p4quark[0];};
                                   // Energy of the last quark/lepton before "hadronisation" jet ijet
 
-  double Mquark(int ijet) {return ( final_elementon(ijet) != NULL ? final_elementon(ijet)->getMass() : 0 );};
+  double Mquark(int ijet) {return _jetKinematics.at(ijet).Mquark;};
                                  // Mass of the last quark/lepton before "hadronisation" jet ijet
 
   const double* pquark(int ijet);
@@ -250,15 +256,15 @@ class TrueJet_Parser {
                                  // while in the other way jetindex( truejet-object ) gives the index.
 
 
-    LCRelationNavigator* relfcn{};      // a truejet to final colour neutral(s)    [ ReconstructedParticle:s ]
-    LCRelationNavigator* relicn{};      // a truejet to initial colour neutral(s)   [ ReconstructedParticle:s ]
+    const LCRelationNavigator* relfcn{};      // a truejet to final colour neutral(s)    [ ReconstructedParticle:s ]
+    const LCRelationNavigator* relicn{};      // a truejet to initial colour neutral(s)   [ ReconstructedParticle:s ]
 
-    LCRelationNavigator* relfp{};       // a truejet to its final quarks/leptons   [ MCParticle:s ]
-    LCRelationNavigator* relip{};       // a truejet to its initial quarks/leptons [ MCParticle:s ]
+    const LCRelationNavigator* relfp{};       // a truejet to its final quarks/leptons   [ MCParticle:s ]
+    const LCRelationNavigator* relip{};       // a truejet to its initial quarks/leptons [ MCParticle:s ]
 
 
-    LCRelationNavigator* reltjreco{};   // a truejet to all seen particles in it    [ ReconstructedParticle:s ]
-    LCRelationNavigator* reltjmcp{};    // a truejet to all true particles in it   [ MCParticle:s ]
+    const LCRelationNavigator* reltjreco{};   // a truejet to all seen particles in it    [ ReconstructedParticle:s ]
+    const LCRelationNavigator* reltjmcp{};    // a truejet to all true particles in it   [ MCParticle:s ]
 
 
                                  // Example:
@@ -272,7 +278,8 @@ class TrueJet_Parser {
                                 //  seen_partics(ijet) returns a ReconstructedParticlVec of all
                                 //  PFOs belonging to jet ijet)
 
-    LCRelationNavigator* reltrue_tj{};  // = RecoMCTruthLink
+    const LCRelationNavigator* reltrue_tj{};  // = RecoMCTruthLink, only set up by the first call of
+                                              //   a *trueseen method in the event
 
     LCCollection* tjcol{};
     LCCollection* fcncol{};
@@ -295,6 +302,22 @@ class TrueJet_Parser {
   std::string _recoMCTruthLink{};
   int _COUNT_FSR{};
 private:
+  struct JetKinematics {           // four-vectors of one jet (component 0 is E), filled by getall,
+                                   // the true-seen ones by fillTrueSeenKinematics
+    double p4true[4]{};
+    double p4trueseen[4]{};
+    double p4quark[4]{};
+    double Mtrue{};
+    double Mtrueseen{};
+    double Mquark{};
+  };
+
+  const LCRelationNavigator* navigator( const std::string& colName ) ;
+  void fillJetKinematics() ;
+  void fillTrueSeenKinematics() ;
+  const JetKinematics& trueSeenKinematics(int ijet) ;
+  std::vector<JetKinematics> _jetKinematics{};
+  bool _trueSeenFilled{};
   LCEvent* evt{};
   double p4[4]{};
   double p3[3]{};
@@ -0,0 +1,100 @@
+#ifndef Vector3T_H
+#define Vector3T_H 1
+
+#include <cmath>
+
+/** Lightweight 3-vector used by the templated geometry classes
+ *  (LCLine3DT, LCPlane3DT, LCCylinderT, LineClassT). It mirrors the subset of
+ *  the CLHEP::Hep3Vector interface that is used in MarlinUtil, but is a plain
+ *  aggregate of three numbers without virtual functions, so that it can be
+ *  inlined into hot loops and instantiated in float.
+ */
+
+template<typename FloatT>
+class Vector3T {
+public:
+  /**
+   * The floating point type used internally. Useful for generic programming
+   */
+  using float_type = FloatT;
+
+  constexpr Vector3T() = default;
+  constexpr Vector3T(FloatT xVal, FloatT yVal, FloatT zVal) : _x(xVal), _y(yVal), _z(zVal) {}
+
+  /** Construct from an array of three numbers. */
+  explicit Vector3T(const FloatT* v) : _x(v[0]), _y(v[1]), _z(v[2]) {}
+
+  /** Conversion from any vector type providing x(), y() and z(),
+   *  e.g. LCVector3D or a Vector3T of a different precision.
+   */
+  template<typename VectorT>
+  static Vector3T from(const VectorT& v) { return Vector3T(FloatT(v.x()), FloatT(v.y()), FloatT(v.z())); }
+
+  constexpr FloatT x() const { return _x; }
+  constexpr FloatT y() const { return _y; }
+  constexpr FloatT z() const { return _z; }
+
+  void setX(FloatT xVal) { _x = xVal; }
+  void setY(FloatT yVal) { _y = yVal; }
+  void setZ(FloatT zVal) { _z = zVal; }
+  void set(FloatT xVal, FloatT yVal, FloatT zVal) { _x = xVal; _y = yVal; _z = zVal; }
+
+  /** Component access, 0 = x, 1 = y, 2 = z. */
+  FloatT operator[](int i) const { return i == 0 ? _x : (i == 1 ? _y : _z); }
+
+  /** Copy the components into an array of three numbers. */
+  void copyTo(FloatT* v) const { v[0] = _x; v[1] = _y; v[2] = _z; }
+
+  constexpr FloatT dot(const Vector3T& v) const { return _x*v._x + _y*v._y + _z*v._z; }
+  constexpr Vector3T cross(const Vector3T& v) const {
+    return Vector3T(_y*v._z - _z*v._y, _z*v._x - _x*v._z, _x*v._y - _y*v._x);
+  }
+
+  constexpr FloatT mag2() const { return dot(*this); }
+  FloatT mag() const { return std::sqrt(mag2()); }
+  constexpr FloatT perp2() const { return _x*_x + _y*_y; }
+  FloatT perp() const { return std::sqrt(perp2()); }
+
+  /** Unit vector in the same direction - the null vector stays null. */
+  Vector3T unit() const {
+    FloatT tot = mag2();
+    return tot > 0 ? (*this) * (FloatT(1) / std::sqrt(tot)) : *this;
+  }
+
+  /** A vector orthogonal to this one, same convention as in CLHEP. */
+  Vector3T orthogonal() const {
+    FloatT xx = std::fabs(_x), yy = std::fabs(_y), zz = std::fabs(_z);
+    if (xx < yy) {
+      return xx < zz ? Vector3T(0, _z, -_y) : Vector3T(_y, -_x, 0);
+    } else {
+      return yy < zz ? Vector3T(-_z, 0, _x) : Vector3T(_y, -_x, 0);
+    }
+  }
+
+  Vector3T& operator+=(const Vector3T& v) { _x += v._x; _y += v._y; _z += v._z; return *this; }
+  Vector3T& operator-=(const Vector3T& v) { _x -= v._x; _y -= v._y; _z -= v._z; return *this; }
+  Vector3T& operator*=(FloatT a) { _x *= a; _y *= a; _z *= a; return *this; }
+  Vector3T& operator/=(FloatT a) { _x /= a; _y /= a; _z /= a; return *this; }
+
+  constexpr Vector3T operator-() const { return Vector3T(-_x, -_y, -_z); }
+  constexpr Vector3T operator+(const Vector3T& v) const { return Vector3T(_x + v._x, _y + v._y, _z + v._z); }
+  constexpr Vector3T operator-(const Vector3T& v) const { return Vector3T(_x - v._x, _y - v._y, _z - v._z); }
+  constexpr Vector3T operator*(FloatT a) const { return Vector3T(_x*a, _y*a, _z*a); }
+  constexpr Vector3T operator/(FloatT a) const { return Vector3T(_x/a, _y/a, _z/a); }
+
+  /** Scalar product, as for CLHEP::Hep3Vector. */
+  constexpr FloatT operator*(const Vector3T& v) const { return dot(v); }
+
+  constexpr bool operator==(const Vector3T& v) const { return _x == v._x && _y == v._y && _z == v._z; }
+  constexpr bool operator!=(const Vector3T& v) const { return !(*this == v); }
+
+private:
+  FloatT _x = 0;
+  FloatT _y = 0;
+  FloatT _z = 0;
+};
+
+template<typename FloatT>
+constexpr Vector3T<FloatT> operator*(typename Vector3T<FloatT>::float_type a, const Vector3T<FloatT>& v) { return v * a; }
+
+#endif /* ifndef Vector3T_H */
@@ -2,6 +2,8 @@
 #define MILLE_H
 
 #include <fstream>
+#include <memory>
+#include <vector>
 
 /**
  * \class Mille
@@ -16,6 +18,22 @@
  *  But note that pede will not be able to read text output and has not been tested with 
  *  derivatives/labels ==0.
  *
+ *  The buffer of the current record grows as needed, so records of long tracks with
+ *  many global labels are not truncated, and keeps its memory for the next record.
+ *  Use reserve(...) to allocate it once for the expected largest record.
+ *  Completed binary records are collected in blocks of setBlockSize(...) bytes that are
+ *  written to the file at once. A record larger than a block is written directly.
+ *  Records still in the block are written by flush() and by the destructor.
+ *
+ *  With setAsynchronous(true) full blocks are handed over to a background thread that
+ *  writes them, so the calling thread does not wait for the file system. The blocks are
+ *  passed through a ring of a few blocks; only if all of them are waiting to be written
+ *  mille(...)/end() block. Handing over a block briefly takes a mutex shared with the
+ *  writing thread, once per block. The file is byte-identical to the one written
+ *  synchronously.
+ *  flush() and the destructor wait until all records are written. Only binary output
+ *  can be written asynchronously.
+ *
  *  \author    : Gero Flucke
  *  date       : October 2006
  *  $Revision: 1.1 $
@@ -35,20 +53,41 @@ class Mille
   void kill();
   void end();
 
+  void reserve(int nWords);               // reserve buffer for records of nWords (float,int) pairs
+  void setBlockSize(unsigned int nBytes); // size of the output blocks of binary records
+  void flush();                           // write the collected records to the file
+
+  // write blocks in a background thread, using a ring of nBlocks blocks
+  void setAsynchronous(bool async, int nBlocks = 4);
+
+  // number of records written by end(), empty records are not written
+  long long getNumberOfRecords() const { return myNumRecords; }
+
  private:
+  struct AsyncWriter;
+
   void newSet();
   bool checkBufferSize(int nLocal, int nGlobal);
+  void resizeBuffer(long long nWords);
+  void writeBlock();
 
   std::ofstream myOutFile; // C-binary for output
   bool myAsBinary;         // if false output as text
   bool myWriteZero;        // if true also write out derivatives/lables ==0
 
-  enum {myBufferSize = 5000};
-  int   myBufferInt[myBufferSize];   // to collect labels etc.
-  float myBufferFloat[myBufferSize]; // to collect derivatives etc.
+  enum {myDefaultBufferSize = 5000};
+  enum {myMaxBufferSize = 0x3FFFFFFF}; // record length in words has to fit into an int
+  std::vector<int>   myBufferInt;   // to collect labels etc.
+  std::vector<float> myBufferFloat; // to collect derivatives etc.
   int   myBufferPos;
   bool  myHasSpecial; // if true, special(..) already called for this record
 
+  enum {myDefaultBlockSize = 1 << 22};
+  std::vector<char> myOutBlock; // completed binary records not yet written
+  unsigned int myBlockSize;     // myOutBlock is written when the next record does not fit
+  std::unique_ptr<AsyncWriter> myAsyncWriter; // writes the blocks if asynchronous
+  long long myNumRecords;
+
   enum {myMaxLabel = (0xFFFFFFFF - (1 << 31))}; // largest label allowed: 2^31 - 1
 };
 #endif
@@ -0,0 +1,146 @@
+#ifndef MILLEREADER_H
+#define MILLEREADER_H
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * \class MilleRecord
+ *
+ *  One record of a Mille file as written by Mille::end(): size() pairs of a float and
+ *  an int. Pair 0 holds the number of measurements dropped while the record was
+ *  filled, followed by the measurements and special blocks:
+ *
+ *   measurement : ( rMeas, 0 ) ( derLc, localIndex )... ( sigma, 0 ) ( derGl, label )...
+ *   special     : ( 0., 0 ) ( -nSpecial, 0 ) ( float, int )... nSpecial times
+ *
+ *  For binary files the arrays point into the mapped file, so a record stays valid
+ *  as long as its MilleReader. For text files they point into the reading iterator
+ *  and are overwritten by the next record.
+ */
+
+class MilleRecord
+{
+ public:
+  struct Measurement {
+    float rMeas;
+    float sigma;
+    int nLocal;             // stored, i.e. non-zero local derivatives
+    const float *derLc;
+    const int   *localIndex;
+    int nGlobal;
+    const float *derGl;
+    const int   *label;
+  };
+
+  MilleRecord() : myFloats(0), myInts(0), mySize(0) {}
+  MilleRecord(const float *floats, const int *ints, int size) :
+    myFloats(floats), myInts(ints), mySize(size) {}
+
+  int size() const { return mySize; }
+  const float *getFloats() const { return myFloats; }
+  const int   *getInts() const { return myInts; }
+
+  // number of measurements Mille dropped from this record
+  int getErrorCount() const { return mySize > 0 ? myInts[0] : 0; }
+
+  // Next measurement starting at pair pos, skipping special blocks. Start with
+  // pos = 1; returns false if there is none. A malformed record ends early.
+  bool nextMeasurement(int &pos, Measurement &measurement) const;
+
+  // special block of the record, if any (Mille::special(...))
+  bool getSpecial(int &nSpecial, const float *&floatings, const int *&integers) const;
+
+ private:
+  const float *myFloats;
+  const int   *myInts;
+  int mySize;
+};
+
+
+/**
+ * \class MilleReader
+ *
+ *  Reads back the records of a file written by Mille. Binary files are memory mapped
+ *  and read without copying; text files (Mille with asBinary = false) are parsed as
+ *  they are streamed. Records are visited with an input iterator:
+ *
+ *    MilleReader reader("mp2input.bin");
+ *    for (MilleReader::iterator it = reader.begin(); it != reader.end(); ++it) {
+ *      const MilleRecord &record = *it;
+ *      ...
+ *    }
+ *
+ *  Reading stops at the first record that is not complete or not valid; compare
+ *  iterator::getOffset() at the end with getFileSize() to find such a record.
+ *  split(...) divides a binary file at record boundaries into ranges that can be
+ *  read in parallel, each with its own iterators.
+ */
+
+class MilleReader
+{
+ public:
+  class iterator
+  {
+  public:
+    iterator() : myPos(0), myEnd(0), myData(0), myStream(0), myOffset(0), myValid(false) {}
+
+    const MilleRecord &operator*() const { this->point(); return myRecord; }
+    const MilleRecord *operator->() const { this->point(); return &myRecord; }
+    iterator &operator++() { this->read(); return *this; }
+
+    // iterators are equal if both are at the end or at the same record
+    bool operator==(const iterator &other) const {
+      return myValid == other.myValid && (!myValid || myOffset == other.myOffset);
+    }
+    bool operator!=(const iterator &other) const { return !(*this == other); }
+
+    // byte offset of the current record, or after the last record read at the end
+    size_t getOffset() const { return myOffset; }
+
+  private:
+    friend class MilleReader;
+    iterator(const char *data, size_t begin, size_t end);
+    iterator(std::istream *stream);
+    void read();
+    void point() const; // text: let myRecord point to the own arrays, also after a copy
+
+    const char *myPos;      // binary: next record in the mapped file
+    const char *myEnd;
+    const char *myData;
+    std::istream *myStream; // text: stream the records are parsed from
+    std::vector<float> myFloats;
+    std::vector<int>   myInts;
+    mutable MilleRecord myRecord;
+    size_t myOffset;
+    bool myValid;
+  };
+
+  // Maps a binary or opens a text file, throws std::runtime_error if that fails
+  MilleReader(const std::string &fileName, bool asBinary = true);
+  ~MilleReader();
+
+  MilleReader(const MilleReader&) = delete;
+  MilleReader& operator=(const MilleReader&) = delete;
+
+  // a text file can only be iterated once
+  iterator begin();
+  iterator end() const { return iterator(); }
+
+  size_t getFileSize() const { return mySize; }
+  bool isBinary() const { return myAsBinary; }
+
+  // Binary files only: nChunks + 1 iterators, chunk i is [ chunks[i], chunks[i+1] ).
+  // The chunks have about the same size in bytes.
+  std::vector<iterator> split(int nChunks) const;
+
+ private:
+  bool myAsBinary;
+  const char *myData;
+  size_t mySize;
+  std::unique_ptr<std::ifstream> myTextFile;
+};
+#endif
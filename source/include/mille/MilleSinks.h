@@ -0,0 +1,119 @@
+#ifndef MILLESINKS_H
+#define MILLESINKS_H
+
+#include "mille/Mille.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * \class MilleSink
+ *
+ *  Mille record builder of one worker thread, writing to its own binary shard file.
+ *  Use mille(...), special(...), kill() and end() as for Mille. All records ended
+ *  after setEvent(event) belong to that event, which orders them in the merged file.
+ *  A sink must only be used by one thread at a time; sinks are created by
+ *  MilleSinkFactory.
+ */
+
+class MilleSink
+{
+ public:
+  MilleSink(const std::string &shardFileName, bool asynchronous);
+
+  void setEvent(long long event) { myEvent = event; }
+
+  void mille(int NLC, const float *derLc, int NGL, const float *derGl,
+	     const int *label, float rMeas, float sigma) {
+    myMille->mille(NLC, derLc, NGL, derGl, label, rMeas, sigma);
+  }
+  void special(int nSpecial, const float *floatings, const int *integers) {
+    myMille->special(nSpecial, floatings, integers);
+  }
+  void kill() { myMille->kill(); }
+  void end();
+
+  const std::string &getShardFileName() const { return myShardFileName; }
+
+  // consecutive records of one event in the shard
+  struct EventRun
+  {
+    long long event;
+    long long nRecords;
+  };
+
+  // runs of the records written, in the order of the records in the shard
+  const std::vector<EventRun> &getEventRuns() const { return myEventRuns; }
+
+  // write the remaining records and close the shard, the sink must not be used anymore
+  void close();
+
+ private:
+  std::string myShardFileName;
+  std::unique_ptr<Mille> myMille;
+  long long myEvent;
+  std::vector<EventRun> myEventRuns;
+};
+
+
+/**
+ * \class MilleSinkFactory
+ *
+ *  Hands out one MilleSink per thread, so event workers can write Mille records
+ *  concurrently without locking. The sink of a thread writes the shard
+ *  outFileName.shard<N>, N counting the sinks in the order they were created.
+ *
+ *  When all workers are done, either
+ *   - merge() writes all records to outFileName, ordered by event and within an
+ *     event in the order they were written. If all records of an event are
+ *     written by one sink, the result does not depend on the number of threads
+ *     or on which thread processed which event. Records of one event written
+ *     by several sinks are ordered by the creation order of the sinks, which
+ *     depends on which thread asked first for its sink; or
+ *   - writeFileList(listName) writes a list of the shards to be included in the
+ *     pede steering file, which avoids copying the records.
+ *  After merge() the factory is done: getSink(), merge() and writeFileList()
+ *  throw std::runtime_error.
+ */
+
+class MilleSinkFactory
+{
+ public:
+  MilleSinkFactory(const std::string &outFileName, bool asynchronous = false);
+  ~MilleSinkFactory();
+
+  MilleSinkFactory(const MilleSinkFactory&) = delete;
+  MilleSinkFactory& operator=(const MilleSinkFactory&) = delete;
+
+  // sink of the calling thread, created at the first call, thread-safe.
+  // Throws std::runtime_error after merge().
+  MilleSink &getSink();
+
+  // close all sinks and merge their records in event order into outFileName.
+  // Returns the number of records. Throws std::runtime_error if a shard cannot
+  // be read or does not contain the records written to it. The sinks are
+  // released after a successful merge.
+  long long merge(bool removeShards = true);
+
+  // close all sinks and write the shard file names in the format of the pede
+  // steering file (keyword Cfiles followed by the binary files)
+  void writeFileList(const std::string &listFileName);
+
+  std::vector<std::string> getShardFileNames() const;
+
+ private:
+  void closeSinks();
+  void checkNotMerged() const;
+
+  std::string myOutFileName;
+  bool myAsynchronous;
+  bool myMerged;
+  mutable std::mutex myMutex;
+  std::map<std::thread::id, MilleSink*> mySinkOfThread;
+  std::vector<std::unique_ptr<MilleSink> > mySinks;
+};
+#endif
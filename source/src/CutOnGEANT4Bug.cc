@@ -1,4 +1,7 @@
 #include "CutOnGEANT4Bug.h"
+#include "RelationNavigatorCache.h"
+
+#include <unordered_map>
 
 using namespace lcio ;
 using namespace marlin ;
@@ -57,6 +60,9 @@ void CutOnGEANT4Bug::init() {
   _nRun = 0 ;
   _nEvt = 0 ;
 
+  // calibration of the calorimeter, indexed by the CalorimeterHit type
+  _calibration = _calibrCoeffECAL;
+  _calibration.insert(_calibration.end(),_calibrCoeffHCAL.begin(),_calibrCoeffHCAL.end());
 
 }
 
@@ -70,270 +76,107 @@ void CutOnGEANT4Bug::processRunHeader( LCRunHeader* ) {
 
 void CutOnGEANT4Bug::processEvent( LCEvent* evt ) {
 
-
   bool invalidTrackFound = false;
 
+  LCCollection* colTracks = nullptr;
   try {
+    colTracks = evt->getCollection(_colNameTracks);
+  }
+  catch(DataNotAvailableException &e) {}
 
-    const std::vector< std::string >* ColNames1 = evt->getCollectionNames();
-
-    for(auto iterCol = ColNames1->begin() ; iterCol != ColNames1->end() ; ++iterCol) {
-      
-      LCCollection* col1 = evt->getCollection( *iterCol ) ;
-      
-      if ( (col1->getTypeName() == LCIO::TRACK) && (*iterCol == _colNameTracks) ) {
-
-	int NTracks = col1->getNumberOfElements();
-	
-	for(int jTrack=0; jTrack<NTracks; ++jTrack){
-	  
-	  Track* track = dynamic_cast<Track*>(col1->getElementAt(jTrack));
-	  
-	  try {
-	    
-	    LCCollection* LCRcolTracks = evt->getCollection(_colNameRelationTrackToMCP);
-	    
-	    LCRelationNavigator* navTracks = new LCRelationNavigator(LCRcolTracks);
-	    const LCObjectVec& relMCParticlesToTrack = navTracks->getRelatedToObjects(track); 
-	    
-	    if ( relMCParticlesToTrack.size() > 1 ) std::cout << "Warning: More than one MCParticle related to track." << std::endl;
-    
-	    MCParticle* mcpOfTrack = 0;
-
-	    // container for the CalorimeterHits which are related to the track with hit and sub-hit energy accuracy, both run in parallel, i.e. they have the same size
-	    std::vector< std::pair<CalorimeterHit*,float> > collectedCalorimeterHitsWithEnergies;
-	    std::vector< std::pair<CalorimeterHit*,float> > collectedSubCalorimeterHitsWithEnergies;
-	    
-	    unsigned int index = 0;
-	    bool alreadyCollected = false;	
-	    
-	    float ESumCalorimeterHits = 0.0; // accumulated energy of calorimeter hits where the track contributes
-	    float ESumSubCalorimeterHits = 0.0; // accumulated energy of calorimeter hit energies, but only the part which originates from the track,i.e. sub-hit accuracy
-	  
-	  
-	    for(unsigned int i = 0; i < relMCParticlesToTrack.size(); ++i) {
-	      
-	      mcpOfTrack = dynamic_cast<MCParticle*>(relMCParticlesToTrack.at(i)); 
-	      
-	      MCParticleVec allMCPsOfTrack = MarlinUtil::getAllMCDaughters(mcpOfTrack);
-	      
-	      for(unsigned int j = 0; j < allMCPsOfTrack.size(); ++j) {
-		
-		MCParticle* mcp = allMCPsOfTrack.at(j);
-		
-		const std::vector< std::string >* ColNames = evt->getCollectionNames();
-		
-		for(auto iter = ColNames->begin() ; iter != ColNames->end() ; iter++) {
-		  
-		  LCCollection* col = evt->getCollection( *iter ) ;
-		  
-		  if ( (col->getTypeName()) == LCIO::SIMCALORIMETERHIT ) {
-		    
-		    int nHits = col->getNumberOfElements();	 
-		    
-		    for(int k = 0; k < nHits; ++k) {
-		      
-		      SimCalorimeterHit* simCaloHit = dynamic_cast<SimCalorimeterHit*>(col->getElementAt(k));
-		      
-		      // debug
-		      // std::cout << "simCaloHit->getNMCContributions() = " << simCaloHit->getNMCContributions() << std::endl;
-		      
-		      for ( int l = 0; l < simCaloHit->getNMCContributions(); ++l ) {
-		      
-			MCParticle* mcpOfCalo = simCaloHit->getParticleCont(l);
-			
-			if ( mcpOfCalo == mcp ) {
-			  
-			  // float ESimHit = simCaloHit->getEnergy(); // only for debugging
-			  float ESimHitContribution = simCaloHit->getEnergyCont(l);
-			  
-			  LCCollection* LCRcolCalorimeter = evt->getCollection(_colNameRelationCaloHitToSimCaloHit);
-			
-			  LCRelationNavigator* navCalorimeter = new LCRelationNavigator(LCRcolCalorimeter);
-			  const LCObjectVec& relCaloHitsToSimCaloHit = navCalorimeter->getRelatedFromObjects(simCaloHit);
-			  
-			  // there should only be one CalorimeterHit related to one SimCalorimeterHit since the CalorimeterHit consists (is related to) of several SimCalorimeterHit, 
-			  // but the SimCalorimeterHit is only related to one CalorimeterHit (by the ganging in the Calorimeter digitize processor)		
-			  if (relCaloHitsToSimCaloHit.size() > 1 ) {
-			    
-			    std::cout << "Warning: More than one (" << relCaloHitsToSimCaloHit.size() << ") CalorimeterHit related to one SimCalorimeterHit. " << std::endl;
-			    
-			  }
-			  
-			  
-			  // debug
-			  // std::cout << "relCaloHitsToSimCaloHit.size() = " << relCaloHitsToSimCaloHit.size() << std::endl;
-			  
-			  
-			  for ( unsigned int m = 0; m < relCaloHitsToSimCaloHit.size(); ++m ) {
-			    
-			    CalorimeterHit* caloHit = dynamic_cast<CalorimeterHit*>(relCaloHitsToSimCaloHit.at(m));
-			    
-			    // calibration of the calorimeter
-			    std::vector<float> calibration;
-			    for ( unsigned int n = 0; n < _calibrCoeffECAL.size(); ++n ) calibration.push_back(_calibrCoeffECAL.at(n));
-			    for ( unsigned int n = 0; n < _calibrCoeffHCAL.size(); ++n ) calibration.push_back(_calibrCoeffHCAL.at(n));
-			    
-			    int hitType = caloHit->getType();
-			    float EHit = caloHit->getEnergy();
-			    // float EHitCalculated   = ESimHit*calibration.at(type); // only for debugging
-			    float EHitContribution = ESimHitContribution*calibration.at(hitType);
-			    
-			    
-			    // search if caloHit has already been assigned to track	  
-			    for (unsigned int n = 0; n < collectedCalorimeterHitsWithEnergies.size(); ++n) {
-			      
-			      if (collectedCalorimeterHitsWithEnergies.at(n).first == caloHit) {
-				
-				index = n;
-				alreadyCollected = true;
-				break;
-				
-			      }
-			      else {
-				
-				index = 0;
-				alreadyCollected = false;
-				
-			      }
-			      
-			    
-			    }
-			    
-			    
-			    if ( !alreadyCollected ) { 		    
-			      
-			      std::pair<CalorimeterHit*,float> calorimeterHitWithEnergy(caloHit,EHit);
-			      collectedCalorimeterHitsWithEnergies.push_back(calorimeterHitWithEnergy);
-			      
-			      std::pair<CalorimeterHit*,float> calorimeterSubHitWithEnergy(caloHit,EHitContribution);
-			      collectedSubCalorimeterHitsWithEnergies.push_back(calorimeterSubHitWithEnergy);
-			      
-			    }
-			    // calorimeter hit has already been assigned
-			    else {
-			      
-			      collectedSubCalorimeterHitsWithEnergies.at(index).second += EHitContribution;
-			      
-			    }
-		  
-			    
-			    // debug
-			    /*
-			      std::cout << "Related hit to track " << track << "  " << "MCP of track = " << MarlinUtil::getMCName(mcp->getPDG()) 
-			      << " ( " << mcp->getPDG() << " )" << std::endl
-			      << "SimCaloHit " << simCaloHit << "  "
-			      << "Pos SimCaloHit = " << "( " << simCaloHit->getPosition()[0] << "," << simCaloHit->getPosition()[1] << "," << simCaloHit->getPosition()[2] 
-			      << " )" << "  " << "CaloHit " << caloHit << "  "
-			      << "Pos CaloHit = " << "( " << caloHit->getPosition()[0] << "," << caloHit->getPosition()[1] << "," << caloHit->getPosition()[2] << " )" 
-			      <<  std::endl
-			      << "E CaloHit (full hit) = " << EHit << "  " << "CaloHit type = " << type << "  " << "E SimCaloHit = " << ESimHit << "  " << "EHitCalculated = " 
-			      << EHitCalculated << "  " << "EHitContributed = " << EHitContribution << std::endl << std::endl;		    
-			    */
-			    
-			    
-			}
-			  
-			  delete navCalorimeter;
-			  navCalorimeter = 0;
-			  
-			}
-			
-		      }
-		      
-		    }
-
-		  }
-		  
-		}
-		
+  if ( colTracks != nullptr && colTracks->getTypeName() == LCIO::TRACK && colTracks->getNumberOfElements() > 0 ) {
+
+    try {
+
+      // everything that is needed per track is looked up once per event, the navigators are shared with other processors
+      MarlinUtil::RelationNavigatorCache& navigators = MarlinUtil::RelationNavigatorCache::forEvent(evt);
+      const LCRelationNavigator& navTracks = navigators.get(_colNameRelationTrackToMCP);
+      const LCRelationNavigator& navCalorimeter = navigators.get(_colNameRelationCaloHitToSimCaloHit);
+      const MarlinUtil::SimHitIndex simHits(evt);
+
+      int NTracks = colTracks->getNumberOfElements();
+
+      for(int jTrack=0; jTrack<NTracks && !invalidTrackFound; ++jTrack){
+
+	Track* track = static_cast<Track*>(colTracks->getElementAt(jTrack));
+
+	const LCObjectVec& relMCParticlesToTrack = navTracks.getRelatedToObjects(track);
+
+	if ( relMCParticlesToTrack.empty() ) continue;
+	if ( relMCParticlesToTrack.size() > 1 ) std::cout << "Warning: More than one MCParticle related to track." << std::endl;
+
+	// energy of each CalorimeterHit which originates from the track, i.e. sub-hit accuracy, in the order the hits are found
+	std::unordered_map<CalorimeterHit*,unsigned> hitSlots;
+	std::vector<float> subHitEnergies;
+
+	MCParticle* mcpOfTrack = nullptr;
+
+	for(unsigned int i = 0; i < relMCParticlesToTrack.size(); ++i) {
+
+	  mcpOfTrack = static_cast<MCParticle*>(relMCParticlesToTrack.at(i));
+
+	  // the recursive version on purpose: particles reached via several parents are counted more than once
+	  const MCParticleVec allMCPsOfTrack = MarlinUtil::getAllMCDaughters(mcpOfTrack);
+
+	  for ( MCParticle* mcp : allMCPsOfTrack ) {
+
+	    for ( const auto& contribution : simHits.getCaloContributions(mcp) ) {
+
+	      const float ESimHitContribution = contribution.hit->getEnergyCont(contribution.index);
+	      const LCObjectVec& relCaloHitsToSimCaloHit = navCalorimeter.getRelatedFromObjects(contribution.hit);
+
+	      // there should only be one CalorimeterHit related to one SimCalorimeterHit since the CalorimeterHit consists (is related to) of several SimCalorimeterHit, 
+	      // but the SimCalorimeterHit is only related to one CalorimeterHit (by the ganging in the Calorimeter digitize processor)		
+	      if (relCaloHitsToSimCaloHit.size() > 1 ) {
+		std::cout << "Warning: More than one (" << relCaloHitsToSimCaloHit.size() << ") CalorimeterHit related to one SimCalorimeterHit. " << std::endl;
 	      }
-	      
-	    }
-	    
-	  
-      	    // determine ESumCalorimeterHits and ESumSubCalorimeterHits
-	  
-	    //debug
-	    /*
-	      std::cout << "collectedCalorimeterHitsWithEnergies.size() = " << collectedCalorimeterHitsWithEnergies.size() << "  " 
-	      << "collectedSubCalorimeterHitsWithEnergies.size() = " << collectedSubCalorimeterHitsWithEnergies.size() << std::endl;
-	    */
-	    
-	    for(unsigned int i = 0; i < collectedCalorimeterHitsWithEnergies.size(); ++i) {
-	      
-	      // debug
-	      // CalorimeterHit* caloHit = collectedCalorimeterHitsWithEnergies.at(i).first;
-	      float EHit = collectedCalorimeterHitsWithEnergies.at(i).second;
-	      
-	      // debug
-	      // CalorimeterHit* caloSubHit = collectedSubCalorimeterHitsWithEnergies.at(i).first;
-	      float ESubHit = collectedSubCalorimeterHitsWithEnergies.at(i).second;
-	      
-	      
-	      ESumCalorimeterHits += EHit;
-	      ESumSubCalorimeterHits += ESubHit;
-	    
-	      // debug
-	      // std::cout << "caloHit = " << caloHit << "  " << "EHit = " << EHit << "  " << "caloSubHit = " << caloSubHit << "  " << "ESubHit = " << ESubHit << std::endl;
-	      
-	    }       	    
-
-	    /*
-	    double pMCP = sqrt( (mcpOfTrack->getMomentum()[0])*(mcpOfTrack->getMomentum()[0]) + (mcpOfTrack->getMomentum()[1])*(mcpOfTrack->getMomentum()[1]) +
-				(mcpOfTrack->getMomentum()[2])*(mcpOfTrack->getMomentum()[2]) );
-	    */
-
-	    double eMCP = mcpOfTrack->getEnergy();
-
-	    
-	    // debug
-	    /*
-	    std::cout << "MCP = " << MarlinUtil::getMCName(mcpOfTrack->getPDG()) << " ( " << mcpOfTrack->getPDG() << " )" << "  " << "pMCP = " << pMCP << "  " 
-		      << "EMC = " << eMCP << "  " << std::endl 
-		      << "E related to track (hit accuracy) = " << ESumCalorimeterHits << "  " 
-		      << "E related to track perfectly (sub-hit accuracy) = " << ESumSubCalorimeterHits << std::endl << std::endl;	      
-	    */
-
-	  
-	    delete navTracks;
-	    navTracks = 0;
-	  
-	    
-	    if ( ( eMCP > _eMin ) && ( ESumSubCalorimeterHits > (_k * eMCP)) ) {
-	      
-	      std::cout << std::endl
-			<< "--------------------------------------------------------------------------------------------------------------------------------------" 
-			<< std::endl << std::endl
-			<< " ==> EVENT WITH GEANT4 BUG FOUND <=="
-			<< std::endl << std::endl
-			<< "     EVENT WILL BE DISCARDED ..."
-			<< std::endl << std::endl
-			<< "--------------------------------------------------------------------------------------------------------------------------------------" 
-			<< std::endl << std::endl;
-
-	      invalidTrackFound = true;
-	      break;
-	      
+
+	      for ( LCObject* obj : relCaloHitsToSimCaloHit ) {
+
+		CalorimeterHit* caloHit = static_cast<CalorimeterHit*>(obj);
+		const float EHitContribution = ESimHitContribution*_calibration.at(caloHit->getType());
+
+		auto slot = hitSlots.emplace(caloHit,subHitEnergies.size());
+		if ( slot.second ) subHitEnergies.push_back(EHitContribution);
+		else subHitEnergies[slot.first->second] += EHitContribution;
+
+	      }
+
 	    }
-	  
+
 	  }
-	  catch(DataNotAvailableException &e){
-	    std::cout << "Collection " << _colNameRelationTrackToMCP << " or " << _colNameRelationCaloHitToSimCaloHit  << " not available in event." << std::endl;
-	  };
-	
-	} // end of loop over tracks
-    
-	if (invalidTrackFound) break; // break loop over LCCollection
-      
-      }
-      
-    } // end of loop over LCLollections in this LCEvent
-  
-  }
 
-  catch(DataNotAvailableException &e) {std::cout << "no valid collection in event " << _nEvt << std::endl; };
-    
+	}
+
+	float ESumSubCalorimeterHits = 0.0; // accumulated energy of calorimeter hit energies, but only the part which originates from the track
+	for ( float ESubHit : subHitEnergies ) ESumSubCalorimeterHits += ESubHit;
+
+	double eMCP = mcpOfTrack->getEnergy();
+
+	if ( ( eMCP > _eMin ) && ( ESumSubCalorimeterHits > (_k * eMCP)) ) {
+	      
+	  std::cout << std::endl
+		    << "--------------------------------------------------------------------------------------------------------------------------------------" 
+		    << std::endl << std::endl
+		    << " ==> EVENT WITH GEANT4 BUG FOUND <=="
+		    << std::endl << std::endl
+		    << "     EVENT WILL BE DISCARDED ..."
+		    << std::endl << std::endl
+		    << "--------------------------------------------------------------------------------------------------------------------------------------" 
+		    << std::endl << std::endl;
+
+	  invalidTrackFound = true;
+
+	}
+
+      } // end of loop over tracks
+
+    }
+    catch(DataNotAvailableException &e){
+      std::cout << "Collection " << _colNameRelationTrackToMCP << " or " << _colNameRelationCaloHitToSimCaloHit  << " not available in event." << std::endl;
+    }
+
+  }
 
   bool isEventValid = !invalidTrackFound;
   setReturnValue(isEventValid);
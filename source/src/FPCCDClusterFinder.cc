@@ -0,0 +1,161 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+#include "FPCCDClusterFinder.h"
+#include "FPCCDData.h"
+
+#include <algorithm>
+
+namespace {
+  // root of a union-find set, with path halving
+  inline int findRoot(std::vector<int> &parent, int i){
+    while( parent[i] != i ) {
+      parent[i]=parent[parent[i]];
+      i=parent[i];
+    }
+    return i;
+  }
+
+  // the set of the earlier pixel becomes the root, so cluster roots are the first pixels
+  inline void join(std::vector<int> &parent, int i, int j){
+    int ri=findRoot(parent, i);
+    int rj=findRoot(parent, j);
+    if( ri < rj ) { parent[rj]=ri; }
+    else if( rj < ri ) { parent[ri]=rj; }
+  }
+
+  // sums of one cluster under construction
+  struct ClusterSums {
+    double edep=0;
+    double xiEdep=0, zetaEdep=0;
+    double xiSum=0, zetaSum=0;
+    bool hasSignal=false, hasBackground=false, hasOverlap=false;
+  };
+}
+
+// =====================================================================
+FPCCDClusterFinder::FPCCDClusterFinder(bool diagonal): _diagonal(diagonal)
+{
+}
+
+// =====================================================================
+void FPCCDClusterFinder::findClusters(FPCCDData &data, std::vector<FPCCDPixelCluster> &clusters)
+{
+  int nLadders=data.getMaxLayer()*data.getMaxLadder();
+  std::vector< std::vector<FPCCDPixelCluster> > ladderClusters(nLadders);
+
+  data.forEachLadder([&](int layer, int ladder){
+      findClusters(data.getLadder(layer, ladder), layer, ladder, ladderClusters[layer*data.getMaxLadder()+ladder]);
+    }, data.sizeHint());
+
+  clusters.clear();
+  for(int i=0; i<nLadders; i++){
+    clusters.insert(clusters.end(), ladderClusters[i].begin(), ladderClusters[i].end());
+  }
+}
+
+// =====================================================================
+void FPCCDClusterFinder::findClusters(FPCCDPixelStore &store, int layer, int ladder,
+                                      std::vector<FPCCDPixelCluster> &clusters) const
+{
+  if( store.empty() ) { return; }
+
+  const FPCCDPixel *pixels=&*store.begin();
+  int nPixels=store.size();
+
+  std::vector<int> parent(nPixels);
+  for(int i=0; i<nPixels; i++){ parent[i]=i; }
+
+  // neighbours in the previous column are looked for in [zeta-reach, zeta+reach]
+  int reach=( _diagonal ? 1 : 0 );
+
+  int columnBegin=0;        // first pixel of the current column
+  int prevBegin=0;          // first pixel of the previous column, if it is at xi-1
+  int prevEnd=0;
+  int prev=0;               // first pixel of the previous column not below zeta-reach
+
+  for(int i=0; i<nPixels; i++){
+    int xi=pixels[i].getXiID();
+    int zeta=pixels[i].getZetaID();
+
+    if( i == 0 || xi != pixels[i-1].getXiID() ) {
+      // new column, the one before is only adjacent if it is at xi-1
+      if( i > 0 && pixels[i-1].getXiID() == xi-1 ) { prevBegin=columnBegin; prevEnd=i; }
+      else { prevBegin=prevEnd=i; }
+      prev=prevBegin;
+      columnBegin=i;
+    }
+    else if( pixels[i-1].getZetaID() == zeta-1 ) {
+      join(parent, i-1, i);
+    }
+
+    while( prev < prevEnd && pixels[prev].getZetaID() < zeta-reach ) { prev++; }
+    for(int j=prev; j<prevEnd && pixels[j].getZetaID() <= zeta+reach; j++){ join(parent, j, i); }
+  }
+
+  // roots are the first pixel of their cluster, so clusters are numbered in pixel order
+  std::vector<int> clusterOf(nPixels, -1);
+  std::vector<ClusterSums> sums;
+  std::size_t firstCluster=clusters.size();
+
+  for(int i=0; i<nPixels; i++){
+    int root=findRoot(parent, i);
+    const FPCCDPixel &pixel=pixels[i];
+    unsigned short xi=pixel.getXiID();
+    unsigned short zeta=pixel.getZetaID();
+
+    if( clusterOf[root] < 0 ) {
+      clusterOf[root]=sums.size();
+      sums.push_back(ClusterSums());
+
+      FPCCDPixelCluster cluster;
+      cluster.layer=layer;
+      cluster.ladder=ladder;
+      cluster.xi=cluster.zeta=cluster.edep=0;
+      cluster.nPixels=0;
+      cluster.xiMin=cluster.xiMax=xi;
+      cluster.zetaMin=cluster.zetaMax=zeta;
+      cluster.quality=FPCCDPixelHit::kSingle;
+      clusters.push_back(cluster);
+    }
+
+    FPCCDPixelCluster &cluster=clusters[firstCluster+clusterOf[root]];
+    ClusterSums &sum=sums[clusterOf[root]];
+
+    cluster.nPixels++;
+    cluster.xiMin=std::min(cluster.xiMin, xi);
+    cluster.xiMax=std::max(cluster.xiMax, xi);
+    cluster.zetaMin=std::min(cluster.zetaMin, zeta);
+    cluster.zetaMax=std::max(cluster.zetaMax, zeta);
+
+    sum.edep += pixel.getEdep();
+    sum.xiEdep += pixel.getEdep()*xi;
+    sum.zetaEdep += pixel.getEdep()*zeta;
+    sum.xiSum += xi;
+    sum.zetaSum += zeta;
+
+    FPCCDPixelHit::HitQuality_t quality=pixel.getQuality();
+    if( quality != FPCCDPixelHit::kBKG ) { sum.hasSignal=true; }
+    if( quality == FPCCDPixelHit::kBKG || quality == FPCCDPixelHit::kBKGOverlap ) { sum.hasBackground=true; }
+    if( quality == FPCCDPixelHit::kSignalOverlap ) { sum.hasOverlap=true; }
+  }
+
+  for(std::size_t ic=0; ic<sums.size(); ic++){
+    FPCCDPixelCluster &cluster=clusters[firstCluster+ic];
+    const ClusterSums &sum=sums[ic];
+
+    cluster.edep=sum.edep;
+    // without deposited energy the centroid is the mean pixel position
+    if( sum.edep > 0 ) {
+      cluster.xi=sum.xiEdep/sum.edep;
+      cluster.zeta=sum.zetaEdep/sum.edep;
+    }
+    else {
+      cluster.xi=sum.xiSum/cluster.nPixels;
+      cluster.zeta=sum.zetaSum/cluster.nPixels;
+    }
+
+    if( !sum.hasSignal ) { cluster.quality=FPCCDPixelHit::kBKG; }
+    else if( sum.hasBackground ) { cluster.quality=FPCCDPixelHit::kBKGOverlap; }
+    else if( sum.hasOverlap ) { cluster.quality=FPCCDPixelHit::kSignalOverlap; }
+    else { cluster.quality=FPCCDPixelHit::kSingle; }
+  }
+}
@@ -6,11 +6,93 @@
 #include <IMPL/LCCollectionVec.h>
 #include <EVENT/SimTrackerHit.h>
 #include <UTIL/LCTOOLS.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <thread>
+
+// Inputs with fewer pixels are processed in the calling thread
+#define MIN_PIXELS_PARALLEL 65536
+
+namespace {
+  // The words of an LCGenericObjectImpl, to fill and read them as one block
+  // instead of one virtual call per word
+  struct GenericObjectWords : public IMPL::LCGenericObjectImpl {
+    static std::vector<int> &of(IMPL::LCGenericObjectImpl &obj){ return obj.*(&GenericObjectWords::_intVec); }
+  };
+
+  // edep is stored as the bit pattern of the float
+  inline int floatToWord(float value){ int word; std::memcpy(&word, &value, sizeof(word)); return word; }
+  inline float wordToFloat(int word){ float value; std::memcpy(&value, &word, sizeof(value)); return value; }
+
+  // edep in units of the quantum, bounded to the range of int32_t
+  inline int32_t quantize(float edep, float quantum){
+    double value=std::round( double(edep)/quantum );
+    return int32_t( std::max( double(INT32_MIN), std::min( double(INT32_MAX), value ) ) );
+  }
+
+  // zigzag mapping of signed to unsigned values, 0,-1,1,-2,... to 0,1,2,3,...
+  inline uint32_t zigzag(int32_t value){ return ( uint32_t(value) << 1 ) ^ uint32_t( value >> 31 ); }
+  inline int32_t unzigzag(uint32_t value){ return int32_t( value >> 1 ) ^ -int32_t( value & 1 ); }
+
+  // Byte stream of the compressed format, see FPCCDData.h
+  class ByteWriter {
+   public:
+    ByteWriter(std::vector<unsigned char> &bytes): _bytes(bytes) { _bytes.clear(); }
+    void putVarint(uint32_t value){
+      while( value >= 0x80 ) { _bytes.push_back( ( value & 0x7F ) | 0x80 ); value >>= 7; }
+      _bytes.push_back( value );
+    }
+    void putWord(uint32_t value){
+      for(int i=0; i<4; i++){ _bytes.push_back( ( value >> 8*i ) & 0xFF ); }
+    }
+   private:
+    std::vector<unsigned char> &_bytes;
+  };
+
+  class ByteReader {
+   public:
+    ByteReader(const int *words, std::size_t nWords): _words(words), _nBytes(4*nWords) {}
+    bool ok() const { return _ok; }
+    void fail(){ _ok=false; }
+    uint32_t getVarint(){
+      uint32_t value=0;
+      for(int shift=0; shift<35; shift+=7){
+        uint32_t byte=getByte();
+        value |= ( byte & 0x7F ) << shift;
+        if( !( byte & 0x80 ) ) { return value; }
+      }
+      _ok=false;
+      return 0;
+    }
+    uint32_t getWord(){
+      uint32_t value=0;
+      for(int i=0; i<4; i++){ value |= getByte() << 8*i; }
+      return value;
+    }
+   private:
+    uint32_t getByte(){
+      if( _pos >= _nBytes ) { _ok=false; return 0; }
+      uint32_t byte=( uint32_t(_words[_pos/4]) >> 8*(_pos%4) ) & 0xFF;
+      _pos++;
+      return byte;
+    }
+    const int *_words;
+    std::size_t _nBytes;
+    std::size_t _pos=0;
+    bool _ok=true;
+  };
+}
 
 // =====================================================================
 FPCCDData::FPCCDData(int maxlayer, int maxladder): _maxlayer(maxlayer), _maxladder(maxladder),
-                                                   _pxHits( _maxlayer, std::vector<PixelHitMap_t>(_maxladder) )
+                                                   _pxHits( _maxlayer, std::vector<FPCCDPixelStore>(_maxladder) ),
+                                                   _nThreads(1),
+                                                   _packFormat(kPlainFormat),
+                                                   _edepQuantum(0.0)
 {
   //std::cout << "***FPCCDData class: constructor!**** " << std::endl; 
   //std::cout << "_maxlayer = " << _maxlayer << std::endl; 
@@ -18,8 +100,8 @@ FPCCDData::FPCCDData(int maxlayer, int maxladder): _maxlayer(maxlayer), _maxladd
   //The above check shows that Both _maxlayer and _maxladder are always same, 6 and 17.
 
   //_pxHits.resize(_maxlayer); //--> "resize" method belongs to std::vector. This changes the number of elements. In this case, resized to 6 elements. (_maxlayer is 6 by default.)
-  //_pxHits is defined in FPCCDData.h. _pxHits is PixelDataBuf_t, namely std::vector< std::vector<std::map<unsigned int, FPCCDPixelHit*>> > .
-  //This structure is matrix whose elements are FPCCDPixelHit*.
+  //_pxHits is defined in FPCCDData.h. _pxHits is PixelStoreBuf_t, namely std::vector< std::vector<FPCCDPixelStore> > .
+  //This structure is matrix whose elements are the pixel hits of one ladder.
   
   //for(int i=0;i<_maxlayer;i++){ _pxHits[i].resize(_maxladder); }
   //--> 2nd elements are resized. By default, _maxlayer is 17 regardless that each layer has different number of ladders. 
@@ -32,11 +114,6 @@ void FPCCDData::clear()
 {
   for(int layer=0;layer<_maxlayer;layer++){
     for(int ladder=0;ladder<_maxladder;ladder++){
-            PixelHitMap_t::iterator it = _pxHits[layer][ladder].begin();
-      while( it != _pxHits[layer][ladder].end()){
-        delete (*it).second;
-        it++ ;
-      }
       _pxHits[layer][ladder].clear();
     }
   }
@@ -49,9 +126,9 @@ void FPCCDData::dump()
   for(int layer=0;layer<_maxlayer;layer++) {
     for(int ladder=0;ladder<_maxladder;ladder++) {
       if( _pxHits[layer][ladder].size() > 0 ) {
-        PixelHitMap_t::iterator it=_pxHits[layer][ladder].begin();
+        PixelIterator_t it=_pxHits[layer][ladder].begin();
         while( it != _pxHits[layer][ladder].end() ) {
-          (*it).second->print();
+          getPixelHit(layer, ladder, *it).print();
           it++;
         }
       }
@@ -69,18 +146,18 @@ void FPCCDData::addPixelHit(FPCCDPixelHit &aHit, bool isSignal)
   FPCCDPixelHit::HitQuality_t addedQuality;
   { isSignal ? addedQuality = FPCCDPixelHit::kSingle : addedQuality = FPCCDPixelHit::kBKG ; }  
 
-  PixelHitMap_t::iterator it=_pxHits[layer][ladder].find(hitid);//map (or multimap) returns end if not found.
-  // Append ADC if same pixelID exist in the map
-  if( it != _pxHits[layer][ladder].end() ) {
-    FPCCDPixelHit *findhit=(*it).second;  
-    //    addedQuality = aHit.getQuality();
-    findhit->addPixelHit(aHit, addedQuality); //Don't regard this addPixelHit as a recursive method. This method comes from FPCCDPixelHit.
-  }
-  // Add new hit if not exist in the map
-  else {
-    aHit.setQuality(addedQuality);
-    _pxHits[layer][ladder].insert(PixelHitMap_t::value_type(hitid, new FPCCDPixelHit(aHit)));
-  }
+  // Deposits in the same pixel are merged by the store when the hits are read
+  const std::vector<int> &orderIDs=aHit.getOrderIDs();
+  _pxHits[layer][ladder].addPixel(hitid, aHit.getEdep(), addedQuality, orderIDs.data(), orderIDs.size());
+}
+
+// ===================================================================
+FPCCDPixelHit FPCCDData::getPixelHit(int layer, int ladder, const FPCCDPixel &pixel)
+{
+  FPCCDPixelHit aHit(layer, ladder, pixel.getXiID(), pixel.getZetaID(), pixel.getEdep(), pixel.getQuality());
+  const int *orderIDs=_pxHits[layer][ladder].getOrderIDs(pixel);
+  for(unsigned int oi = 0; oi < pixel.getSizeOfOrderID(); oi++){ aHit.setOrderID(orderIDs[oi]); }
+  return aHit;
 }
 
 // ===================================================================
@@ -90,93 +167,54 @@ void FPCCDData::packPixelHits(EVENT::LCCollection &colvec)
   // _pxHits are cleared after copying to save space
   for(int layer=0;layer<_maxlayer;layer++) {
     for(int ladder=0;ladder<_maxladder;ladder++) {
-      PixelHitMap_t::iterator it=_pxHits[layer][ladder].begin();//PixelHitMap_t is "std::map<unsigned int, FPCCDPixelHit*>".
-      //The type of _pxHits[some number][some number] is PixelHitMap_t. This is OK.
-      if( it != _pxHits[layer][ladder].end() ) {
+      if( !_pxHits[layer][ladder].empty() ) {
         IMPL::LCGenericObjectImpl *out=new IMPL::LCGenericObjectImpl();
-        unsigned int index=0;//In C++, initialization is repeated. So, in 2nd loop, this discription also occuers.
-        // store layer number, ladder number in the first word
-        // Most significant 4 bits (left 4 bits) should be kept unused 
-        // for future use as a data format type
-        int word0=( (layer & 0x000000FF ) << 8 | ( ladder & 0x000000FF ) );
-        //mori: This process is bit operation. The followings is from FPCCDData.h
-        /*************from FPCCDData.h******
-          Format of LCGenericObject is as follows:
-          PixelHits in one ladder are packed in one element.
-          First 32 bit word contains layerID and ladderID of the element.
-          Counting bit position from left to right, layerID and ladderID
-          information are stored as follows. 
-          bit 31-16: reserved for future use --> Mori [simthits address which makes layerID and ladderID of hit points should be put here.]
-          bit 15-8 : layerID
-          bit 7-0  : ladderID
-          - Last words are for pixel hits in a ladder. Two word is used 
-            for each pixel hit. 
-            -- First word
-            bit 31: 0 
-            bit 30-29 : hit quality bit
-            0 = hit is created by a single SimTrackerHit of 
-            a signal event.
-            1 = hit is created by multiple SimTrackerHits of 
-            a signal event
-            2 = hit is created by a sigle SimTrackerHit of 
-            a signal event and hits by background events
-            3 = hit is created by multiple SimTrackerHits 
-            of a signal event and background events. 
-            bit 28-16 : xiID 
-            bit 15-0  : zetaID
-            -- Second word
-            dEdx value given by SimTrackerHit object.
-            Float value is stored with a help of union.
-        **********************************/
-        //Namely, word0 = 0x0000LLDD (LL is layerID and DD is ladderID.)
-        //I think layerID doesn't need 8bits, only needs 4bits(ultimately speaking 3bits but it is no useful for reading code. ). 
-        //The type of word0 is 4bite, namely 32bits. The bit digit of 0x00000000 is same as the one of "int".
-        //Namely, word0 has unused 16bits (but can take only minus value.). 
-
-        out->setIntVal(index, word0 );//virtual void  setIntVal (unsigned index, int value) --> Sets the integer value at the given index. 
-        index++;
-        while( it !=_pxHits[layer][ladder].end() ) {
-          FPCCDPixelHit *aHit=(*it).second;
-          // First word, from left to right,
-          // MSB =0 to indicate hitID word --> MSB means Most Significant Bit or Bite. Most left bit or bite is MSB. ex) MSB of 00110101 = 0 ( in bit ) and MSB of b189ff77 is b1 ( in bite ) 
-          //     next 2 bit for quality
-          //     next 13 + 16 bit for hit id ( xi and zeta )
-          unsigned int hitid=(unsigned int)aHit->encodeCellWord();//encodeCellWord() is from FPCCDPixelHit. 
-          //If already _xiID and _zetaID is set in the instance pointed by *aHit,
-          //then it returns unsigned int number which has 32bits data (effectively, 29bits) of _xiID and _zetaID.  
-          //When packing data, this extra 3bit is deleted. Don't put additional value in these 3bits. 
-          unsigned int quality=(unsigned int)aHit->getQuality();//from FPCCDPixelHit.h. 
-          //(define) HitQuality_t getQuality(){ return _quality; } 
-          //(define) typedef enum { kSingle=0, kSignalOverlap=0x01, kBKGOverlap=0x02, kBKG=0x03} HitQuality_t;
-          int hitwd= ( ( (unsigned int)quality << 29 & 0x60000000 ) |
-                       ( (hitid & 0x1FFFFFFF ) ) );
-          //0x60000000 is 1100....000 (number of 0 is 29.)
-          //0x1FFFFFFF is 00010000....0000 (number of 0 from 1 is 28.)
-          out->setIntVal(index++, hitwd );
-          // 2nd word is edep
-          union intfloat { float edep; int iedep; } edepout; //union is like struct. usage: edepout.edep and edpeout.iedep.
-
-          edepout.edep=aHit->getEdep();//If already _edep is set, then return _edep.
-          out->setIntVal(index++, edepout.iedep);
-          
-          it++;
-             
-          //*************important change is here. 20121204 Mori**************//   
-          //New information, which simthit was used, is added into LCGenericObject here.
-          int osize = aHit->getSizeOfOrderID();
-          out->setIntVal(index++, osize);
-          for(int oi = 0; oi < osize; oi++){ out->setIntVal(index++, aHit->getOrderID(oi)); }
-          //**************************end**************************************//
-
-        } // moving data in aHit to LCGenericObjectImpl
+        // All words of the ladder are written to one buffer that becomes the
+        // int data of the object
+        std::vector<int> words;
+        if( _packFormat == kCompressedFormat ) { packLadderCompressed(layer, ladder, words); }
+        else { packLadder(layer, ladder, words); }
+        GenericObjectWords::of(*out).swap(words);
         colvec.addElement(out);  // add one element --> Adds the given element to (end of) the collection.
-        // maybe like std::vector::push_back()
       }
     }
   }
   clear();//Contents of _pxHits is cleared.
 }
 
+// ===================================================================
+void FPCCDData::packLadder(int layer, int ladder, std::vector<int> &words)
+{
+  FPCCDPixelStore &store=_pxHits[layer][ladder];
+
+  std::size_t nWords=1;
+  for(PixelIterator_t it=store.begin(); it!=store.end(); it++){ nWords += 3 + it->getSizeOfOrderID(); }
+  words.resize(nWords);
+  int *word=words.data();
+
+  // store layer number, ladder number in the first word
+  // Most significant 4 bits (left 4 bits) should be kept unused 
+  // for future use as a data format type
+  //Namely, word0 = 0x0000LLDD (LL is layerID and DD is ladderID.)
+  *word++=( (layer & 0x000000FF ) << 8 | ( ladder & 0x000000FF ) );
+
+  for(PixelIterator_t it=store.begin(); it!=store.end(); it++){
+    // First word, from left to right,
+    // MSB =0 to indicate hitID word
+    //     next 2 bit for quality
+    //     next 13 + 16 bit for hit id ( xi and zeta ), as given by FPCCDPixelHit::encodeCellWord()
+    unsigned int quality=(unsigned int)it->getQuality();
+    *word++=( ( quality << 29 & 0x60000000 ) | ( it->cellWord & 0x1FFFFFFF ) );
+    // 2nd word is edep
+    *word++=floatToWord(it->getEdep());
+    // 3rd word is the number of order IDs, followed by the order IDs
+    unsigned int osize=it->getSizeOfOrderID();
+    *word++=osize;
+    std::memcpy(word, store.getOrderIDs(*it), osize*sizeof(int));
+    word += osize;
+  }
+}
+
 // =====================================================
 int FPCCDData::unpackPixelHits(EVENT::LCCollection &col)
 {
@@ -187,76 +225,214 @@ int FPCCDData::unpackPixelHits(EVENT::LCCollection &col)
 
   int nhits=0;
   int nElements=col.getNumberOfElements();
+  std::vector<int> scratch;
 
 //   UTIL::LCTOOLS::printLCGenericObjects(col);
 
   clear();
   for(int ie=0;ie<nElements;ie++){
-    int ig=0;
-    EVENT::LCGenericObject *obj=dynamic_cast<EVENT::LCGenericObject*>(col.getElementAt(ie));
-    unsigned int iw0=obj->getIntVal(ig);//Returns the integer value for the given index. 
-    int layer=( ( iw0>>8 ) & 0x000000FF );
-    int ladder= ( iw0 & 0x000000FF ) ;
-    ig++;
-    while( ig < obj->getNInt() ) { //obj->getNInt()  -->  Number of integer values stored in this object. 
-      unsigned int iw=obj->getIntVal(ig);
-      FPCCDPixelHit *aHit=new FPCCDPixelHit(layer, ladder);
-      // Converting first word
-      aHit->decodeCellWord(iw);// xiID and zetaID are set here. 
-      unsigned int qwd=(iw & 0x60000000 ) >> 29 ;
-      switch ( qwd ) {
-      case 0 : aHit->setQuality(FPCCDPixelHit::kSingle); break;
-      case 1 : aHit->setQuality(FPCCDPixelHit::kSignalOverlap) ; break ;
-      case 2 : aHit->setQuality(FPCCDPixelHit::kBKGOverlap) ; break ;
-      case 3 : aHit->setQuality((FPCCDPixelHit::HitQuality_t)(FPCCDPixelHit::kSignalOverlap|FPCCDPixelHit::kBKGOverlap)) ; break ;
-      //case 3 --> first a pair of blaces is cast. second pair is casted value.
-      }
-      ig++;
-      // converting second word ; 
-      union intfloat { float edep ; int iedep ; } edepin ;
-      edepin.iedep=obj->getIntVal(ig++);
-      aHit->setEdep(edepin.edep);
-       
-      //************************important change 20121204 mori********************************//
-      int osize = obj->getIntVal(ig++);//osize shows multiplicity of original simthits in one pixel hit.
-      for(int oi = 0; oi < osize; oi++ ){ 
-         aHit->setOrderID( obj->getIntVal(ig++) );
-      }
-      //***************************************************************************************//
+    EVENT::LCObject *element=col.getElementAt(ie);
+    // The words are read in one block from LCGenericObjectImpl and its
+    // subclasses used by the LCIO readers, word by word from anything else
+    IMPL::LCGenericObjectImpl *impl=dynamic_cast<IMPL::LCGenericObjectImpl*>(element);
+    if( impl != 0 ) {
+      const std::vector<int> &words=GenericObjectWords::of(*impl);
+      nhits += unpackLadder(words.data(), words.size());
+    }
+    else {
+      EVENT::LCGenericObject *obj=dynamic_cast<EVENT::LCGenericObject*>(element);
+      scratch.resize(obj->getNInt());
+      for(int ig=0; ig<obj->getNInt(); ig++){ scratch[ig]=obj->getIntVal(ig); }
+      nhits += unpackLadder(scratch.data(), scratch.size());
+    }
+  }
+  return nhits;
+}
 
-      unsigned int hitid=aHit->encodeCellWord();
-      _pxHits[layer][ladder].insert(PixelHitMap_t::value_type(hitid, aHit));
-      nhits++;
-//      aHit->print();
+// =====================================================
+int FPCCDData::unpackLadder(const int *words, int nWords)
+{
+  if( nWords == 0 ) { return 0; }
+
+  unsigned int iw0=words[0];
+  unsigned int version=( iw0 >> 16 );
+  if( version != kPlainFormat && version != kCompressedFormat ) {
+    std::cerr << "FPCCDData::unpackPixelHits: unknown format version " << version << ", element skipped" << std::endl;
+    return 0;
+  }
+
+  int layer=( ( iw0>>8 ) & 0x000000FF );
+  int ladder= ( iw0 & 0x000000FF ) ;
+  if( layer >= _maxlayer || ladder >= _maxladder ) {
+    std::cerr << "FPCCDData::unpackPixelHits: layer " << layer << " ladder " << ladder
+              << " out of range, element skipped" << std::endl;
+    return 0;
+  }
+  if( version == kCompressedFormat ) { return unpackLadderCompressed(words, nWords); }
+
+  int nhits=0;
+  int ig=1;
+
+  FPCCDPixelStore &store=_pxHits[layer][ladder];
+  store.reserve((nWords-1)/3, 0);
+
+  while( ig+3 <= nWords ) {
+    unsigned int iw=words[ig++];
+    // Converting first word, xiID and zetaID as in FPCCDPixelHit::decodeCellWord()
+    unsigned int hitid=( iw & 0x1FFFFFFF );
+    unsigned int qwd=(iw & 0x60000000 ) >> 29 ;
+    // 0 : kSingle, 1 : kSignalOverlap, 2 : kBKGOverlap, 3 : kSignalOverlap|kBKGOverlap
+    FPCCDPixelHit::HitQuality_t quality=(FPCCDPixelHit::HitQuality_t)qwd;
+    // converting second word ; 
+    float edep=wordToFloat(words[ig++]);
+    // osize shows multiplicity of original simthits in one pixel hit.
+    int osize=words[ig++];
+    if( osize < 0 || osize > nWords-ig ) { break; }
+
+    store.addPixel(hitid, edep, quality, words+ig, osize);
+    ig += osize;
+    nhits++;
+  }
+  return nhits;
+}
+
+// ===================================================================
+void FPCCDData::packLadderCompressed(int layer, int ladder, std::vector<int> &words)
+{
+  FPCCDPixelStore &store=_pxHits[layer][ladder];
+
+  std::vector<unsigned char> bytes;
+  ByteWriter out(bytes);
+  unsigned int nPixels=0;
+  unsigned int lastCell=0;
+  int lastOrderID=0;
+
+  for(PixelIterator_t it=store.begin(); it!=store.end(); it++){
+    unsigned int cell=( it->cellWord & 0x1FFFFFFF );
+    out.putVarint(cell-lastCell);
+    lastCell=cell;
+
+    unsigned int osize=it->getSizeOfOrderID();
+    out.putVarint( osize << 2 | ( (unsigned int)it->getQuality() & 0x3 ) );
+
+    if( _edepQuantum > 0 ) { out.putVarint(zigzag( quantize(it->getEdep(), _edepQuantum) )); }
+    else { out.putWord(floatToWord(it->getEdep())); }
+
+    const int *orderIDs=store.getOrderIDs(*it);
+    for(unsigned int oi=0; oi<osize; oi++){
+      out.putVarint(zigzag(orderIDs[oi]-lastOrderID));
+      lastOrderID=orderIDs[oi];
     }
+    nPixels++;
+  }
+
+  words.assign(3+(bytes.size()+3)/4, 0);
+  words[0]=( kCompressedFormat << 16 | (layer & 0x000000FF ) << 8 | ( ladder & 0x000000FF ) );
+  words[1]=nPixels;
+  words[2]=floatToWord( _edepQuantum > 0 ? _edepQuantum : 0.0f );
+  for(std::size_t k=0; k<bytes.size(); k++){
+    words[3+k/4] |= int( uint32_t(bytes[k]) << 8*(k%4) );
+  }
+}
+
+// =====================================================
+int FPCCDData::unpackLadderCompressed(const int *words, int nWords)
+{
+  if( nWords < 3 ) { return 0; }
+
+  // layer and ladder have been checked by unpackLadder(...)
+  unsigned int iw0=words[0];
+  int layer=( ( iw0>>8 ) & 0x000000FF );
+  int ladder= ( iw0 & 0x000000FF ) ;
+  unsigned int nPixels=words[1];
+  float edepQuantum=wordToFloat(words[2]);
+
+  FPCCDPixelStore &store=_pxHits[layer][ladder];
+  ByteReader in(words+3, nWords-3);
+  std::vector<int> orderIDs;
+  unsigned int cell=0;
+  int lastOrderID=0;
+
+  int nhits=0;
+  for(unsigned int ip=0; ip<nPixels; ip++){
+    cell += in.getVarint();
+    unsigned int osizeQuality=in.getVarint();
+    FPCCDPixelHit::HitQuality_t quality=(FPCCDPixelHit::HitQuality_t)( osizeQuality & 0x3 );
+    float edep=( edepQuantum > 0 ? unzigzag(in.getVarint())*edepQuantum : wordToFloat(in.getWord()) );
+
+    if( ( osizeQuality >> 2 ) > 4u*nWords ) { in.fail(); }  // corrupt data
+    orderIDs.resize( in.ok() ? osizeQuality >> 2 : 0 );
+    for(unsigned int oi=0; oi<orderIDs.size() && in.ok(); oi++){
+      lastOrderID += unzigzag(in.getVarint());
+      orderIDs[oi]=lastOrderID;
+    }
+    if( !in.ok() ) {
+      std::cerr << "FPCCDData::unpackPixelHits: truncated compressed data for layer " << layer
+                << " ladder " << ladder << std::endl;
+      break;
+    }
+
+    store.addPixel(cell, edep, quality, orderIDs.data(), orderIDs.size());
+    nhits++;
   }
   return nhits;
 }
 
 // =====================================================
-void FPCCDData::Add(FPCCDData &bgHit)
+std::size_t FPCCDData::sizeHint() const
 {
-  FPCCDPixelHit *aHit;
-  
-  for(int i=0; i<_maxlayer; i++){  
-    for(int j=0; j<_maxladder; j++){
-      
-      
-      PixelHitMap_t::iterator it= bgHit.itBegin(i, j);
-      while( it != bgHit.itEnd(i, j)){
-        
-        aHit=(*it).second;
-        //std::cout << "Add is starting!" << std::endl;
-	   //std::cout << "getQuality = " << aHit->getQuality() << std::endl;
-	   bool isSignal = (aHit->getQuality() == FPCCDPixelHit::kSingle);
-	   //std::cout << "isSignal = " << isSignal  << std::endl;
-        FPCCDData::addPixelHit( *aHit, isSignal);
-        
-	   //FPCCDData::addPixelHit( *aHit, false);
-        
-        it++;
-      }
-      
+  std::size_t nPixels=0;
+  for(int layer=0; layer<_maxlayer; layer++){
+    for(int ladder=0; ladder<_maxladder; ladder++){
+      nPixels += _pxHits[layer][ladder].sizeHint();
     }
   }
+  return nPixels;
+}
+
+// =====================================================
+void FPCCDData::forEachLadder(const std::function<void(int, int)> &func, std::size_t nPixels)
+{
+  int nLadders=_maxlayer*_maxladder;
+  unsigned int nThreads=( _nThreads > 0 ? _nThreads : std::thread::hardware_concurrency() );
+  if( nThreads > (unsigned int)nLadders ) { nThreads=nLadders; }
+
+  if( nPixels < MIN_PIXELS_PARALLEL || nThreads < 2 ) {
+    for(int i=0; i<nLadders; i++){ func(i/_maxladder, i%_maxladder); }
+    return;
+  }
+
+  // Ladders are independent, each thread takes the next one not yet done
+  std::atomic<int> next(0);
+  auto worker=[&](){
+    for(int i=next++; i<nLadders; i=next++){ func(i/_maxladder, i%_maxladder); }
+  };
+
+  std::vector<std::thread> threads;
+  for(unsigned int it=1; it<nThreads; it++){ threads.emplace_back(worker); }
+  worker();
+  for(std::thread &thread : threads){ thread.join(); }
+}
+
+// =====================================================
+void FPCCDData::Add(FPCCDData &bgHit)
+{
+  // Pixels are sorted and merged ladder by ladder
+  forEachLadder([&](int layer, int ladder){ Add(bgHit, layer, ladder); }, bgHit.sizeHint());
+}
+
+// =====================================================
+void FPCCDData::Add(FPCCDData &bgHit, int layer, int ladder)
+{
+  _pxHits[layer][ladder].overlay(bgHit.getLadder(layer, ladder));
+}
+
+// =====================================================
+void FPCCDData::Add(const FPCCDPixelLibrary::Entry &bgEntry)
+{
+  forEachLadder([&](int layer, int ladder){
+      if( layer >= bgEntry.nLayers || ladder >= bgEntry.nLadders ) { return; }
+      const FPCCDPixel *begin=bgEntry.begin(layer, ladder);
+      _pxHits[layer][ladder].overlay(begin, bgEntry.end(layer, ladder)-begin, bgEntry.orderIDs);
+    }, bgEntry.getNPixels());
 }
@@ -74,13 +74,7 @@ void FPCCDPixelHit::addPixelHit(FPCCDPixelHit &aHit, HitQuality_t addedQuality)
   }
  //****************************end*****************************************//
 
-  if( _quality == kSingle || _quality == kSignalOverlap ){
-    if( addedQuality == kSingle || addedQuality == kSignalOverlap ) { _quality=kSignalOverlap; }
-    else { _quality=kBKGOverlap; }
-  }
-  else if( _quality == kBKG){
-    if( addedQuality == kSingle || addedQuality == kSignalOverlap ) { _quality = kBKGOverlap;}
-  }
+  _quality=combineQuality(_quality, addedQuality);
 //   if( aHit.getMCParticleVec().size() > 0 ) {
     
 //     for(int i=0;i<aHit.getMCParticleVec().size();i++) {
@@ -90,6 +84,19 @@ void FPCCDPixelHit::addPixelHit(FPCCDPixelHit &aHit, HitQuality_t addedQuality)
 
 }
 
+// =====================================================================
+FPCCDPixelHit::HitQuality_t FPCCDPixelHit::combineQuality(HitQuality_t quality, HitQuality_t addedQuality)
+{
+  if( quality == kSingle || quality == kSignalOverlap ){
+    if( addedQuality == kSingle || addedQuality == kSignalOverlap ) { return kSignalOverlap; }
+    else { return kBKGOverlap; }
+  }
+  else if( quality == kBKG){
+    if( addedQuality == kSingle || addedQuality == kSignalOverlap ) { return kBKGOverlap;}
+  }
+  return quality;
+}
+
 // =====================================================================
 unsigned int FPCCDPixelHit::encodeCellWord()
 {
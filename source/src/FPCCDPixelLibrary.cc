@@ -0,0 +1,230 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+#include "FPCCDPixelLibrary.h"
+#include "FPCCDData.h"
+
+#include <IO/LCReader.h>
+#include <IOIMPL/LCFactory.h>
+#include <EVENT/LCCollection.h>
+#include <EVENT/LCEvent.h>
+#include <Exceptions.h>
+
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+// =====================================================================
+FPCCDLibraryFormat::EntryLayout FPCCDLibraryFormat::entryLayout(const EntryHeader &header, uint32_t nLadderSlots)
+{
+  EntryLayout layout;
+  uint64_t pos=header.headerSize;
+
+  // every array is padded to 8 bytes
+  auto array=[&pos](uint64_t bytes){
+    uint64_t start=pos;
+    pos += ( bytes + 7 ) & ~uint64_t(7);
+    return start;
+  };
+
+  layout.ladderBegin=array( ( uint64_t(nLadderSlots) + 1 ) * sizeof(uint32_t) );
+  layout.pixels=array( uint64_t(header.nPixels) * sizeof(FPCCDPixel) );
+  layout.orderIDs=array( uint64_t(header.nOrderIDs) * sizeof(int32_t) );
+  layout.size=pos;
+
+  return layout;
+}
+
+
+// =====================================================================
+FPCCDPixelLibrary::FPCCDPixelLibrary(const std::string &fileName):
+  _file(fileName, FPCCDLibraryFormat::fileMagic, FPCCDLibraryFormat::formatVersion, sizeof(FPCCDLibraryFormat::FileHeader),
+        "FPCCDPixelLibrary", "a FPCCD pixel library")
+{
+  const FPCCDLibraryFormat::FileHeader *fileHeader=reinterpret_cast<const FPCCDLibraryFormat::FileHeader*>(_file.data());
+  if( uint64_t(fileHeader->nLayers)*fileHeader->nLadders >= INT_MAX ) {
+    throw std::runtime_error("FPCCDPixelLibrary: "+fileName+" has an invalid number of layers or ladders");
+  }
+  _nLayers=fileHeader->nLayers;
+  _nLadders=fileHeader->nLadders;
+
+  // the ladders and order IDs of the pixels have to stay inside their entry,
+  // and the pixels of a ladder have to be sorted for FPCCDData::Add(...)
+  const uint32_t nLadderSlots=_nLayers*_nLadders;
+  auto checkEntry=[nLadderSlots](const char *record){
+    const FPCCDLibraryFormat::EntryHeader *header=reinterpret_cast<const FPCCDLibraryFormat::EntryHeader*>(record);
+    const FPCCDLibraryFormat::EntryLayout layout=FPCCDLibraryFormat::entryLayout(*header, nLadderSlots);
+    if( layout.size > header->recordSize ) { return false; }
+
+    const uint32_t *ladderBegin=reinterpret_cast<const uint32_t*>(record+layout.ladderBegin);
+    for(uint32_t i=0; i<=nLadderSlots; i++){
+      if( ladderBegin[i] > header->nPixels || ( i > 0 && ladderBegin[i] < ladderBegin[i-1] ) ) { return false; }
+    }
+
+    const FPCCDPixel *pixels=reinterpret_cast<const FPCCDPixel*>(record+layout.pixels);
+    for(uint32_t i=0; i<header->nPixels; i++){
+      if( uint64_t(pixels[i].orderBegin) + pixels[i].nOrderIDs > header->nOrderIDs ) { return false; }
+      // the quality is read as a number, not every value is a HitQuality_t
+      uint32_t quality;
+      std::memcpy(&quality, &pixels[i].quality, sizeof(quality));
+      if( quality > FPCCDPixelHit::kBKG ) { return false; }
+    }
+    for(uint32_t l=0; l<nLadderSlots; l++){
+      for(uint32_t i=ladderBegin[l]+1; i<ladderBegin[l+1]; i++){
+        if( pixels[i].cellWord <= pixels[i-1].cellWord ) { return false; }
+      }
+    }
+    return true;
+  };
+
+  _entries=_file.indexRecords(FPCCDLibraryFormat::entryMagic, sizeof(FPCCDLibraryFormat::EntryHeader), checkEntry);
+}
+
+// =====================================================================
+FPCCDPixelLibrary::Entry FPCCDPixelLibrary::getEntry(std::size_t i) const
+{
+  const char *record=_file.data()+_entries.at(i);
+
+  Entry entry;
+  entry.header=reinterpret_cast<const FPCCDLibraryFormat::EntryHeader*>(record);
+  entry.nLayers=_nLayers;
+  entry.nLadders=_nLadders;
+
+  const FPCCDLibraryFormat::EntryLayout layout=FPCCDLibraryFormat::entryLayout(*entry.header, _nLayers*_nLadders);
+
+  entry.ladderBegin=reinterpret_cast<const uint32_t*>(record+layout.ladderBegin);
+  entry.pixels=reinterpret_cast<const FPCCDPixel*>(record+layout.pixels);
+  entry.orderIDs=reinterpret_cast<const int*>(record+layout.orderIDs);
+
+  return entry;
+}
+
+
+// =====================================================================
+FPCCDPixelLibraryWriter::FPCCDPixelLibraryWriter(const std::string &fileName, int nLayers, int nLadders):
+  _nLayers(nLayers), _nLadders(nLadders)
+{
+  // an existing library has to be for the same geometry, and a torn last
+  // entry is cut off so that the new entries follow the complete ones
+  struct stat info;
+  if( ::stat(fileName.c_str(), &info) == 0 && info.st_size > 0 ) {
+    std::size_t endOfRecords=0;
+    {
+      FPCCDPixelLibrary existing(fileName);
+      if( existing.getNLayers() != nLayers || existing.getNLadders() != nLadders ) {
+        throw std::runtime_error("FPCCDPixelLibraryWriter: "+fileName+" is a library for a different number of layers or ladders");
+      }
+      endOfRecords=existing.getEndOfRecords();
+    }
+    if( endOfRecords < std::size_t(info.st_size) && ::truncate(fileName.c_str(), endOfRecords) != 0 ) {
+      throw std::runtime_error("FPCCDPixelLibraryWriter: cannot remove the incomplete last entry of "+fileName);
+    }
+  }
+
+  _file.open(fileName, std::ios::binary | std::ios::app);
+  if( !_file ) { throw std::runtime_error("FPCCDPixelLibraryWriter: cannot open "+fileName+" for writing"); }
+
+  _file.seekp(0, std::ios::end);
+  if( _file.tellp() == std::streampos(0) ) {
+    FPCCDLibraryFormat::FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, FPCCDLibraryFormat::fileMagic, sizeof(header.magic));
+    header.version=FPCCDLibraryFormat::formatVersion;
+    header.headerSize=sizeof(FPCCDLibraryFormat::FileHeader);
+    header.nLayers=nLayers;
+    header.nLadders=nLadders;
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+}
+
+// =====================================================================
+void FPCCDPixelLibraryWriter::write(FPCCDData &data)
+{
+  if( data.getMaxLayer() != _nLayers || data.getMaxLadder() != _nLadders ) {
+    throw std::runtime_error("FPCCDPixelLibraryWriter: FPCCDData has a different number of layers or ladders than the library");
+  }
+
+  FPCCDLibraryFormat::EntryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic=FPCCDLibraryFormat::entryMagic;
+  header.headerSize=sizeof(FPCCDLibraryFormat::EntryHeader);
+
+  for(int layer=0; layer<_nLayers; layer++){
+    for(int ladder=0; ladder<_nLadders; ladder++){
+      FPCCDPixelStore &store=data.getLadder(layer, ladder);
+      for(PixelIterator_t it=store.begin(); it!=store.end(); it++){
+        header.nPixels++;
+        header.nOrderIDs += it->getSizeOfOrderID();
+      }
+    }
+  }
+
+  const FPCCDLibraryFormat::EntryLayout layout=FPCCDLibraryFormat::entryLayout(header, _nLayers*_nLadders);
+  header.recordSize=layout.size;
+
+  // the whole entry is assembled in memory and written at once
+  _buffer.assign(layout.size/sizeof(uint64_t), 0);
+  char *record=reinterpret_cast<char*>(_buffer.data());
+  std::memcpy(record, &header, sizeof(header));
+
+  uint32_t *ladderBegin=reinterpret_cast<uint32_t*>(record+layout.ladderBegin);
+  FPCCDPixel *pixels=reinterpret_cast<FPCCDPixel*>(record+layout.pixels);
+  int *orderIDs=reinterpret_cast<int*>(record+layout.orderIDs);
+
+  uint32_t nPixels=0;
+  uint32_t nOrderIDs=0;
+  for(int layer=0; layer<_nLayers; layer++){
+    for(int ladder=0; ladder<_nLadders; ladder++){
+      ladderBegin[layer*_nLadders+ladder]=nPixels;
+      FPCCDPixelStore &store=data.getLadder(layer, ladder);
+      for(PixelIterator_t it=store.begin(); it!=store.end(); it++){
+        FPCCDPixel &pixel=pixels[nPixels++];
+        pixel=*it;
+        pixel.orderBegin=nOrderIDs;
+        std::memcpy(orderIDs+nOrderIDs, store.getOrderIDs(*it), it->getSizeOfOrderID()*sizeof(int));
+        nOrderIDs += it->getSizeOfOrderID();
+      }
+    }
+  }
+  ladderBegin[_nLayers*_nLadders]=nPixels;
+
+  _file.write(record, layout.size);
+  if( !_file ) { throw std::runtime_error("FPCCDPixelLibraryWriter: writing the pixel library failed"); }
+}
+
+// =====================================================================
+void FPCCDPixelLibraryWriter::flush()
+{
+  _file.flush();
+}
+
+// =====================================================================
+int FPCCDPixelLibraryWriter::convert(const std::vector<std::string> &lcioFileNames, const std::string &colName,
+                                     const std::string &libraryName, int nLayers, int nLadders)
+{
+  FPCCDPixelLibraryWriter writer(libraryName, nLayers, nLadders);
+  FPCCDData data(nLayers, nLadders);
+
+  std::unique_ptr<IO::LCReader> reader(IOIMPL::LCFactory::getInstance()->createLCReader());
+  reader->open(lcioFileNames);
+
+  int nEvents=0;
+  EVENT::LCEvent *evt;
+  while( ( evt=reader->readNextEvent() ) != nullptr ) {
+    // an event without the collection is a bunch crossing without hits
+    data.clear();
+    try {
+      data.unpackPixelHits(*evt->getCollection(colName));
+    }
+    catch(EVENT::DataNotAvailableException &e) {}
+
+    writer.write(data);
+    nEvents++;
+  }
+  reader->close();
+  writer.flush();
+
+  return nEvents;
+}
@@ -0,0 +1,138 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+#include "FPCCDPixelStore.h"
+
+#include <algorithm>
+
+// =====================================================================
+void FPCCDPixelStore::addPixel(unsigned int cellWord, float edep, FPCCDPixelHit::HitQuality_t quality,
+                               const int *orderIDs, unsigned int nOrderIDs)
+{
+  FPCCDPixel pixel;
+  pixel.cellWord=cellWord;
+  pixel.edep=edep;
+  pixel.quality=quality;
+  pixel.orderBegin=_orderIDs.size();
+  pixel.nOrderIDs=nOrderIDs;
+
+  _pixels.push_back(pixel);
+  _orderIDs.insert(_orderIDs.end(), orderIDs, orderIDs+nOrderIDs);
+}
+
+// =====================================================================
+void FPCCDPixelStore::overlay(FPCCDPixelStore &bgStore)
+{
+  bgStore.sort();
+  overlay(bgStore._pixels.data(), bgStore._pixels.size(), bgStore._orderIDs.data());
+}
+
+// =====================================================================
+void FPCCDPixelStore::overlay(const FPCCDPixel *bgPixels, std::size_t nBgPixels, const int *bgOrderIDs)
+{
+  sort();
+  if( nBgPixels == 0 ) { return; }
+
+  _scratchPixels.clear();
+  _scratchPixels.reserve(_pixels.size()+nBgPixels);
+  _scratchOrderIDs.clear();
+  _scratchOrderIDs.reserve(_orderIDs.size()+nBgPixels);
+
+  std::vector<FPCCDPixel>::const_iterator it=_pixels.begin();
+  const FPCCDPixel *bg=bgPixels;
+  const FPCCDPixel *bgEnd=bgPixels+nBgPixels;
+
+  while( it != _pixels.end() || bg != bgEnd ) {
+    if( bg == bgEnd || ( it != _pixels.end() && it->cellWord < bg->cellWord ) ) {
+      appendScratch(*it, _orderIDs.data());
+      it++;
+      continue;
+    }
+
+    FPCCDPixelHit::HitQuality_t addedQuality=
+      ( bg->quality == FPCCDPixelHit::kSingle ? FPCCDPixelHit::kSingle : FPCCDPixelHit::kBKG );
+
+    if( it != _pixels.end() && it->cellWord == bg->cellWord ) {
+      appendScratch(*it, _orderIDs.data());
+      FPCCDPixel &merged=_scratchPixels.back();
+      merged.edep += bg->edep;
+      merged.quality=FPCCDPixelHit::combineQuality(merged.quality, addedQuality);
+      _scratchOrderIDs.insert(_scratchOrderIDs.end(), bgOrderIDs+bg->orderBegin,
+                              bgOrderIDs+bg->orderBegin+bg->nOrderIDs);
+      merged.nOrderIDs += bg->nOrderIDs;
+      it++;
+    }
+    else {
+      appendScratch(*bg, bgOrderIDs);
+      _scratchPixels.back().quality=addedQuality;
+    }
+    bg++;
+  }
+
+  _pixels.swap(_scratchPixels);
+  _orderIDs.swap(_scratchOrderIDs);
+  _nSorted=_pixels.size();
+}
+
+// =====================================================================
+void FPCCDPixelStore::appendScratch(const FPCCDPixel &pixel, const int *pool)
+{
+  _scratchPixels.push_back(pixel);
+  _scratchPixels.back().orderBegin=_scratchOrderIDs.size();
+  _scratchOrderIDs.insert(_scratchOrderIDs.end(), pool+pixel.orderBegin,
+                          pool+pixel.orderBegin+pixel.nOrderIDs);
+}
+
+// =====================================================================
+void FPCCDPixelStore::clear()
+{
+  _pixels.clear();
+  _orderIDs.clear();
+  _nSorted=0;
+}
+
+// =====================================================================
+void FPCCDPixelStore::sort()
+{
+  if( _nSorted == _pixels.size() ) { return; }
+
+  // Nothing to do if the new pixels came in order, e.g. when unpacked from a collection
+  std::size_t i=std::max<std::size_t>(_nSorted, 1);
+  while( i < _pixels.size() && _pixels[i-1].cellWord < _pixels[i].cellWord ) { i++; }
+  if( i >= _pixels.size() ) {
+    _nSorted=_pixels.size();
+    return;
+  }
+
+  // Stable, so deposits in the same cell stay in the order they were added
+  std::stable_sort(_pixels.begin(), _pixels.end(),
+                   [](const FPCCDPixel &a, const FPCCDPixel &b){ return a.cellWord < b.cellWord; });
+
+  _scratchPixels.clear();
+  _scratchOrderIDs.clear();
+  _scratchOrderIDs.reserve(_orderIDs.size());
+
+  std::size_t first=0;
+  while( first < _pixels.size() ) {
+    FPCCDPixel merged=_pixels[first];
+    merged.orderBegin=_scratchOrderIDs.size();
+
+    std::size_t next=first;
+    do {
+      const FPCCDPixel &aPixel=_pixels[next];
+      if( next != first ) {
+        merged.edep += aPixel.edep;
+        merged.quality=FPCCDPixelHit::combineQuality(merged.quality, aPixel.quality);
+      }
+      _scratchOrderIDs.insert(_scratchOrderIDs.end(), _orderIDs.begin()+aPixel.orderBegin,
+                              _orderIDs.begin()+aPixel.orderBegin+aPixel.nOrderIDs);
+      next++;
+    } while( next < _pixels.size() && _pixels[next].cellWord == merged.cellWord );
+
+    merged.nOrderIDs=_scratchOrderIDs.size()-merged.orderBegin;
+    _scratchPixels.push_back(merged);
+    first=next;
+  }
+
+  _pixels.swap(_scratchPixels);
+  _orderIDs.swap(_scratchOrderIDs);
+  _nSorted=_pixels.size();
+}
@@ -28,6 +28,8 @@ LineClass::LineClass(float *x0,
   }
 }
 
+LineClass::~LineClass() {}
+
 float * LineClass::getReferencePoint() {
   return _x0;
 }
@@ -0,0 +1,189 @@
+#include "MCBalance.h"
+
+#include <EVENT/MCParticle.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+using lcio::MCParticle;
+
+
+namespace MarlinUtil {
+
+  std::vector<MCBalance::Category> MCBalance::defaultCategories() {
+
+    std::vector<Category> categories( nDefaultCategories ) ;
+
+    //FIXME : Hard coded cut. Use the detector geometry instead
+    categories[beamTube].name = "beam tube" ;
+    categories[beamTube].maxBeamAngle = 0.1 ;
+
+    categories[neutrinos].name = "neutrinos" ;
+    categories[neutrinos].pdgCodes = { 12, 14, 16 } ;
+
+    categories[muons].name = "muons" ;
+    categories[muons].pdgCodes = { 13 } ;
+
+    categories[electrons].name = "electrons" ;
+    categories[electrons].pdgCodes = { 11 } ;
+
+    categories[pi0s].name = "pi0s" ;
+    categories[pi0s].pdgCodes = { 111 } ;
+
+    categories[photons].name = "photons" ;
+    categories[photons].pdgCodes = { 22 } ;
+
+    categories[longLivedNeutralHadrons].name = "long lived neutral hadrons" ;
+    categories[longLivedNeutralHadrons].pdgCodes = { 130, 2112 } ;
+
+    categories[shortLivedNeutralHadrons].name = "short lived neutral hadrons" ;
+    categories[shortLivedNeutralHadrons].pdgCodes = { 310, 3122, 3212, 3322 } ;
+
+    categories[chargedHadrons].name = "charged hadrons" ;
+    categories[chargedHadrons].charge = Charge::charged ;
+
+    return categories ;
+  }
+
+
+  std::vector<MCBalance::Category> MCBalance::legacyCategories() {
+
+    std::vector<Category> categories = defaultCategories() ;
+
+    // the catch-all of the original getMC_Balance
+    categories[chargedHadrons].charge = Charge::any ;
+    categories[chargedHadrons].excludedPdgCodes = { 311 } ;
+
+    return categories ;
+  }
+
+
+  MCBalance::MCBalance( std::vector<Category> categories ) : _categories( std::move( categories ) ) {
+    for( auto& category : _categories ) {
+      std::sort( category.pdgCodes.begin(), category.pdgCodes.end() ) ;
+      std::sort( category.excludedPdgCodes.begin(), category.excludedPdgCodes.end() ) ;
+    }
+  }
+
+
+  MCBalance::Result MCBalance::compute( const lcio::LCCollection* mcParticles ) {
+
+    // snapshot of the stable particles
+    _pdg.clear() ; _charge.clear() ;
+    _energy.clear() ; _px.clear() ; _py.clear() ; _pz.clear() ;
+
+    const int nParticles = mcParticles->getNumberOfElements() ;
+    for( int i = 0 ; i < nParticles ; ++i ) {
+      const MCParticle* mcp = static_cast<const MCParticle*>( mcParticles->getElementAt( i ) ) ;
+      if( mcp->getGeneratorStatus() != 1 ) continue ;
+      _pdg.push_back( std::abs( mcp->getPDG() ) ) ;
+      _charge.push_back( mcp->getCharge() ) ;
+      _energy.push_back( mcp->getEnergy() ) ;
+      _px.push_back( mcp->getMomentum()[0] ) ;
+      _py.push_back( mcp->getMomentum()[1] ) ;
+      _pz.push_back( mcp->getMomentum()[2] ) ;
+    }
+
+    const unsigned n = _pdg.size() ;
+
+    _beamAngle.resize( n ) ;
+    for( unsigned i = 0 ; i < n ; ++i ) {
+      const double theta = std::atan2( std::hypot( _px[i], _py[i] ), _pz[i] ) ;
+      _beamAngle[i] = std::min( theta, M_PI - theta ) ;
+    }
+
+    // first matching category, -1 for none
+    _category.assign( n, -1 ) ;
+    for( int c = int( _categories.size() ) - 1 ; c >= 0 ; --c ) {
+
+      const Category& category = _categories[c] ;
+      const bool anyCode = category.pdgCodes.empty() ;
+
+      for( unsigned i = 0 ; i < n ; ++i ) {
+        const bool matches = ( _beamAngle[i] >= category.minBeamAngle ) & ( _beamAngle[i] < category.maxBeamAngle )
+          & ( category.charge == Charge::any || ( category.charge == Charge::charged ) == ( _charge[i] != 0.f ) )
+          & ( anyCode || std::binary_search( category.pdgCodes.begin(), category.pdgCodes.end(), _pdg[i] ) )
+          & !std::binary_search( category.excludedPdgCodes.begin(), category.excludedPdgCodes.end(), _pdg[i] ) ;
+        if( matches ) _category[i] = c ;
+      }
+    }
+
+    Result result ;
+    result.categories.resize( _categories.size() ) ;
+
+    for( unsigned i = 0 ; i < n ; ++i ) {
+      const int c = _category[i] ;
+      Sum& sum = c >= 0 ? result.categories[c] : result.unclassified ;
+      sum.energy += _energy[i] ;
+      sum.px += _px[i] ;
+      sum.py += _py[i] ;
+      sum.pz += _pz[i] ;
+      ++sum.n ;
+      if( c < 0 ) result.unclassifiedPDGCodes.push_back( _pdg[i] ) ;
+    }
+
+    return result ;
+  }
+
+
+  MCEnergyBalance getMCEnergyBalance( const lcio::LCEvent* evt, const std::string& colNameMC ) {
+    MCBalance balance ;
+    return getMCEnergyBalance( evt, balance, colNameMC ) ;
+  }
+
+
+  MCEnergyBalance getMCEnergyBalance( const lcio::LCEvent* evt, MCBalance& balance, const std::string& colNameMC ) {
+
+    if( balance.getCategories().size() < MCBalance::nDefaultCategories ) {
+      throw std::runtime_error( "getMCEnergyBalance: MCBalance needs at least the " + std::to_string( int( MCBalance::nDefaultCategories ) )
+                                + " default categories" ) ;
+    }
+
+    const MCBalance::Result result = balance.compute( evt->getCollection( colNameMC ) ) ;
+    const auto& sums = result.categories ;
+
+    MCEnergyBalance b ;
+
+    b.beamTubeEnergy = sums[MCBalance::beamTube].energy ;
+    b.neutrinoEnergy = sums[MCBalance::neutrinos].energy ;
+    b.electronEnergy = sums[MCBalance::electrons].energy ;
+    b.muonEnergy = sums[MCBalance::muons].energy ;
+    b.photonEnergy = sums[MCBalance::photons].energy ;
+    b.pi0Energy = sums[MCBalance::pi0s].energy ;
+    b.longLivedNeutralHadronEnergy = sums[MCBalance::longLivedNeutralHadrons].energy ;
+    b.shortLivedNeutralHadronEnergy = sums[MCBalance::shortLivedNeutralHadrons].energy ;
+    b.chargedHadronEnergy = sums[MCBalance::chargedHadrons].energy ;
+
+    b.nBeamTube = sums[MCBalance::beamTube].n ;
+    b.nNeutrinos = sums[MCBalance::neutrinos].n ;
+    b.nElectrons = sums[MCBalance::electrons].n ;
+    b.nMuons = sums[MCBalance::muons].n ;
+    b.nPhotons = sums[MCBalance::photons].n ;
+    b.nPi0s = sums[MCBalance::pi0s].n ;
+    b.nLongLivedNeutralHadrons = sums[MCBalance::longLivedNeutralHadrons].n ;
+    b.nShortLivedNeutralHadrons = sums[MCBalance::shortLivedNeutralHadrons].n ;
+    b.nChargedHadrons = sums[MCBalance::chargedHadrons].n ;
+
+    b.totalEnergy = b.electronEnergy + b.muonEnergy + b.chargedHadronEnergy + b.pi0Energy + b.photonEnergy
+      + b.longLivedNeutralHadronEnergy + b.shortLivedNeutralHadronEnergy + b.neutrinoEnergy ;
+    const int nTotal = b.nElectrons + b.nMuons + b.nChargedHadrons + b.nPi0s + b.nPhotons
+      + b.nLongLivedNeutralHadrons + b.nShortLivedNeutralHadrons + b.nNeutrinos ;
+
+    // muons deposit 1.6 GeV on average in the calorimeter
+    b.muonEnergyLost = b.muonEnergy - b.nMuons * 1.6 ;
+    b.lostEnergy = b.neutrinoEnergy + b.muonEnergyLost + b.beamTubeEnergy ;
+
+    b.measurableEnergy = b.totalEnergy - b.lostEnergy ;
+    if( b.measurableEnergy < 0.0 ) b.measurableEnergy = 0.000001 ;
+    b.nMeasurable = std::max( nTotal - b.nNeutrinos - b.nBeamTube, 0 ) ;
+
+    b.visibleEnergy = b.totalEnergy - b.neutrinoEnergy - b.beamTubeEnergy ;
+
+    b.unclassifiedPDGCodes = result.unclassifiedPDGCodes ;
+
+    return b ;
+  }
+
+}
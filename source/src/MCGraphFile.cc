@@ -0,0 +1,112 @@
+#include "MCGraphFile.h"
+
+namespace MarlinUtil {
+
+  namespace MCGraph {
+
+    RecordLayout recordLayout( const EventHeader& header ) {
+
+      RecordLayout layout ;
+      uint64_t pos = header.headerSize ;
+
+      // every column is padded to 8 bytes
+      auto column = [&pos]( uint64_t bytes ) {
+        const uint64_t start = pos ;
+        pos += ( bytes + 7 ) & ~uint64_t( 7 ) ;
+        return start ;
+      } ;
+
+      const uint64_t n = header.nParticles ;
+
+      layout.px = column( n * sizeof( double ) ) ;
+      layout.py = column( n * sizeof( double ) ) ;
+      layout.pz = column( n * sizeof( double ) ) ;
+      layout.energy = column( n * sizeof( double ) ) ;
+      layout.mass = column( n * sizeof( double ) ) ;
+      layout.vx = column( n * sizeof( double ) ) ;
+      layout.vy = column( n * sizeof( double ) ) ;
+      layout.vz = column( n * sizeof( double ) ) ;
+      layout.pdg = column( n * sizeof( int32_t ) ) ;
+      layout.generatorStatus = column( n * sizeof( int32_t ) ) ;
+      layout.simulatorStatus = column( n * sizeof( int32_t ) ) ;
+      layout.trueJet = column( ( header.flags & hasTrueJet ) ? n * sizeof( int32_t ) : 0 ) ;
+      layout.parentOffsets = column( ( n + 1 ) * sizeof( uint32_t ) ) ;
+      layout.parents = column( header.nParentLinks * sizeof( int32_t ) ) ;
+      layout.daughterOffsets = column( ( n + 1 ) * sizeof( uint32_t ) ) ;
+      layout.daughters = column( header.nDaughterLinks * sizeof( int32_t ) ) ;
+      layout.size = pos ;
+
+      return layout ;
+    }
+
+  }
+
+
+  namespace {
+
+    // CSR offsets of nParticles particles have to start at 0, not decrease and end at nLinks,
+    // the links have to point to particles of the event
+    bool checkLinks( const uint32_t* offsets, const int32_t* links, uint32_t nParticles, uint32_t nLinks ) {
+      if( offsets[0] != 0 || offsets[nParticles] != nLinks ) return false ;
+      for( uint32_t i = 0 ; i < nParticles ; ++i ) {
+        if( offsets[i+1] < offsets[i] ) return false ;
+      }
+      for( uint32_t i = 0 ; i < nLinks ; ++i ) {
+        if( links[i] < 0 || uint32_t( links[i] ) >= nParticles ) return false ;
+      }
+      return true ;
+    }
+
+  }
+
+
+  MCGraphReader::MCGraphReader( const std::string& fileName ) :
+    _file( fileName, MCGraph::fileMagic, MCGraph::formatVersion, sizeof( MCGraph::FileHeader ), "MCGraphReader", "an MC graph file" ) {
+
+    auto checkRecord = []( const char* record ) {
+      const auto* header = reinterpret_cast<const MCGraph::EventHeader*>( record ) ;
+      const MCGraph::RecordLayout layout = MCGraph::recordLayout( *header ) ;
+      if( layout.size > header->recordSize ) return false ;
+
+      return checkLinks( reinterpret_cast<const uint32_t*>( record + layout.parentOffsets ),
+                         reinterpret_cast<const int32_t*>( record + layout.parents ), header->nParticles, header->nParentLinks )
+        && checkLinks( reinterpret_cast<const uint32_t*>( record + layout.daughterOffsets ),
+                       reinterpret_cast<const int32_t*>( record + layout.daughters ), header->nParticles, header->nDaughterLinks ) ;
+    } ;
+
+    _records = _file.indexRecords( MCGraph::eventMagic, sizeof( MCGraph::EventHeader ), checkRecord ) ;
+  }
+
+
+  MCGraphReader::Event MCGraphReader::getEvent( size_t i ) const {
+
+    const char* record = _file.data() + _records.at( i ) ;
+
+    Event event ;
+    event.header = reinterpret_cast<const MCGraph::EventHeader*>( record ) ;
+
+    const MCGraph::RecordLayout layout = MCGraph::recordLayout( *event.header ) ;
+
+    event.px = reinterpret_cast<const double*>( record + layout.px ) ;
+    event.py = reinterpret_cast<const double*>( record + layout.py ) ;
+    event.pz = reinterpret_cast<const double*>( record + layout.pz ) ;
+    event.energy = reinterpret_cast<const double*>( record + layout.energy ) ;
+    event.mass = reinterpret_cast<const double*>( record + layout.mass ) ;
+    event.vx = reinterpret_cast<const double*>( record + layout.vx ) ;
+    event.vy = reinterpret_cast<const double*>( record + layout.vy ) ;
+    event.vz = reinterpret_cast<const double*>( record + layout.vz ) ;
+    event.pdg = reinterpret_cast<const int32_t*>( record + layout.pdg ) ;
+    event.generatorStatus = reinterpret_cast<const int32_t*>( record + layout.generatorStatus ) ;
+    event.simulatorStatus = reinterpret_cast<const int32_t*>( record + layout.simulatorStatus ) ;
+    if( event.header->flags & MCGraph::hasTrueJet ) {
+      event.trueJet = reinterpret_cast<const int32_t*>( record + layout.trueJet ) ;
+    }
+    event.parentOffsets = reinterpret_cast<const uint32_t*>( record + layout.parentOffsets ) ;
+    event.parents = reinterpret_cast<const int32_t*>( record + layout.parents ) ;
+    event.daughterOffsets = reinterpret_cast<const uint32_t*>( record + layout.daughterOffsets ) ;
+    event.daughters = reinterpret_cast<const int32_t*>( record + layout.daughters ) ;
+
+    return event ;
+  }
+
+}
@@ -0,0 +1,145 @@
+#include "MCGraphWriter.h"
+#include "TrueJet_Parser.h"
+
+#include <EVENT/MCParticle.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using lcio::MCParticle;
+using lcio::MCParticleVec;
+
+
+namespace MarlinUtil {
+
+  MCGraphWriter::MCGraphWriter( const std::string& fileName ) {
+
+    // a torn last record is cut off so that the new records follow the complete ones
+    struct stat info ;
+    if( ::stat( fileName.c_str(), &info ) == 0 && info.st_size > 0 ) {
+      const size_t endOfRecords = MCGraphReader( fileName ).getEndOfRecords() ;
+      if( endOfRecords < size_t( info.st_size ) && ::truncate( fileName.c_str(), endOfRecords ) != 0 ) {
+        throw std::runtime_error( "MCGraphWriter: cannot remove the incomplete last record of " + fileName ) ;
+      }
+    }
+
+    _file.open( fileName, std::ios::binary | std::ios::app ) ;
+    if( !_file ) throw std::runtime_error( "MCGraphWriter: cannot open " + fileName + " for writing" ) ;
+
+    _file.seekp( 0, std::ios::end ) ;
+    if( _file.tellp() == std::streampos( 0 ) ) {
+      MCGraph::FileHeader header ;
+      std::memcpy( header.magic, MCGraph::fileMagic, sizeof( header.magic ) ) ;
+      header.version = MCGraph::formatVersion ;
+      header.headerSize = sizeof( MCGraph::FileHeader ) ;
+      _file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) ) ;
+    }
+  }
+
+
+  void MCGraphWriter::write( const lcio::LCEvent* evt, const lcio::LCCollection* mcParticles, TrueJet_Parser* trueJets ) {
+
+    const int n = mcParticles->getNumberOfElements() ;
+
+    std::vector<MCParticle*> particles( n ) ;
+    std::unordered_map<const MCParticle*,int> indexOf ;
+    indexOf.reserve( n ) ;
+
+    for( int i = 0 ; i < n ; ++i ) {
+      particles[i] = static_cast<MCParticle*>( mcParticles->getElementAt( i ) ) ;
+      indexOf.emplace( particles[i], i ) ;
+    }
+
+    auto countLinks = [&]( const MCParticleVec& links ) {
+      uint32_t count = 0 ;
+      for( const MCParticle* link : links ) count += indexOf.count( link ) ;
+      return count ;
+    } ;
+
+    MCGraph::EventHeader header ;
+    std::memset( &header, 0, sizeof( header ) ) ;
+    header.magic = MCGraph::eventMagic ;
+    header.headerSize = sizeof( MCGraph::EventHeader ) ;
+    header.runNumber = evt->getRunNumber() ;
+    header.eventNumber = evt->getEventNumber() ;
+    header.nParticles = n ;
+    header.flags = trueJets != nullptr ? uint32_t( MCGraph::hasTrueJet ) : 0 ;
+    for( const MCParticle* part : particles ) {
+      header.nParentLinks += countLinks( part->getParents() ) ;
+      header.nDaughterLinks += countLinks( part->getDaughters() ) ;
+    }
+
+    const MCGraph::RecordLayout layout = MCGraph::recordLayout( header ) ;
+    header.recordSize = layout.size ;
+
+    // the whole record is assembled in memory and written at once
+    _buffer.assign( layout.size / sizeof( uint64_t ), 0 ) ;
+    char* record = reinterpret_cast<char*>( _buffer.data() ) ;
+    std::memcpy( record, &header, sizeof( header ) ) ;
+
+    auto doubles = [record]( uint64_t offset ) { return reinterpret_cast<double*>( record + offset ) ; } ;
+    auto ints = [record]( uint64_t offset ) { return reinterpret_cast<int32_t*>( record + offset ) ; } ;
+    auto offsets = [record]( uint64_t offset ) { return reinterpret_cast<uint32_t*>( record + offset ) ; } ;
+
+    double *px = doubles( layout.px ), *py = doubles( layout.py ), *pz = doubles( layout.pz ) ;
+    double *energy = doubles( layout.energy ), *mass = doubles( layout.mass ) ;
+    double *vx = doubles( layout.vx ), *vy = doubles( layout.vy ), *vz = doubles( layout.vz ) ;
+    int32_t *pdg = ints( layout.pdg ), *generatorStatus = ints( layout.generatorStatus ), *simulatorStatus = ints( layout.simulatorStatus ) ;
+    int32_t *trueJet = ints( layout.trueJet ) ;
+    uint32_t *parentOffsets = offsets( layout.parentOffsets ), *daughterOffsets = offsets( layout.daughterOffsets ) ;
+    int32_t *parents = ints( layout.parents ), *daughters = ints( layout.daughters ) ;
+
+    uint32_t nParents = 0 ;
+    uint32_t nDaughters = 0 ;
+
+    for( int i = 0 ; i < n ; ++i ) {
+
+      MCParticle* part = particles[i] ;
+
+      px[i] = part->getMomentum()[0] ;
+      py[i] = part->getMomentum()[1] ;
+      pz[i] = part->getMomentum()[2] ;
+      energy[i] = part->getEnergy() ;
+      mass[i] = part->getMass() ;
+      vx[i] = part->getVertex()[0] ;
+      vy[i] = part->getVertex()[1] ;
+      vz[i] = part->getVertex()[2] ;
+      pdg[i] = part->getPDG() ;
+      generatorStatus[i] = part->getGeneratorStatus() ;
+      simulatorStatus[i] = part->getSimulatorStatus() ;
+
+      if( trueJets != nullptr ) {
+        const int jet = trueJets->mcpjet( part ) ;
+        trueJet[i] = jet >= 0 ? jet : -1 ;
+      }
+
+      parentOffsets[i] = nParents ;
+      for( const MCParticle* parent : part->getParents() ) {
+        auto it = indexOf.find( parent ) ;
+        if( it != indexOf.end() ) parents[ nParents++ ] = it->second ;
+      }
+
+      daughterOffsets[i] = nDaughters ;
+      for( const MCParticle* daughter : part->getDaughters() ) {
+        auto it = indexOf.find( daughter ) ;
+        if( it != indexOf.end() ) daughters[ nDaughters++ ] = it->second ;
+      }
+    }
+
+    parentOffsets[n] = nParents ;
+    daughterOffsets[n] = nDaughters ;
+
+    _file.write( record, layout.size ) ;
+    if( !_file ) throw std::runtime_error( "MCGraphWriter: writing the MC graph failed" ) ;
+  }
+
+
+  void MCGraphWriter::flush() {
+    _file.flush() ;
+  }
+
+}
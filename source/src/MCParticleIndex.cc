@@ -0,0 +1,255 @@
+#include "MCParticleIndex.h"
+
+#include <algorithm>
+#include <iostream>
+
+using lcio::MCParticle;
+using lcio::MCParticleVec;
+
+
+namespace MarlinUtil {
+
+  MCParticleIndex::MCParticleIndex( const lcio::LCCollection* col ) {
+
+    MCParticleVec particles ;
+    particles.reserve( col->getNumberOfElements() ) ;
+
+    for( int i = 0 ; i < col->getNumberOfElements() ; ++i ) {
+      particles.push_back( static_cast<MCParticle*>( col->getElementAt( i ) ) ) ;
+    }
+
+    build( particles ) ;
+  }
+
+
+  MCParticleIndex::MCParticleIndex( const MCParticleVec& particles ) {
+    build( particles ) ;
+  }
+
+
+  void MCParticleIndex::build( const MCParticleVec& particles ) {
+
+    // ids for the given particles, followed by all particles connected to them
+    _particles.reserve( particles.size() ) ;
+
+    auto add = [this]( MCParticle* mcPart ) {
+      if( mcPart != nullptr && _idOf.emplace( mcPart, _particles.size() ).second ) _particles.push_back( mcPart ) ;
+    } ;
+
+    for( MCParticle* mcPart : particles ) add( mcPart ) ;
+
+    for( unsigned i = 0 ; i < _particles.size() ; ++i ) {
+      for( MCParticle* daughter : _particles[i]->getDaughters() ) add( daughter ) ;
+      for( MCParticle* parent : _particles[i]->getParents() ) add( parent ) ;
+    }
+
+    const int n = _particles.size() ;
+
+    // daughter links by id
+    std::vector<int> daughterBegin( n + 1 ) ;
+    std::vector<int> daughterIds ;
+
+    for( int i = 0 ; i < n ; ++i ) {
+      daughterBegin[i] = daughterIds.size() ;
+      for( MCParticle* daughter : _particles[i]->getDaughters() ) {
+        if( daughter != nullptr ) daughterIds.push_back( _idOf[ daughter ] ) ;
+      }
+    }
+    daughterBegin[n] = daughterIds.size() ;
+
+
+    // iterative depth first traversal - links to a particle that is still on the
+    // stack close a loop and are ignored from here on
+    _preorder.assign( n, -1 ) ;
+    _byPreorder.reserve( n ) ;
+
+    std::vector<int> postorder ;
+    std::vector<int> postNumber( n, -1 ) ;
+    postorder.reserve( n ) ;
+
+    std::vector<char> onStack( n, 0 ) ;
+    std::vector<char> isCycleLink( daughterIds.size(), 0 ) ;
+    std::vector<std::pair<int,int> > stack ;  // id, next daughter link
+
+    auto visit = [&]( int i ) {
+      _preorder[i] = _byPreorder.size() ;
+      _byPreorder.push_back( i ) ;
+      onStack[i] = 1 ;
+      stack.emplace_back( i, daughterBegin[i] ) ;
+    } ;
+
+    auto traverse = [&]( int root ) {
+
+      visit( root ) ;
+
+      while( !stack.empty() ) {
+
+        const int i = stack.back().first ;
+
+        if( stack.back().second == daughterBegin[i+1] ) {
+          onStack[i] = 0 ;
+          postNumber[i] = postorder.size() ;
+          postorder.push_back( i ) ;
+          stack.pop_back() ;
+          continue ;
+        }
+
+        const int link = stack.back().second++ ;
+        const int daughter = daughterIds[link] ;
+
+        if( onStack[daughter] ) {
+          isCycleLink[link] = 1 ;
+          ++_nCycleLinks ;
+        }
+        else if( _preorder[daughter] < 0 ) {
+          visit( daughter ) ;
+        }
+      }
+    } ;
+
+    // start from the particles without parents, anything left over is only reachable through a loop
+    for( int i = 0 ; i < n ; ++i ) {
+      if( _particles[i]->getParents().empty() && _preorder[i] < 0 ) traverse( i ) ;
+    }
+    for( int i = 0 ; i < n ; ++i ) {
+      if( _preorder[i] < 0 ) traverse( i ) ;
+    }
+
+    if( _nCycleLinks != 0 ) {
+      std::cout << "Warning: invalid MC tree found - " << _nCycleLinks << " daughter link(s) forming a loop are ignored" << std::endl ;
+    }
+
+
+    // descendant intervals, in postorder all daughters are done before their parent
+    _intervalBegin.assign( n, 0 ) ;
+    _intervalEnd.assign( n, 0 ) ;
+    _intervals.reserve( n ) ;
+
+    std::vector<Interval> scratch ;
+
+    for( int i : postorder ) {
+
+      scratch.clear() ;
+      scratch.emplace_back( _preorder[i], _preorder[i] ) ;
+
+      for( int link = daughterBegin[i] ; link < daughterBegin[i+1] ; ++link ) {
+        if( isCycleLink[link] ) continue ;
+        const int daughter = daughterIds[link] ;
+        scratch.insert( scratch.end(), _intervals.begin() + _intervalBegin[daughter], _intervals.begin() + _intervalEnd[daughter] ) ;
+      }
+
+      std::sort( scratch.begin(), scratch.end() ) ;
+
+      // merge overlapping and adjacent intervals
+      _intervalBegin[i] = _intervals.size() ;
+      for( const Interval& interval : scratch ) {
+        if( int(_intervals.size()) > _intervalBegin[i] && interval.first <= _intervals.back().second + 1 ) {
+          _intervals.back().second = std::max( _intervals.back().second, interval.second ) ;
+        }
+        else {
+          _intervals.push_back( interval ) ;
+        }
+      }
+      _intervalEnd[i] = _intervals.size() ;
+    }
+
+
+    // first stable or parentless ancestors, in reverse postorder all parents are done
+    // before their daughters - a parent finishing earlier than its daughter is linked via a loop
+    _parentBegin.assign( n, 0 ) ;
+    _parentEnd.assign( n, 0 ) ;
+    _parentIds.reserve( n ) ;
+
+    for( auto it = postorder.rbegin() ; it != postorder.rend() ; ++it ) {
+
+      const int i = *it ;
+      const MCParticleVec& parents = _particles[i]->getParents() ;
+
+      _parentBegin[i] = _parentIds.size() ;
+
+      if( parents.empty() || _particles[i]->getGeneratorStatus() == 1 ) {
+        _parentIds.push_back( i ) ;
+      }
+      else {
+        for( MCParticle* parent : parents ) {
+
+          if( parent == nullptr ) continue ;
+
+          const int p = _idOf[ parent ] ;
+          if( postNumber[p] <= postNumber[i] ) continue ;
+
+          for( int k = _parentBegin[p] ; k < _parentEnd[p] ; ++k ) {
+            const int ancestor = _parentIds[k] ;
+            if( std::find( _parentIds.begin() + _parentBegin[i], _parentIds.end(), ancestor ) == _parentIds.end() ) {
+              _parentIds.push_back( ancestor ) ;
+            }
+          }
+        }
+      }
+
+      _parentEnd[i] = _parentIds.size() ;
+    }
+  }
+
+
+  int MCParticleIndex::id( const MCParticle* mcPart ) const {
+
+    auto it = _idOf.find( mcPart ) ;
+    return it == _idOf.end() ? -1 : it->second ;
+  }
+
+
+  bool MCParticleIndex::isDaughterOf( const MCParticle* daughter, const MCParticle* parent ) const {
+
+    const int d = id( daughter ) ;
+    const int p = id( parent ) ;
+
+    if( d < 0 || p < 0 || d == p ) return false ;
+
+    const int pre = _preorder[d] ;
+    auto first = _intervals.begin() + _intervalBegin[p] ;
+    auto last = _intervals.begin() + _intervalEnd[p] ;
+
+    // a single interval unless there are particles with several parents below the parent
+    if( last - first == 1 ) return first->first <= pre && pre <= first->second ;
+
+    auto it = std::upper_bound( first, last, pre, []( int x, const Interval& interval ) { return x < interval.first ; } ) ;
+    return it != first && pre <= ( it - 1 )->second ;
+  }
+
+
+  MCParticleVec MCParticleIndex::getAllDaughters( const MCParticle* mcPart ) const {
+
+    MCParticleVec result ;
+
+    const int p = id( mcPart ) ;
+    if( p < 0 ) return result ;
+
+    result.push_back( _particles[p] ) ;
+
+    for( int k = _intervalBegin[p] ; k < _intervalEnd[p] ; ++k ) {
+      for( int pre = _intervals[k].first ; pre <= _intervals[k].second ; ++pre ) {
+        if( _byPreorder[pre] != p ) result.push_back( _particles[ _byPreorder[pre] ] ) ;
+      }
+    }
+
+    return result ;
+  }
+
+
+  MCParticleVec MCParticleIndex::getAllParents( const MCParticle* mcPart ) const {
+
+    MCParticleVec result ;
+
+    const int i = id( mcPart ) ;
+    if( i < 0 ) return result ;
+
+    result.reserve( _parentEnd[i] - _parentBegin[i] ) ;
+    for( int k = _parentBegin[i] ; k < _parentEnd[i] ; ++k ) {
+      result.push_back( _particles[ _parentIds[k] ] ) ;
+    }
+
+    return result ;
+  }
+
+}
@@ -1,5 +1,9 @@
 #include "MCTree.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <unordered_map>
+
 
 
 using namespace lcio ;
@@ -457,3 +461,136 @@ string  MCTree::adjust_position1(const  unsigned int& n_blanks){
 }
 
 //=============================================================================
+
+void MCTree::printTree(std::ostream& out, const PrintOptions& options) const {
+
+  if (_col->getTypeName() != LCIO::MCPARTICLE) {
+    out << "Not a MC Collection" << std::endl;
+    return;
+  }
+
+  const int nParticles = _col->getNumberOfElements();
+
+  std::vector<const MCParticle*> particles(nParticles);
+  std::unordered_map<const MCParticle*,int> p2i_map;
+  p2i_map.reserve(nParticles);
+
+  int pdgWidth = 3;
+  for (int k = 0; k < nParticles; ++k) {
+    particles[k] = static_cast<const MCParticle*>(_col->getElementAt(k));
+    p2i_map.emplace(particles[k], k);
+    pdgWidth = std::max(pdgWidth, std::snprintf(nullptr, 0, "%d", particles[k]->getPDG()));
+  }
+  const int indexWidth = std::max(5, std::snprintf(nullptr, 0, "%d", nParticles));
+
+  // output is collected in a buffer of bounded size and written in chunks
+  const size_t flushSize = 1 << 16;
+  std::string buffer;
+  buffer.reserve(flushSize + 1024);
+  std::string indent;
+  char field[256];
+
+  auto append = [&](const char* format, auto... args) {
+    const int n = std::snprintf(field, sizeof(field), format, args...);
+    buffer.append(field, std::min<size_t>(n, sizeof(field) - 1));
+  };
+
+  auto appendInfo = [&](const MCParticle* part) {
+    switch (options.opt) {
+    case 0:
+      append(" | %2d | %d | %d | %d | %d | %d | %d | %d |", part->getGeneratorStatus(),
+             part->isCreatedInSimulation(), part->isBackscatter(), part->vertexIsNotEndpointOfParent(),
+             part->isDecayedInTracker(), part->isDecayedInCalorimeter(), part->hasLeftDetector(), part->isStopped());
+      break;
+    case 1:
+      append(" | %+.5e | %+.5e | %+.5e | %.5e | %.5e |", part->getMomentum()[0], part->getMomentum()[1],
+             part->getMomentum()[2], part->getEnergy(), part->getMass());
+      break;
+    case 2:
+      append(" | %.5e | %.5e |", part->getEnergy(), part->getMass());
+      break;
+    default:
+      break;
+    }
+  };
+
+  out << endl
+      << "------------------------------------------------------------------ "
+      << endl << " Number of  MC particles = " << nParticles << endl;
+
+  append("%*s", indexWidth, "index");
+  switch (options.opt) {
+  case 0: buffer += " | GS |CIS| B |INE| DT| DC| LD| S |"; break;
+  case 1: buffer += " |      Px      |      Py      |      Pz      |    Energy   |     Mass    |"; break;
+  case 2: buffer += " |    Energy   |     Mass    |"; break;
+  default: break;
+  }
+  buffer += "  PDG\n";
+
+  std::vector<char> printed(nParticles, 0);
+  std::vector<std::pair<int,int> > stack;  // index, depth
+  int nPrinted = 0;
+
+  auto traverse = [&](int root) {
+
+    stack.emplace_back(root, 0);
+
+    while (!stack.empty()) {
+
+      const int index = stack.back().first;
+      const int depth = stack.back().second;
+      stack.pop_back();
+
+      const MCParticle* part = particles[index];
+      const MCParticleVec& daughters = part->getDaughters();
+
+      if (indent.size() < size_t(4 * depth)) indent.resize(4 * depth, ' ');
+
+      append("%*d", indexWidth, index);
+      appendInfo(part);
+      buffer += "  ";
+      buffer.append(indent, 0, 4 * depth);
+      if (depth > 0) buffer += "\\-> ";
+      append("%*d", pdgWidth, part->getPDG());
+
+      if (printed[index]) {
+        buffer += " (see above)\n";
+        continue;
+      }
+
+      if (daughters.empty()) buffer += " --+\n";
+      else if (!daughters[0]->vertexIsNotEndpointOfParent()) buffer += " x-->\n";
+      else buffer += " -x +\n";
+
+      printed[index] = 1;
+      ++nPrinted;
+
+      if (buffer.size() > flushSize) {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+      }
+
+      if (options.maxDepth >= 0 && depth >= options.maxDepth) continue;
+
+      // reversed, so that the daughters come out in their original order
+      for (auto it = daughters.rbegin(); it != daughters.rend(); ++it) {
+        auto daughter = p2i_map.find(*it);
+        if (daughter == p2i_map.end() || (*it)->getEnergy() < options.minEnergy) continue;
+        stack.emplace_back(daughter->second, depth + 1);
+      }
+    }
+  };
+
+  // start from all particles without parents in the collection - preserve order
+  for (int index = 0; index < nParticles; ++index) {
+    const MCParticleVec& parents = particles[index]->getParents();
+    const bool isFirst = std::none_of(parents.begin(), parents.end(),
+                                      [&](const MCParticle* parent) { return p2i_map.count(parent) != 0; });
+    if (isFirst && !printed[index] && particles[index]->getEnergy() >= options.minEnergy) traverse(index);
+  }
+
+  out.write(buffer.data(), buffer.size());
+  out << " " << nPrinted << " of " << nParticles << " MC particles printed" << endl;
+}
+
+//=============================================================================
@@ -0,0 +1,58 @@
+#include "MappedRecordFile.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace MarlinUtil {
+
+  MappedRecordFile::MappedRecordFile( const std::string& fileName, const char (&magic)[8], uint32_t version, uint32_t minHeaderSize,
+                                      const std::string& owner, const std::string& kind ) :
+    _fileName( fileName ), _owner( owner ) {
+
+    const int fd = ::open( fileName.c_str(), O_RDONLY ) ;
+    if( fd < 0 ) throw std::runtime_error( owner + ": cannot open " + fileName ) ;
+
+    struct stat info ;
+    if( ::fstat( fd, &info ) != 0 || size_t( info.st_size ) < minHeaderSize ) {
+      ::close( fd ) ;
+      throw std::runtime_error( owner + ": " + fileName + " is not " + kind ) ;
+    }
+
+    _size = info.st_size ;
+    void* data = ::mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0 ) ;
+    ::close( fd ) ;
+
+    if( data == MAP_FAILED ) throw std::runtime_error( owner + ": cannot map " + fileName ) ;
+    _data = static_cast<const char*>( data ) ;
+
+    const auto* fileHeader = reinterpret_cast<const RecordFileHeader*>( _data ) ;
+    if( std::memcmp( fileHeader->magic, magic, sizeof( fileHeader->magic ) ) != 0 || fileHeader->version != version ) {
+      ::munmap( data, _size ) ;
+      throw std::runtime_error( owner + ": " + fileName + " is not " + kind + " of version " + std::to_string( version ) ) ;
+    }
+
+    // the records have to start after the header and stay aligned
+    if( fileHeader->headerSize < minHeaderSize || fileHeader->headerSize % 8 != 0 || fileHeader->headerSize > _size ) {
+      ::munmap( data, _size ) ;
+      _data = nullptr ;
+      corrupt( 0 ) ;
+    }
+    _endOfRecords = fileHeader->headerSize ;
+  }
+
+
+  MappedRecordFile::~MappedRecordFile() {
+    ::munmap( const_cast<char*>( _data ), _size ) ;
+  }
+
+
+  void MappedRecordFile::corrupt( size_t pos ) const {
+    throw std::runtime_error( _owner + ": " + _fileName + " is corrupt at byte " + std::to_string( pos ) ) ;
+  }
+
+}
@@ -10,7 +10,7 @@
 //#include <CLHEP/HepPDT/TempParticleData.hh>
 //#endif
 
-#include "csvparser.h"
+#include "ParticleDataTable.h"
 #include "HelixClass.h"
 
 #include <algorithm>
@@ -96,132 +96,18 @@ void MarlinUtil::printMCParticle(MCParticle* MCP, bool printDaughters) {
 
 std::string MarlinUtil::getMCName(int PDGCode) {
 
+  const MarlinUtil::ParticleData* particle = MarlinUtil::ParticleDataTable::instance().find(PDGCode);
 
-  double mass = 0.0;
-  double errmassp = 0.0;
-  double errmassn = 0.0;
-  double width = 0.0;
-  double errwidthp = 0.0;
-  double errwidthn = 0.0;
-  std::string I("");
-  std::string G("");
-  std::string J("");
-  std::string P("");
-  std::string C("");
-  std::string A("");
-  int PDGCodeRead = 0;
-  std::string Charge("");
-  int R = 0;
-  std::string S("");
-  std::string Name("");
-  std::string Quarks("");
-
-
-
-  std::string Line;
-  
-  std::ifstream FileStream;
-  CSVParser ParseStream;
-  // FIXME: do not always open and close textfile
-  // FIXME: use variable for filename
-  FileStream.open("mass_width_2006.csv");
-  if (!FileStream) {
-    std::cout << "Cannot open 'mass_width_2006.csv'" << std::endl;
-  }
+  if (particle == nullptr) {
 
-  bool endOfFile = false;
-  while (!endOfFile) {
-    
-    endOfFile = FileStream.eof();
-    getline(FileStream, Line); // Get a line
-    if (Line == "") continue;
-    
-    ParseStream << Line; // Feed the line to the ParseStream
-    
-    ParseStream >> mass  >> errmassp  >> errmassn 
-		>> width  >> errwidthp  >> errwidthn 
-		>> I  >> G  >> J  >> P 
-		>> C  >> A  >> PDGCodeRead  >> Charge 
-		>> R  >> S  >> Name  >> Quarks;
-    
-    if (abs(PDGCode) == PDGCodeRead) break;	  
-    
-  };
-  
-  if (endOfFile) {
-    
     std::cout << std::endl << "Cannot find particle with PDG code " << PDGCode 
-	      << " in file 'mass_width_2004.csv'" << std::endl;
-    
-    mass = 0.0;
-    errmassp = 0.0;
-    errmassn = 0.0;
-    width = 0.0;
-    errwidthp = 0.0;
-    errwidthn = 0.0;
-    I = "";
-    G = "";
-    J = "";
-    P = "";
-    C = "";
-    A = "";
-    PDGCodeRead = 0;
-    Charge = "";
-    R = 0;
-    S = "";
-    Name = "unknown";
-    Quarks ="";
-
-  }
-  
-  FileStream.close();
-
-
-  // debug
-  // std::cout << "Name = " << Name << std::endl;
-  
-  if ( (Name == "") || (Name == " ") ) Name = "unknown";
-
-
-  // remove the blanks at the end of Name
-  int blankPosition = Name.find(" ",0);
-  int nameLength = Name.length();
+	      << " in the particle data table" << std::endl;
 
-  // debug
-  // std::cout << "name = " << Name << "  " << "blankPosition = " << blankPosition << "  " << "nameLength = " << nameLength << std::endl;
+    return "unknown";
 
-  if ( blankPosition > 0 )  Name.erase(blankPosition,nameLength-blankPosition);
-
-
-  return Name;
-
-
-
-
-  // FIXME: take information from CLHEP
-  /*
-  const char pdgfile[] = "mass_width_2006.mc";
-  std::ifstream pdfile;
-  pdfile.open( pdgfile );
-  if( !pdfile ) { 
-    std::cerr << "cannot open " << pdgfile << std::endl;
-    return "ERROR opening file";
   }
-  // construct empty PDT
-  DefaultConfig::ParticleDataTable datacol( "PDG Table" );
-  {
-    // Construct table builder
-    HepPDT::TableBuilder  tb(datacol);
-    // read the input - put as many here as you want
-    if( !addPDGParticles( pdfile, tb ) ) { std::cout << "error reading PDG file " << std::endl; }
-  }   // the tb destructor fills datacol
-
-  std::string name = datacol.particle( HepPDT::ParticleID(PDGCode) )->name();
-
-  pdfile.close();
-  
-  return name;
-  */
+
+  return std::string(particle->name);
 
 }
 
@@ -231,37 +117,9 @@ std::string MarlinUtil::getMCName(int PDGCode) {
 
 
 
-int MarlinUtil::getPDGCode(std::string /*name*/) {
-  /*
-  const char pdgfile[] = "mass_width_2004.mc";
-  std::ifstream pdfile;
-  pdfile.open( pdgfile );
-  if( !pdfile ) { 
-    std::cerr << "cannot open " << pdgfile << std::endl;
-    return -1;
-  }
-  // construct empty PDT
-  DefaultConfig::ParticleDataTable datacol( "PDG Table" );
-  {
-    // Construct table builder
-    HepPDT::TableBuilder  tb(datacol);
-    // read the input - put as many here as you want
-    if( !addPDGParticles( pdfile, tb ) ) { std::cout << "error reading PDG file " << std::endl; }
-  }   // the tb destructor fills datacol
-
-
-  int PDGCode = 0;
-
-  DefaultConfig::ParticleData* pp = datacol.particle(name); // FIXME: Not yet implemented in CLHEP
-
-  //  int PDGCode = datacol.particle(name)->pid();
-
-  pdfile.close();
-  
-  return PDGCode;
-  */
+int MarlinUtil::getPDGCode(std::string name) {
 
-  return 0;
+  return MarlinUtil::ParticleDataTable::instance().pdgCode(name);
 
 }
 
@@ -421,6 +279,36 @@ bool MarlinUtil::isDaughterOf( MCParticle* daughter, MCParticle* parent )  {
 // ____________________________________________________________________________________________________
 
 
+MCParticleVec MarlinUtil::getAllMCParents( MCParticle* mcPart, const MCParticleIndex& index )  {
+
+  if ( !index.contains( mcPart ) ) return getAllMCParents( mcPart );
+
+  return index.getAllParents( mcPart );
+
+}
+
+
+MCParticleVec MarlinUtil::getAllMCDaughters( MCParticle* mcPart, const MCParticleIndex& index )  {
+
+  if ( !index.contains( mcPart ) ) return getAllMCDaughters( mcPart );
+
+  return index.getAllDaughters( mcPart );
+
+}
+
+
+bool MarlinUtil::isDaughterOf( MCParticle* daughter, MCParticle* parent, const MCParticleIndex& index )  {
+
+  if ( !index.contains( daughter ) || !index.contains( parent ) ) return isDaughterOf( daughter, parent );
+
+  return index.isDaughterOf( daughter, parent );
+
+}
+
+
+// ____________________________________________________________________________________________________
+
+
 bool MarlinUtil::DecayChainInTree(std::vector<int> /*DecayChannel*/, LCEvent* evt)
 {
 
@@ -554,261 +442,66 @@ void MarlinUtil::getMC_Balance(LCEvent * evt, double* accumulatedEnergies){
 //============================================================================
   //FIXME : boundery check for the array accumulatedEnergies is needed, or a different data exchange
 
-  int idpdg;
-  const double* mom;
-  float enr;
-  //double mass;
+  // one engine per thread, its scratch arrays are reused for every event
+  static thread_local MCBalance balance( MCBalance::legacyCategories() ) ;
 
-  // FIXME : hard coded name of MC Collection (this is the convention)
-  std::string colNameMC("MCParticle");
-  
   try {
 
-    LCCollection* mcpCol = evt->getCollection(colNameMC);
-    
-        //-----------------------------------------------------------------------
-    // Calculate balance at IP taking into account everything
-    //-----------------------------------------------------------------------
-    double px,py,pz,pt,ttet;
-    
-    double e_to_tube  = 0.;
-    double e_to_tubex = 0.;
-    double e_to_tubey = 0.;
-    double e_to_tubez = 0.;
-    int    n_to_tube = 0; 
-    
-    double e_neutr = 0.;   
-    double e_neutrx= 0.;   
-    double e_neutry= 0.;   
-    double e_neutrz= 0.;   
-    int    n_neutr= 0;    
-    
-    double e_muon = 0.;  
-    double e_muonx= 0.;  
-    double e_muony= 0.;  
-    double e_muonz= 0.;  
-    int    n_muon= 0;   
-    
-    double e_elect = 0.; 
-    double e_electx= 0.; 
-    double e_electy= 0.; 
-    double e_electz= 0.; 
-    int    n_elect= 0;  
-    
-    double e_photon = 0.;
-    double e_photonx= 0.;
-    double e_photony= 0.;
-    double e_photonz= 0.;
-    int    n_photon= 0; 
-    
-    double e_pi0 = 0.;
-    double e_pi0x= 0.;
-    double e_pi0y= 0.;
-    double e_pi0z= 0.;
-    int    n_pi0= 0; 
-    
-    double e_llhadr = 0.;
-    double e_llhadrx= 0.;
-    double e_llhadry= 0.;
-    double e_llhadrz= 0.;
-    int    n_llhadr= 0; 
-    
-    double e_slhadr = 0.;
-    double e_slhadrx= 0.;
-    double e_slhadry= 0.;
-    double e_slhadrz= 0.;
-    int    n_slhadr= 0; 
-    
-    double e_chadr = 0.; 
-    double e_chadrx= 0.; 
-    double e_chadry= 0.; 
-    double e_chadrz= 0.; 
-    int    n_chadr= 0;  
-
-    for(int i=0; i<mcpCol->getNumberOfElements() ; i++){
-      MCParticle* imc = dynamic_cast<MCParticle*> ( mcpCol->getElementAt( i ) ) ;
-      idpdg = imc-> getPDG (); 
-      mom = imc-> getMomentum (); 
-      enr = imc-> getEnergy (); 
-      //mass = imc-> getMass ();
-      if( imc-> getGeneratorStatus() == 1) { // stable particles only   
-	px = mom[0]; 
-	py = mom[1]; 
-	pz = mom[2];
-	pt = hypot(px,py);
-	ttet = atan2(pt,pz);
-	//FIXME : Hard coded cut. Use GEAR instead
-	if ((fabs(ttet) < 0.1) || (fabs(M_PI-ttet) < 0.1)) {
-	  e_to_tube  += enr;
-	  e_to_tubex += px;
-	  e_to_tubey += py;
-	  e_to_tubez += pz;
-	  n_to_tube ++;
-	  continue;
-	} 
-	if((abs(idpdg)==12)||(abs(idpdg)==14)||(abs(idpdg)==16)) {
-	  e_neutr  += enr;
-	  e_neutrx += px;
-	  e_neutry += py;
-	  e_neutrz += pz;
-	  n_neutr ++;
-	  continue;
-	} 
-	if(abs(idpdg)==13) { // mu+ mu- 
-	  e_muon  += enr;
-	  e_muonx += px;
-	  e_muony += py;
-	  e_muonz += pz;
-	  n_muon ++;
-	  continue;
-	} 
-	if(abs(idpdg)==11) { //  e+ e-
-	  e_elect  += enr;
-	  e_electx += px;
-	  e_electy += py;
-	  e_electz += pz;
-	  n_elect ++;
-	  continue;
-	} 
-	if(idpdg == 111) { // Pi0 as stable 
-	  e_pi0  += enr;
-	  e_pi0x += px;
-	  e_pi0y += py;
-	  e_pi0z += pz;
-	  n_pi0 ++;
-	  continue;
-	} 
-	if(idpdg == 22) { // photon
-	  e_photon  += enr;
-	  e_photonx += px;
-	  e_photony += py;
-	  e_photonz += pz;
-	  n_photon ++;
-	  continue;
-	} 
-	if(    // long lived neutral hadrons
-	   (abs(idpdg)==2112)|| // neutron
-	   (abs(idpdg)== 130)   // KoL
-	   ) {                     
-	  e_llhadr  += enr;
-	  e_llhadrx += px;
-	  e_llhadry += py;
-	  e_llhadrz += pz;
-	  n_llhadr ++;
-	  continue;
-	}
-	if(  // short lived neutral hadrons
-	   (abs(idpdg)== 310)|| // KoS
-	   (abs(idpdg)==3122)|| // Lambda0
-	   (abs(idpdg)==3212)|| // Sigma0
-	   (abs(idpdg)==3322)   // Xi0
-	   ) {
-	  e_slhadr  += enr;
-	  e_slhadrx += px;
-	  e_slhadry += py;
-	  e_slhadrz += pz;
-	  n_slhadr ++;
-	  continue;
-	}
-	if(!(abs(idpdg)==12) && !(abs(idpdg)==14) && !(abs(idpdg)==16) &&  // neutrinos   
-	   !(abs(idpdg)==13) && // mu+ mu- 
-	   !(abs(idpdg)==11) && //  e+ e-
-	   !(idpdg == 111) && // Pi0
-	   !(idpdg == 22) &&  // photon
-	   !(abs(idpdg)==2112) && !(abs(idpdg)== 311) && // neutral hadrons
-	   !(abs(idpdg)== 130) && !(abs(idpdg)== 310) && // neutral hadrons
-	   !(abs(idpdg)==3122) && !(abs(idpdg)==3212) && !(abs(idpdg)==3322) ) { // neutral hadrons
-	  e_chadr  += enr;
-	  e_chadrx += px;
-	  e_chadry += py;
-	  e_chadrz += pz;
-	  n_chadr ++;
-	  continue;
-	}
-	std::cout <<" Unknow for this program  ID is " <<idpdg<< std::endl;
-      }    // Stable particles only
-    }      // End for for MCParticles 
-
-
-    double e_sum = e_elect+e_muon+e_chadr+e_pi0+e_photon+e_llhadr+e_slhadr+e_neutr;
-    int n_sum =  n_elect+n_muon+n_chadr+n_pi0+n_photon+n_llhadr+n_slhadr+n_neutr;
+    const MCEnergyBalance b = getMCEnergyBalance( evt, balance ) ;
 
-    double evt_energy = e_sum;
-    int n_evt = n_sum;
+    for( int idpdg : b.unclassifiedPDGCodes ) std::cout <<" Unknow for this program  ID is " <<idpdg<< std::endl;
 
-    //   Minus muon loosed energy = 1.6 GeV in average, i.e. Muons deposit 1.6 GeV an average in Calorimeter
-    double e_mu_lost = e_muon  - n_muon*1.6;
-    double e_lost = e_neutr + e_mu_lost + e_to_tube;
-    int n_lost = n_neutr + n_to_tube;
-
-    double e_real = evt_energy - e_lost;
-    int n_real = n_evt - n_lost;
-
-    if (e_real< 0.0) e_real = 0.000001;
-    if (n_real < 0)  n_real = 0;
-
-      
 	 std::cout <<" =============================================================="<< std::endl;
 	 std::cout << " ========   Record Balance  ======="<< std::endl ;
 	 std::cout <<" =============================================================="<< std::endl;
 	 std::cout <<" ==============  Possible lost  ==================="<< std::endl;
-	 std::cout <<"  Neutrino energy      = "<<e_neutr<<",  in "<< n_neutr<<" neutrinos"<< std::endl;
-	 std::cout <<"  Energy to beam tube  = "<<e_to_tube<<",  in "<<n_to_tube<<" particles"<< std::endl;
-	 std::cout <<"  Muons energy lost    = "<<e_mu_lost<<"  in "<<n_muon<<" muons"<< std::endl;
+	 std::cout <<"  Neutrino energy      = "<<b.neutrinoEnergy<<",  in "<< b.nNeutrinos<<" neutrinos"<< std::endl;
+	 std::cout <<"  Energy to beam tube  = "<<b.beamTubeEnergy<<",  in "<<b.nBeamTube<<" particles"<< std::endl;
+	 std::cout <<"  Muons energy lost    = "<<b.muonEnergyLost<<"  in "<<b.nMuons<<" muons"<< std::endl;
 	 std::cout <<"  --------------------------------------------------"<< std::endl;
-	 std::cout <<"  Total Event energy at IP = "<<evt_energy<<" [GeV]"<< std::endl;
+	 std::cout <<"  Total Event energy at IP = "<<b.totalEnergy<<" [GeV]"<< std::endl;
 	 std::cout <<"  --------------------------------------------------"<< std::endl;
-	 std::cout <<"  Whole lost Energy        = "<<e_lost<< std::endl;
-	 std::cout <<"  Available Energy in calo.= "<<e_real<< std::endl;
+	 std::cout <<"  Whole lost Energy        = "<<b.lostEnergy<< std::endl;
+	 std::cout <<"  Available Energy in calo.= "<<b.measurableEnergy<< std::endl;
 	 std::cout <<" =============================================================="<< std::endl;
-	 std::cout <<"  Muon energy               = "<<e_muon  <<'\t'<<"  in "<< n_muon  <<" muons"<< std::endl;
-	 std::cout <<"  Electron energy           = "<<e_elect <<'\t'<<"  in "<< n_elect <<" electrons"<< std::endl;
-	 std::cout <<"  Charged hadron energy     = "<<e_chadr <<'\t'<<"  in "<< n_chadr <<" hadrons"<< std::endl;
+	 std::cout <<"  Muon energy               = "<<b.muonEnergy  <<'\t'<<"  in "<< b.nMuons  <<" muons"<< std::endl;
+	 std::cout <<"  Electron energy           = "<<b.electronEnergy <<'\t'<<"  in "<< b.nElectrons <<" electrons"<< std::endl;
+	 std::cout <<"  Charged hadron energy     = "<<b.chargedHadronEnergy <<'\t'<<"  in "<< b.nChargedHadrons <<" hadrons"<< std::endl;
 	 std::cout <<"  -------------------------------------------------------------"<< std::endl;
-	 std::cout <<"  Pi0 energy (if stable)    = "<<e_pi0   <<'\t'<<"  in "<< n_pi0   <<" Pi zeros"<< std::endl;
-	 std::cout <<"  Photon energy             = "<<e_photon<<'\t'<<"  in "<< n_photon<<" photons"<< std::endl;
+	 std::cout <<"  Pi0 energy (if stable)    = "<<b.pi0Energy   <<'\t'<<"  in "<< b.nPi0s   <<" Pi zeros"<< std::endl;
+	 std::cout <<"  Photon energy             = "<<b.photonEnergy<<'\t'<<"  in "<< b.nPhotons<<" photons"<< std::endl;
 	 std::cout <<"  -------------------------------------------------------------"<< std::endl;
-	 std::cout <<"  Long lived hadron energy  = "<<e_llhadr<<'\t'<<"  in "<< n_llhadr<<" hadrons"<< std::endl;
-	 std::cout <<"  Short lived hadron energy = "<<e_slhadr<<'\t'<<"  in "<< n_slhadr<<" hadrons"<< std::endl;
+	 std::cout <<"  Long lived hadron energy  = "<<b.longLivedNeutralHadronEnergy<<'\t'<<"  in "<< b.nLongLivedNeutralHadrons<<" hadrons"<< std::endl;
+	 std::cout <<"  Short lived hadron energy = "<<b.shortLivedNeutralHadronEnergy<<'\t'<<"  in "<< b.nShortLivedNeutralHadrons<<" hadrons"<< std::endl;
 	 std::cout <<" =============================================================="<< std::endl;
-    
-    
-
-    accumulatedEnergies[0]  = e_real;
-    accumulatedEnergies[1]  = e_to_tube;
-    accumulatedEnergies[2]  = e_neutr;
-    accumulatedEnergies[3]  = e_elect;
-    accumulatedEnergies[4]  = e_muon;
-    accumulatedEnergies[5]  = e_photon;
-    accumulatedEnergies[6]  = e_pi0;
-    accumulatedEnergies[7]  = e_llhadr;
-    accumulatedEnergies[8]  = e_slhadr;
-    accumulatedEnergies[9]  = e_chadr;
-    accumulatedEnergies[10] = n_real;
-    accumulatedEnergies[11] = n_to_tube;
-    accumulatedEnergies[12] = n_neutr;
-    accumulatedEnergies[13] = n_elect;
-    accumulatedEnergies[14] = n_muon;
-    accumulatedEnergies[15] = n_photon;
-    accumulatedEnergies[16] = n_pi0;
-    accumulatedEnergies[17] = n_llhadr;
-    accumulatedEnergies[18] = n_slhadr;
-    accumulatedEnergies[19] = n_chadr;
-    accumulatedEnergies[20] = evt_energy - e_neutr - e_to_tube;
-
-
-
 
+    accumulatedEnergies[0]  = b.measurableEnergy;
+    accumulatedEnergies[1]  = b.beamTubeEnergy;
+    accumulatedEnergies[2]  = b.neutrinoEnergy;
+    accumulatedEnergies[3]  = b.electronEnergy;
+    accumulatedEnergies[4]  = b.muonEnergy;
+    accumulatedEnergies[5]  = b.photonEnergy;
+    accumulatedEnergies[6]  = b.pi0Energy;
+    accumulatedEnergies[7]  = b.longLivedNeutralHadronEnergy;
+    accumulatedEnergies[8]  = b.shortLivedNeutralHadronEnergy;
+    accumulatedEnergies[9]  = b.chargedHadronEnergy;
+    accumulatedEnergies[10] = b.nMeasurable;
+    accumulatedEnergies[11] = b.nBeamTube;
+    accumulatedEnergies[12] = b.nNeutrinos;
+    accumulatedEnergies[13] = b.nElectrons;
+    accumulatedEnergies[14] = b.nMuons;
+    accumulatedEnergies[15] = b.nPhotons;
+    accumulatedEnergies[16] = b.nPi0s;
+    accumulatedEnergies[17] = b.nLongLivedNeutralHadrons;
+    accumulatedEnergies[18] = b.nShortLivedNeutralHadrons;
+    accumulatedEnergies[19] = b.nChargedHadrons;
+    accumulatedEnergies[20] = b.visibleEnergy;
 
-
-    
   }
   catch(DataNotAvailableException &e){
     std::cout << "Cannot find MC Particle Collection in event "
 	      << evt->getEventNumber () << std::endl ;
   };
-  
-
 
  } // End  MC_Balance
 
@@ -1049,6 +742,13 @@ int MarlinUtil::countAllSimTrackerHits(LCEvent* evt,MCParticle* MCP) {
 }
 
 
+int MarlinUtil::countAllSimTrackerHits(const SimHitIndex& index,MCParticle* MCP) {
+
+  return index.getSimTrackerHits(MCP).size();
+
+}
+
+
 
 // ____________________________________________________________________________________________________
 
@@ -1097,6 +797,15 @@ int MarlinUtil::countAllSimCalorimeterHits(LCEvent* evt,MCParticle* MCP,double&
 }
 
 
+int MarlinUtil::countAllSimCalorimeterHits(const SimHitIndex& index,MCParticle* MCP,double& accumulatedSimCaloEnergy) {
+
+  accumulatedSimCaloEnergy = index.getSimCalorimeterEnergy(MCP);
+
+  return index.getCaloContributions(MCP).size();
+
+}
+
+
 
 // ____________________________________________________________________________________________________
 
@@ -1134,178 +843,53 @@ double MarlinUtil::getEnergyDepositedInFullCalorimeter(LCEvent* evt) {
 }
 
 
+double MarlinUtil::getEnergyDepositedInFullCalorimeter(const SimHitIndex& index) {
 
-// ____________________________________________________________________________________________________
-// ____________________________________________________________________________________________________
-
-
+  return index.getCalorimeterEnergy();
 
+}
 
 
-MCParticleHelper::MCParticleHelper() {
-
-
-  _pdgCodesMCParticles.clear();
-  _massMCParticles.clear();
-  _nameMCParticles.clear();
-  _chargeMCParticles.clear();
-
-
-  double mass = 0.0;
-  double errmassp = 0.0;
-  double errmassn = 0.0;
-  double width = 0.0;
-  double errwidthp = 0.0;
-  double errwidthn = 0.0;
-  std::string I("");
-  std::string G("");
-  std::string J("");
-  std::string P("");
-  std::string C("");
-  std::string A("");
-  int PDGCodeRead = 0;
-  std::string Charge("");
-  int R = 0;
-  std::string S("");
-  std::string Name("");
-  std::string Quarks("");
-  
-  
-
-  std::string Line;
-  
-  std::ifstream FileStream;
-  CSVParser ParseStream;
-  // FIXME: do not always open and close textfile
-  // FIXME: use variable for filename
-  FileStream.open("mass_width_2006.csv");
-  if (!FileStream) {
-    std::cout << "Cannot open 'mass_width_2006.csv'" << std::endl;
-  }
-
-  bool endOfFile = false;
-  unsigned int numberOfLines = 0;
-
-  while (!endOfFile) {
-    
-    endOfFile = FileStream.eof();
-    getline(FileStream, Line); // Get a line
-    if (Line == "") continue;
-    
-    ParseStream << Line; // Feed the line to the ParseStream
-    
-    ParseStream >> mass  >> errmassp  >> errmassn 
-		>> width  >> errwidthp  >> errwidthn 
-		>> I  >> G  >> J  >> P 
-		>> C  >> A  >> PDGCodeRead  >> Charge 
-		>> R  >> S  >> Name  >> Quarks;
-
-    if ( ( (P != "+") && (P != "-") && (P != "?") && (P != "") ) || (Charge.length() == 0) ) continue;
-
-    ++numberOfLines;
 
-     // debug
-    /*
-    std::cout << "m: " << mass << "  " << "Em: " << errmassp << "|" << errmassn << "  " << "width: " << width << "  " << "Ew: " << errwidthp << "|" << errwidthn << "  " 
-	      << "I: " << I << "  " << "G: " << G << "  " << "J: " << J << "  " << "P: " << P << "  " << "C: " << C << "  " << "A: " << A << "  " << "PDG: " << PDGCodeRead 
-	      << "  " << "Q: " << Charge << "  " << "R: " << R << "  " << "S: " << S << "  " << Name << "  " << Quarks << "  " << Charge.length() << std::endl;
-    */
+// ____________________________________________________________________________________________________
+// ____________________________________________________________________________________________________
 
 
-    if ( (Name == "") || (Name == " ") ) Name = "unknown";
 
 
-    // remove the blanks at the end of Name
-    int blankPosition = Name.find(" ",0);
-    int nameLength = Name.length();
 
-    // debug
-    // std::cout << "name = " << Name << "  " << "blankPosition = " << blankPosition << "  " << "nameLength = " << nameLength << std::endl;
-    
-    if ( blankPosition > 0 )  Name.erase(blankPosition,nameLength-blankPosition);
+MCParticleHelper::MCParticleHelper() {
+}
 
-    _pdgCodesMCParticles.push_back(PDGCodeRead);
-    _massMCParticles.push_back(mass);
-    _nameMCParticles.push_back(Name);
-    _chargeMCParticles.push_back(Charge);
-    
-  };
-  
-  FileStream.close();
 
-  // debug
-  //  std::cout << "numberOfLines: " << numberOfLines << std::endl;
+std::string MCParticleHelper::getMCCharge(int PDGCode) {  
 
+  const MarlinUtil::ParticleData* particle = MarlinUtil::ParticleDataTable::find(PDGCode);
 
+  if ( particle == nullptr ) return "";
 
+  if ( PDGCode < 0 ) return MarlinUtil::ParticleDataTable::antiCharge(particle->charge);
 
+  return std::string(particle->charge);
 
-  // FIXME: take information from CLHEP
-  /*
-  const char pdgfile[] = "mass_width_2006.mc";
-  std::ifstream pdfile;
-  pdfile.open( pdgfile );
-  if( !pdfile ) { 
-    std::cerr << "cannot open " << pdgfile << std::endl;
-    return "ERROR opening file";
-  }
-  // construct empty PDT
-  DefaultConfig::ParticleDataTable datacol( "PDG Table" );
-  {
-    // Construct table builder
-    HepPDT::TableBuilder  tb(datacol);
-    // read the input - put as many here as you want
-    if( !addPDGParticles( pdfile, tb ) ) { std::cout << "error reading PDG file " << std::endl; }
-  }   // the tb destructor fills datacol
-
-  std::string name = datacol.particle( HepPDT::ParticleID(PDGCode) )->name();
-
-  pdfile.close();
-  
-  */
-
-
-  
 }
 
 
-std::string MCParticleHelper::getMCCharge(int PDGCode) {  
-
-
-  std::vector<int>::const_iterator position = find(_pdgCodesMCParticles.begin(),_pdgCodesMCParticles.end(),abs(PDGCode)); 
-
-
-  if ( position == _pdgCodesMCParticles.end() ) {
-    
-    std::string returnValue("");
-    return returnValue;
+double MCParticleHelper::getMCMass(int PDGCode) {
 
-  }    
-  else {
+  const MarlinUtil::ParticleData* particle = MarlinUtil::ParticleDataTable::find(PDGCode);
 
-    int index = position - _pdgCodesMCParticles.begin();
+  return particle == nullptr ? 0.0 : particle->mass;
 
-    std::string chargeString = _chargeMCParticles.at(index);
-    
-    if ( PDGCode < 0 ) {
-      
-      if ( (chargeString.length() > 0) && (chargeString.at(0) == '-') ) chargeString.replace(0,1,"+");
-      else if ( (chargeString.length() > 0) && (chargeString.at(0) == '+') ) chargeString.replace(0,1,"-");
-      
-      // special cases of ++ and -- particles
-      else if ( (chargeString.length() > 1) && (chargeString.at(0) == '-') && (chargeString.at(1) == '-') ) chargeString.replace(0,2,"++"); 
-      else if ( (chargeString.length() > 1) && (chargeString.at(0) == '+') && (chargeString.at(1) == '+') ) chargeString.replace(0,2,"--"); 
+}
 
-      else { } // charge is 0, do nothing
-      
 
-    }
+std::string MCParticleHelper::getMCName(int PDGCode) {
 
+  const MarlinUtil::ParticleData* particle = MarlinUtil::ParticleDataTable::find(PDGCode);
 
-    return chargeString;
+  return particle == nullptr ? "unknown" : std::string(particle->name);
 
-  }
-  
 }
 
 
@@ -0,0 +1,104 @@
+#include "ParticleDataTable.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace MarlinUtil {
+
+  namespace {
+
+    // generated from mass_width_2006.csv at build time, see cmake/GenerateParticleTable.cmake
+    constexpr ParticleData particleTable[] = {
+#include "MarlinUtilParticleTable.inc"
+    } ;
+
+    constexpr unsigned particleTableSize = sizeof( particleTable ) / sizeof( particleTable[0] ) ;
+
+    constexpr bool isSortedByCode() {
+      for( unsigned i = 1 ; i < particleTableSize ; ++i ) {
+        if( particleTable[i-1].pdgCode >= particleTable[i].pdgCode ) return false ;
+      }
+      return true ;
+    }
+
+    static_assert( isSortedByCode(), "particle table has to be sorted by unique PDG codes" ) ;
+
+  }
+
+
+  const ParticleDataTable& ParticleDataTable::instance() {
+    // initialisation of function statics is thread safe
+    static const ParticleDataTable table ;
+    return table ;
+  }
+
+
+  ParticleDataTable::ParticleDataTable() {
+    _codeByName.reserve( 4 * particleTableSize ) ;
+    for( const auto& particle : particleTable ) addNames( particle ) ;
+  }
+
+
+  const ParticleData* ParticleDataTable::find( int pdgCode ) {
+
+    const int code = std::abs( pdgCode ) ;
+    const ParticleData* it = std::lower_bound( begin(), end(), code,
+                                               []( const ParticleData& p, int c ) { return p.pdgCode < c ; } ) ;
+
+    return ( it != end() && it->pdgCode == code ) ? it : nullptr ;
+  }
+
+
+  int ParticleDataTable::pdgCode( const std::string& name ) const {
+
+    auto it = _codeByName.find( name ) ;
+    return it == _codeByName.end() ? 0 : it->second ;
+  }
+
+
+  const ParticleData* ParticleDataTable::begin() {
+    return particleTable ;
+  }
+
+
+  const ParticleData* ParticleDataTable::end() {
+    return particleTable + particleTableSize ;
+  }
+
+
+  unsigned ParticleDataTable::size() {
+    return particleTableSize ;
+  }
+
+
+  std::string ParticleDataTable::antiCharge( std::string_view charge ) {
+
+    std::string anti( charge ) ;
+    for( auto& c : anti ) {
+      if( c == '+' ) c = '-' ;
+      else if( c == '-' ) c = '+' ;
+    }
+    return anti ;
+  }
+
+
+  void ParticleDataTable::addNames( const ParticleData& particle ) {
+
+    const std::string name( particle.name ) ;
+    const std::string charge( particle.charge ) ;
+
+    // names are not unique - the entry with the lowest PDG code is used
+    _codeByName.emplace( name, particle.pdgCode ) ;
+    _codeByName.emplace( name + charge, particle.pdgCode ) ;
+
+    // antiparticle names according to the flag A of the PDG table
+    if( particle.antiFlag == 'B' ) {
+      _codeByName.emplace( name + antiCharge( charge ), -particle.pdgCode ) ;
+    }
+    else if( particle.antiFlag == 'F' ) {
+      _codeByName.emplace( name + "bar", -particle.pdgCode ) ;
+      _codeByName.emplace( name + "bar" + antiCharge( charge ), -particle.pdgCode ) ;
+    }
+  }
+
+}
@@ -0,0 +1,61 @@
+#include "RelationNavigatorCache.h"
+
+using lcio::LCCollection;
+using UTIL::LCRelationNavigator;
+
+
+namespace MarlinUtil {
+
+  RelationNavigatorCache& RelationNavigatorCache::forEvent( const lcio::LCEvent* evt ) {
+
+    thread_local RelationNavigatorCache cache ;
+
+    // the same address can be reused for the next event, so the numbers are compared as well
+    if( cache._evt != evt || cache._runNumber != evt->getRunNumber() || cache._eventNumber != evt->getEventNumber() ) {
+      cache.clear() ;
+      cache._evt = evt ;
+      cache._runNumber = evt->getRunNumber() ;
+      cache._eventNumber = evt->getEventNumber() ;
+    }
+
+    return cache ;
+  }
+
+
+  const LCRelationNavigator& RelationNavigatorCache::get( const std::string& collectionName ) {
+    return navigator( collectionName, _evt->getCollection( collectionName ) ) ;
+  }
+
+
+  const LCRelationNavigator* RelationNavigatorCache::find( const std::string& collectionName ) {
+
+    const LCCollection* col = nullptr ;
+    try {
+      col = _evt->getCollection( collectionName ) ;
+    }
+    catch( lcio::DataNotAvailableException& ) {
+      return nullptr ;
+    }
+
+    return &navigator( collectionName, col ) ;
+  }
+
+
+  void RelationNavigatorCache::clear() {
+    _navigators.clear() ;
+  }
+
+
+  const LCRelationNavigator& RelationNavigatorCache::navigator( const std::string& collectionName, const LCCollection* col ) {
+
+    Entry& entry = _navigators[ collectionName ] ;
+
+    if( entry.collection != col || !entry.navigator ) {
+      entry.navigator.reset( new LCRelationNavigator( col ) ) ;
+      entry.collection = col ;
+    }
+
+    return *entry.navigator ;
+  }
+
+}
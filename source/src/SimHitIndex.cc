@@ -0,0 +1,77 @@
+#include "SimHitIndex.h"
+
+#include <EVENT/CalorimeterHit.h>
+#include <EVENT/LCCollection.h>
+
+using lcio::CalorimeterHit;
+using lcio::LCCollection;
+using lcio::MCParticle;
+using lcio::SimCalorimeterHit;
+using lcio::SimTrackerHit;
+
+
+namespace MarlinUtil {
+
+  SimHitIndex::SimHitIndex( const lcio::LCEvent* evt ) {
+
+    for( const std::string& name : *evt->getCollectionNames() ) {
+
+      const LCCollection* col = evt->getCollection( name ) ;
+      const std::string& type = col->getTypeName() ;
+      const int n = col->getNumberOfElements() ;
+
+      if( type == lcio::LCIO::SIMTRACKERHIT ) {
+        for( int i = 0 ; i < n ; ++i ) {
+          SimTrackerHit* hit = static_cast<SimTrackerHit*>( col->getElementAt( i ) ) ;
+          _entries[ hit->getMCParticle() ].trackerHits.push_back( hit ) ;
+        }
+      }
+      else if( type == lcio::LCIO::SIMCALORIMETERHIT ) {
+        for( int i = 0 ; i < n ; ++i ) {
+          SimCalorimeterHit* hit = static_cast<SimCalorimeterHit*>( col->getElementAt( i ) ) ;
+          for( int j = 0 ; j < hit->getNMCContributions() ; ++j ) {
+            Entry& entry = _entries[ hit->getParticleCont( j ) ] ;
+            entry.caloContributions.push_back( { hit, j } ) ;
+            entry.simCaloEnergy += hit->getEnergyCont( j ) ;
+          }
+        }
+      }
+      else if( type == lcio::LCIO::CALORIMETERHIT ) {
+        for( int i = 0 ; i < n ; ++i ) {
+          _caloEnergy += static_cast<CalorimeterHit*>( col->getElementAt( i ) )->getEnergy() ;
+        }
+      }
+    }
+  }
+
+
+  const SimHitIndex::Entry* SimHitIndex::find( const MCParticle* mcPart ) const {
+
+    auto it = _entries.find( mcPart ) ;
+    return it == _entries.end() ? nullptr : &it->second ;
+  }
+
+
+  const std::vector<SimTrackerHit*>& SimHitIndex::getSimTrackerHits( const MCParticle* mcPart ) const {
+
+    static const std::vector<SimTrackerHit*> none ;
+    const Entry* entry = find( mcPart ) ;
+    return entry == nullptr ? none : entry->trackerHits ;
+  }
+
+
+  const std::vector<SimHitIndex::CaloContribution>& SimHitIndex::getCaloContributions( const MCParticle* mcPart ) const {
+
+    static const std::vector<CaloContribution> none ;
+    const Entry* entry = find( mcPart ) ;
+    return entry == nullptr ? none : entry->caloContributions ;
+  }
+
+
+  double SimHitIndex::getSimCalorimeterEnergy( const MCParticle* mcPart ) const {
+
+    const Entry* entry = find( mcPart ) ;
+    return entry == nullptr ? 0.0 : entry->simCaloEnergy ;
+  }
+
+}
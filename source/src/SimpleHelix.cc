@@ -67,8 +67,11 @@ double SimpleHelix::getWindingLength() const
   return 2*_pi*sqrt(1+_tanLambda*_tanLambda)/fabs(_omega);
 }
 
-LCVector3D SimpleHelix::getPosition(double s, LCErrorMatrix* /*errors*/) const
+LCVector3D SimpleHelix::getPosition(double s, LCErrorMatrix* errors) const
 {
+  if( errors != NULL )
+    *errors = _errors.similarity( getPositionJacobian(s) ) ;
+
   LCVector3D x;
 
   double xc = getCentreX();
@@ -84,8 +87,11 @@ LCVector3D SimpleHelix::getPosition(double s, LCErrorMatrix* /*errors*/) const
   return x;
 }
 
-LCVector3D SimpleHelix::getDirection(double s,  LCErrorMatrix* /*errors*/) const
+LCVector3D SimpleHelix::getDirection(double s,  LCErrorMatrix* errors) const
 {
+  if( errors != NULL )
+    *errors = _errors.similarity( getDirectionJacobian(s) ) ;
+
   LCVector3D t;
 
   double varphi0 = _phi0 + ((_omega * _pi) / (2*fabs(_omega)));
@@ -98,9 +104,178 @@ LCVector3D SimpleHelix::getDirection(double s,  LCErrorMatrix* /*errors*/) const
   return t.unit();
 }
 
-LCErrorMatrix SimpleHelix::getCovarianceMatrix( double /*s*/) const
+LCErrorMatrix SimpleHelix::getCovarianceMatrix( double s) const
+{
+  return _errors.similarity( getJacobian(s) ) ;
+}
+
+// The position along the helix can be written with the transverse path
+// length st = s*cosLambda and the local azimuth phi = phi0 - omega*st as
+//   x = xr + (1/omega - d0) sin(phi0) - sin(phi)/omega
+//   y = yr - (1/omega - d0) cos(phi0) + cos(phi)/omega
+//   z = zr + z0 + s*sinLambda
+// which is what the derivatives below are taken of.
+
+CLHEP::HepMatrix SimpleHelix::getPositionJacobian( double s ) const
+{
+  CLHEP::HepMatrix J( 3 , 5 , 0 ) ;
+
+  double cosLambda = 1./sqrt(1 + _tanLambda*_tanLambda) ;
+  double cosLambda3 = cosLambda*cosLambda*cosLambda ;
+  double rho = 1./_omega ;
+  double phi = _phi0 - _omega * s * cosLambda ;
+
+  double sinPhi0 = sin(_phi0) , cosPhi0 = cos(_phi0) ;
+  double sinPhi  = sin(phi)   , cosPhi  = cos(phi) ;
+
+  // d0
+  J[0][0] = -sinPhi0 ;
+  J[1][0] =  cosPhi0 ;
+  // phi0
+  J[0][1] = (rho - _d0) * cosPhi0 - rho * cosPhi ;
+  J[1][1] = (rho - _d0) * sinPhi0 - rho * sinPhi ;
+  // omega
+  J[0][2] = rho*rho * (sinPhi - sinPhi0) + rho * s * cosLambda * cosPhi ;
+  J[1][2] = rho*rho * (cosPhi0 - cosPhi) + rho * s * cosLambda * sinPhi ;
+  // z0
+  J[2][3] = 1. ;
+  // tanLambda
+  J[0][4] = -s * _tanLambda * cosLambda3 * cosPhi ;
+  J[1][4] = -s * _tanLambda * cosLambda3 * sinPhi ;
+  J[2][4] =  s * cosLambda3 ;
+
+  return J ;
+}
+
+CLHEP::HepMatrix SimpleHelix::getDirectionJacobian( double s ) const
+{
+  CLHEP::HepMatrix J( 3 , 5 , 0 ) ;
+
+  double cosLambda = 1./sqrt(1 + _tanLambda*_tanLambda) ;
+  double cosLambda3 = cosLambda*cosLambda*cosLambda ;
+  double st = s * cosLambda ;
+  double phi = _phi0 - _omega * st ;
+
+  double sinPhi = sin(phi) , cosPhi = cos(phi) ;
+
+  // phi0
+  J[0][1] = -cosLambda * sinPhi ;
+  J[1][1] =  cosLambda * cosPhi ;
+  // omega
+  J[0][2] =  cosLambda * st * sinPhi ;
+  J[1][2] = -cosLambda * st * cosPhi ;
+  // tanLambda
+  J[0][4] = -_tanLambda * cosLambda3 * ( cosPhi + _omega * st * sinPhi ) ;
+  J[1][4] = -_tanLambda * cosLambda3 * ( sinPhi - _omega * st * cosPhi ) ;
+  J[2][4] =  cosLambda3 ;
+
+  return J ;
+}
+
+CLHEP::HepMatrix SimpleHelix::getJacobian( double s ) const
+{
+  CLHEP::HepMatrix J( 6 , 5 , 0 ) ;
+  J.sub( 1 , 1 , getPositionJacobian(s) ) ;
+
+  if( _Bz == 0. ) return J ;
+
+  double cosLambda = 1./sqrt(1 + _tanLambda*_tanLambda) ;
+  double cosLambda3 = cosLambda*cosLambda*cosLambda ;
+  double st = s * cosLambda ;
+  double phi = _phi0 - _omega * st ;
+  double pt = _a * fabs( _Bz / _omega ) ;
+
+  double sinPhi = sin(phi) , cosPhi = cos(phi) ;
+
+  // p = pt * ( cos(phi), sin(phi), tanLambda )
+  // phi0
+  J[3][1] = -pt * sinPhi ;
+  J[4][1] =  pt * cosPhi ;
+  // omega
+  J[3][2] = -pt * cosPhi / _omega + pt * st * sinPhi ;
+  J[4][2] = -pt * sinPhi / _omega - pt * st * cosPhi ;
+  J[5][2] = -pt * _tanLambda / _omega ;
+  // tanLambda
+  J[3][4] = -pt * sinPhi * _omega * s * _tanLambda * cosLambda3 ;
+  J[4][4] =  pt * cosPhi * _omega * s * _tanLambda * cosLambda3 ;
+  J[5][4] =  pt ;
+
+  return J ;
+}
+
+void SimpleHelix::setBz( double bz )
+{
+  _Bz = bz ;
+}
+
+double SimpleHelix::getBz() const
+{
+  return _Bz ;
+}
+
+LCErrorMatrix SimpleHelix::getSurfaceErrors( double s, const LCVector3D& normal ) const
+{
+  CLHEP::HepMatrix J = getPositionJacobian(s) ;
+
+  // moving the helix parameters also moves the intersection along the helix:
+  // dx/dp -> (1 - t n^T / n.t) dx/dp
+  LCVector3D t = getDirection(s) ;
+  double nt = normal.dot(t) ;
+  if( fabs(nt) < DBL_EPSILON ) // tangential to the surface - no constraint
+    return _errors.similarity( J ) ;
+
+  CLHEP::HepMatrix P( 3 , 3 , 1 ) ;
+  for( int i = 0 ; i < 3 ; ++i )
+    for( int j = 0 ; j < 3 ; ++j )
+      P[i][j] -= t[i] * normal[j] / nt ;
+
+  return _errors.similarity( P * J ) ;
+}
+
+std::vector<SimpleHelix::SurfaceState> SimpleHelix::propagateToPlane( const std::vector<const SimpleHelix*>& helices,
+                                                                     const LCPlane3D& plane )
+{
+  std::vector<SurfaceState> states( helices.size() ) ;
+  LCVector3D normal = plane.normal().unit() ;
+
+  for( unsigned i = 0 ; i < helices.size() ; ++i ) {
+    SurfaceState& state = states[i] ;
+    const SimpleHelix* helix = helices[i] ;
+
+    state.s = helix->getIntersectionWithPlane( plane , state.exists ) ;
+    if( ! state.exists ) continue ;
+
+    state.position  = helix->getPosition( state.s ) ;
+    state.direction = helix->getDirection( state.s ) ;
+    state.errors    = helix->getSurfaceErrors( state.s , normal ) ;
+  }
+  return states ;
+}
+
+std::vector<SimpleHelix::SurfaceState> SimpleHelix::propagateToCylinder( const std::vector<const SimpleHelix*>& helices,
+                                                                        const LCCylinder& cylinder )
 {
-  return LCErrorMatrix( 6 , 0 ) ;
+  std::vector<SurfaceState> states( helices.size() ) ;
+  LCVector3D start = cylinder.startPoint() ;
+  LCVector3D axis = cylinder.axisDirection() ;
+
+  for( unsigned i = 0 ; i < helices.size() ; ++i ) {
+    SurfaceState& state = states[i] ;
+    const SimpleHelix* helix = helices[i] ;
+
+    state.s = helix->getIntersectionWithCylinder( cylinder , state.exists ) ;
+    if( ! state.exists ) continue ;
+
+    state.position  = helix->getPosition( state.s ) ;
+    state.direction = helix->getDirection( state.s ) ;
+
+    LCVector3D d = state.position - start ;
+    LCVector3D normal = d - d.dot(axis) * axis ;
+    if( normal.mag2() > 0. ) normal = normal.unit() ;
+
+    state.errors = helix->getSurfaceErrors( state.s , normal ) ;
+  }
+  return states ;
 }
 
 double SimpleHelix::getPathAt(const LCVector3D position ) const
@@ -1,9 +1,11 @@
 #include "TrueJet_Parser.h"
+#include "RelationNavigatorCache.h"
 #include <stdlib.h>
 #include <math.h>
 //#include <cmath>
 #include <iostream>
 #include <iomanip>
+#include <unordered_set>
 
 
 // ----- include for verbosity dependend logging ---------
@@ -20,7 +22,8 @@
 using namespace lcio ;
 using namespace marlin ;
 
-struct MCPseen : LCIntExtension<MCPseen> {} ;
+// stands in for the navigator of a relation collection that is not in the event
+static const LCRelationNavigator emptyNavigator( LCIO::RECONSTRUCTEDPARTICLE, LCIO::MCPARTICLE ) ;
 
 
   TrueJet_Parser::TrueJet_Parser() {
@@ -31,6 +34,8 @@ struct MCPseen : LCIntExtension<MCPseen> {} ;
 }
 
 TrueJet_Parser::~TrueJet_Parser() {
+  delete intvec;
+  delete mcpartvec;
 }
 
 
@@ -47,66 +52,17 @@ const double* TrueJet_Parser::p4seen(int ijet) {
 
 
 double TrueJet_Parser::Etrue(int ijet) {
-  static FloatVec www ;
-  LCObjectVec mcpvec = reltjmcp->getRelatedToObjects( jets->at(ijet) );
-  www = reltjmcp->getRelatedToWeights( jets->at(ijet));
-  double E=0.0;
-  for ( unsigned kk=0 ; kk<mcpvec.size() ; kk++ ) {
-    MCParticle* mcp  = dynamic_cast<MCParticle*>(mcpvec[kk]);
-    if ( _COUNT_FSR ) {
-      if (  abs(www[kk]) == 1.0) {
-        E+=mcp->getEnergy();
-      }
-    } else {
-      if (  www[kk] == 1.0) {
-        E+=mcp->getEnergy();
-      }
-    }
-  }
-  return E;
+  return _jetKinematics.at(ijet).p4true[0];
 }
 double TrueJet_Parser::Mtrue(int ijet) {
-  const double* p_4 = p4true(ijet);
-  double psqr=0;
-  for (int kk=1 ; kk<=3 ; kk++ ) {
-     psqr+=p_4[kk]*p_4[kk];
-  }
-  double M=sqrt(p_4[0]*p_4[0]-psqr);
-  return M ;
+  return _jetKinematics.at(ijet).Mtrue;
 }
 const double* TrueJet_Parser::ptrue(int ijet) {
-  static FloatVec www ;
-  LCObjectVec mcpvec = reltjmcp->getRelatedToObjects( jets->at(ijet) );
-  www =  reltjmcp->getRelatedToWeights( jets->at(ijet));
-  p3[0]=0.; p3[1]=0.; p3[2]=0.;
-  for ( unsigned kk=0 ; kk<mcpvec.size() ; kk++ ) {
-    MCParticle* mcp  = dynamic_cast<MCParticle*>(mcpvec[kk]);
-    if ( _COUNT_FSR ) {
-      if (  abs(www[kk]) == 1.0) {
-        const double* mom = mcp->getMomentum();
-        for (int jj=0 ; jj<3 ; jj++ ) {
-          p3[jj]+=mom[jj];
-        }
-      }
-    } else {
-      if (  www[kk] == 1.0) {
-        const double* mom = mcp->getMomentum();
-        for (int jj=0 ; jj<3 ; jj++ ) {
-          p3[jj]+=mom[jj];
-        }
-      }
-    }
-  }
-  return p3;
+  return _jetKinematics.at(ijet).p4true+1;
 }
 
 const double* TrueJet_Parser::p4true(int ijet) {
-  const double* mom = ptrue(ijet);
-  for (int kk=1 ; kk<=3 ; kk++ ) {
-     p4[kk]=mom[kk-1];
-  }
-  p4[0]=Etrue(ijet);
-  return p4 ;
+  return _jetKinematics.at(ijet).p4true;
 }
 
 const MCParticleVec& TrueJet_Parser::true_partics(int ijet) {
@@ -120,108 +76,112 @@ const MCParticleVec& TrueJet_Parser::true_partics(int ijet) {
 }
 
 const double* TrueJet_Parser::pquark(int ijet) {
-  if (final_elementon(ijet) != NULL ) {
-    return final_elementon(ijet)->getMomentum() ;
-  } else {
-    p3[0]=0. ;p3[1]=0. ;p3[2]=0. ;
-    return p3 ;
-  }
+  return _jetKinematics.at(ijet).p4quark+1;
 }
 
 const double* TrueJet_Parser::p4quark(int ijet) {
-  const double* mom = pquark(ijet);
-  for (int kk=1 ; kk<=3 ; kk++ ) {
-     p4[kk]=mom[kk-1];
-  }
-  p4[0]=Equark(ijet);
-  return p4 ;
+  return _jetKinematics.at(ijet).p4quark;
 }
 
 
 double TrueJet_Parser::Etrueseen(int ijet) {
-  if (  reltrue_tj == 0 ) {
-    LCCollection* rmclcol = NULL;
-    try{
-     rmclcol = evt->getCollection( get_recoMCTruthLink() );
-    }
-    catch( lcio::DataNotAvailableException& e )
-    {
-      streamlog_out(WARNING) << get_recoMCTruthLink()   << " collection not available" << std::endl;
-        rmclcol = NULL;
-    }
-    reltrue_tj = new LCRelationNavigator( rmclcol );
-  }
-  LCObjectVec mcpvec = reltjmcp->getRelatedToObjects( jets->at(ijet) );
-  double E=0.0;
-  for ( unsigned kk=0 ; kk<mcpvec.size() ; kk++ ) {
-    MCParticle* mcp  = dynamic_cast<MCParticle*>(mcpvec[kk]);
-    LCObjectVec recovec = reltrue_tj->getRelatedFromObjects( mcp);
-    if ( recovec.size() > 0 ) { // if reconstructed
-      if ( mcp->getParents().size() == 0 || ! ( mcp->getParents()[0]->ext<MCPseen>() == 1) ) {  // if ancestor not already counted
-        E+=mcp->getEnergy();
-      }
-      mcp->ext<MCPseen>() = 1 ;
-    } else {
-      if (  mcp->getParents().size() > 0 && mcp->getParents()[0]->ext<MCPseen>() == 1 ) {   // if parent of particles seen,
-                                                                                            // consider the particle itself as seen as seen
-        mcp->ext<MCPseen>() = 1 ;
-      }
-    }
-  }
-  return E;
+  return trueSeenKinematics(ijet).p4trueseen[0];
 }
 double TrueJet_Parser::Mtrueseen(int ijet) {
-  const double* p_4 = p4trueseen(ijet);
+  return trueSeenKinematics(ijet).Mtrueseen;
+}
+const double* TrueJet_Parser::ptrueseen(int ijet) {
+  return trueSeenKinematics(ijet).p4trueseen+1;
+}
+
+const double* TrueJet_Parser::p4trueseen(int ijet) {
+  return trueSeenKinematics(ijet).p4trueseen;
+}
+
+static double mass(const double* p_4) {
   double psqr=0;
   for (int kk=1 ; kk<=3 ; kk++ ) {
      psqr+=p_4[kk]*p_4[kk];
   }
-  double M=sqrt(p_4[0]*p_4[0]-psqr);
-  return M ;
+  return sqrt(p_4[0]*p_4[0]-psqr);
 }
-const double* TrueJet_Parser::ptrueseen(int ijet) {
-  if (  reltrue_tj == 0 ) {
-    LCCollection* rmclcol = NULL;
-     try{
-      rmclcol = evt->getCollection( get_recoMCTruthLink() );
-    }
-    catch( lcio::DataNotAvailableException& e )
-    {
-      streamlog_out(WARNING) << get_recoMCTruthLink()   << " collection not available" << std::endl;
-        rmclcol = NULL;
-    }
-    reltrue_tj = new LCRelationNavigator( rmclcol );
-  }
-  LCObjectVec mcpvec = reltjmcp->getRelatedToObjects( jets->at(ijet) );
-  p3[0]=0 ; p3[1]=0 ; p3[2]=0 ;
-  for ( unsigned kk=0 ; kk<mcpvec.size() ; kk++ ) {
-    MCParticle* mcp  = dynamic_cast<MCParticle*>(mcpvec[kk]);
-    LCObjectVec recovec = reltrue_tj->getRelatedFromObjects( mcp);
-    if ( recovec.size() > 0 ) { // if reconstructed
-      if ( mcp->getParents().size() == 0 || ! ( mcp->getParents()[0]->ext<MCPseen>() == 1 ) ) {  // if ancestor not already counted
-        const double* mom = mcp->getMomentum();
+
+void TrueJet_Parser::fillJetKinematics() {
+  _jetKinematics.assign( jets->size(), JetKinematics() );
+
+  for ( unsigned ijet=0 ; ijet<jets->size() ; ijet++ ) {
+    JetKinematics& kin = _jetKinematics[ijet];
+
+    const LCObjectVec& mcpvec = reltjmcp->getRelatedToObjects( jets->at(ijet) );
+    const FloatVec& www = reltjmcp->getRelatedToWeights( jets->at(ijet) );
+
+    for ( unsigned kk=0 ; kk<mcpvec.size() ; kk++ ) {
+      MCParticle* mcp  = static_cast<MCParticle*>(mcpvec[kk]);
+      const double* mom = mcp->getMomentum();
+
+      // weight -1 are FSR photons
+      if ( _COUNT_FSR ? fabs(www[kk]) == 1.0 : www[kk] == 1.0 ) {
+        kin.p4true[0]+=mcp->getEnergy();
         for (int jj=0 ; jj<3 ; jj++ ) {
-          p3[jj]+=mom[jj];
+          kin.p4true[jj+1]+=mom[jj];
         }
       }
-      mcp->ext<MCPseen>() = 1 ;
-    } else {
-      if (  mcp->getParents().size() > 0 && mcp->getParents()[0]->ext<MCPseen>() == 1 ) {   // if parent of particles seen,
-                                                                                            // consider the particle itself as seen as seen
-        mcp->ext<MCPseen>() = 1 ;
+    }
+
+    MCParticle* quark = final_elementon(ijet);
+    if ( quark != NULL ) {
+      kin.p4quark[0]=quark->getEnergy();
+      for (int jj=0 ; jj<3 ; jj++ ) {
+        kin.p4quark[jj+1]=quark->getMomentum()[jj];
       }
+      kin.Mquark=quark->getMass();
     }
+
+    kin.Mtrue=mass(kin.p4true);
   }
-  return p3;
 }
 
-const double* TrueJet_Parser::p4trueseen(int ijet) {
-  const double* mom = ptrueseen(ijet);
-  for (int kk=1 ; kk<=3 ; kk++ ) {
-     p4[kk]=mom[kk-1];
+const TrueJet_Parser::JetKinematics& TrueJet_Parser::trueSeenKinematics(int ijet) {
+  if ( ! _trueSeenFilled ) {
+    fillTrueSeenKinematics();
+  }
+  return _jetKinematics.at(ijet);
+}
+
+void TrueJet_Parser::fillTrueSeenKinematics() {
+  // one pass over the true particles of all jets, in jet order. A particle counts as seen if it is
+  // related to a PFO, or if it is a decay product of a seen particle - only the first seen particle
+  // of a decay chain contributes to the seen sums.
+  // The RecoMCTruthLink is only looked up here, so jobs that never ask for the true-seen
+  // values do not need it.
+  if ( reltrue_tj == NULL ) {
+    reltrue_tj = navigator( get_recoMCTruthLink() );
+  }
+  std::unordered_set<const MCParticle*> seen;
+
+  for ( unsigned ijet=0 ; ijet<_jetKinematics.size() ; ijet++ ) {
+    JetKinematics& kin = _jetKinematics[ijet];
+    const LCObjectVec& mcpvec = reltjmcp->getRelatedToObjects( jets->at(ijet) );
+
+    for ( unsigned kk=0 ; kk<mcpvec.size() ; kk++ ) {
+      MCParticle* mcp  = static_cast<MCParticle*>(mcpvec[kk]);
+      const double* mom = mcp->getMomentum();
+      const bool parentSeen = mcp->getParents().size() > 0 && seen.count( mcp->getParents()[0] ) != 0 ;
+      if ( reltrue_tj->getRelatedFromObjects( mcp ).size() > 0 ) { // if reconstructed
+        if ( ! parentSeen ) {  // if ancestor not already counted
+          kin.p4trueseen[0]+=mcp->getEnergy();
+          for (int jj=0 ; jj<3 ; jj++ ) {
+            kin.p4trueseen[jj+1]+=mom[jj];
+          }
+        }
+        seen.insert( mcp );
+      } else if ( parentSeen ) {
+        seen.insert( mcp );
+      }
+    }
+    kin.Mtrueseen=mass(kin.p4trueseen);
   }
-  p4[0]=Etrueseen(ijet);
-  return p4 ;
+  _trueSeenFilled = true;
 }
 
 
@@ -544,10 +504,17 @@ void TrueJet_Parser::getall( LCEvent * event ) {
 
 
     evt=event;
+    _jetKinematics.clear();
+    reltrue_tj = NULL;
+    _trueSeenFilled = false;
      // get TrueJets
     try{
       tjcol = evt->getCollection( _trueJetCollectionName);
-      if (  tjcol->getNumberOfElements() == 0 ) { return ; }
+      if (  tjcol->getNumberOfElements() == 0 ) {
+        // no jets, but the lookups by particle (mcpjet, recojet, ...) still have to work
+        relfcn = relicn = relfp = relip = reltjreco = reltjmcp = reltrue_tj = &emptyNavigator;
+        return ;
+      }
     }
     catch( lcio::DataNotAvailableException& e )
     {
@@ -581,90 +548,39 @@ void TrueJet_Parser::getall( LCEvent * event ) {
 
     initialcns=getInitialcn();
 
-     // get  FinalColourNeutralLink
-    LCCollection* fcnlcol = NULL;
-    try{
-      fcnlcol  = evt->getCollection(  _finalColourNeutralLink );
-    }
-    catch( lcio::DataNotAvailableException& e )
-    {
-        streamlog_out(WARNING) <<  _finalColourNeutralLink   << " collection not available" << std::endl;
-        fcnlcol  = NULL;
-    }
-    relfcn = new LCRelationNavigator( fcnlcol );
+    // the navigators are owned by the event wide cache and shared with other users of the same links
+    relfcn = navigator( _finalColourNeutralLink );
+    relicn = navigator( _initialColourNeutralLink );
+    relfp = navigator( _finalElementonLink );
+    relip = navigator( _initialElementonLink );
+    reltjreco = navigator( _trueJetPFOLink );
+    reltjmcp = navigator( _trueJetMCParticleLink );
 
-     // get  InitialColourNeutralLink
-    LCCollection* icnlcol = NULL;
-    try{
-      icnlcol  = evt->getCollection(  _initialColourNeutralLink );
-    }
-    catch( lcio::DataNotAvailableException& e )
-    {
-        streamlog_out(WARNING) <<  _initialColourNeutralLink  << " collection not available" << std::endl;
-        fcnlcol  = NULL;
-    }
-    relicn = new LCRelationNavigator( icnlcol );
-
-     // get  FinalElementonLink
-    LCCollection* fplcol = NULL;
-    try{
-      fplcol  = evt->getCollection(  _finalElementonLink );
-    }
-    catch( lcio::DataNotAvailableException& e )
-    {
-        streamlog_out(WARNING) <<  _finalElementonLink   << " collection not available" << std::endl;
-        fcnlcol  = NULL;
-    }
-    relfp = new LCRelationNavigator( fplcol );
-
-     // get  InitialElementonLink
-    LCCollection* iplcol = NULL;
-    try{
-      iplcol  = evt->getCollection(  _initialElementonLink );
-    }
-    catch( lcio::DataNotAvailableException& e )
-    {
-        streamlog_out(WARNING) <<  _initialElementonLink   << " collection not available" << std::endl;
-        fcnlcol  = NULL;
-    }
-    relip = new LCRelationNavigator( iplcol );
-
-     // get  TrueJetPFOLink
-    LCCollection* tjrecolcol = NULL;
-    try{
-      tjrecolcol  = evt->getCollection(  _trueJetPFOLink );
-    }
-    catch( lcio::DataNotAvailableException& e )
-    {
-        streamlog_out(WARNING) <<  _trueJetPFOLink   << " collection not available" << std::endl;
-        fcnlcol  = NULL;
-    }
-    reltjreco = new LCRelationNavigator( tjrecolcol );
-
-
-     // get  TrueJetMCParticleLink
-    LCCollection* tjmcplcol = NULL;
-    try{
-      tjmcplcol  = evt->getCollection(  _trueJetMCParticleLink );
-    }
-    catch( lcio::DataNotAvailableException& e )
-    {
-        streamlog_out(WARNING) <<  _trueJetMCParticleLink   << " collection not available" << std::endl;
-        fcnlcol  = NULL;
-    }
-    reltjmcp = new LCRelationNavigator( tjmcplcol );
-    reltrue_tj =NULL ;
+    fillJetKinematics();
 
 }
+const LCRelationNavigator* TrueJet_Parser::navigator( const std::string& colName ) {
+  const LCRelationNavigator* nav = MarlinUtil::RelationNavigatorCache::forEvent( evt ).find( colName );
+  if ( nav == NULL ) {
+    streamlog_out(WARNING) <<  colName   << " collection not available" << std::endl;
+    nav = &emptyNavigator;
+  }
+  return nav;
+}
 void TrueJet_Parser::delall( ) {
-    if (  relfcn!= NULL ) delete relfcn;
-    if (  relicn!= NULL ) delete relicn;
-    if (  relfp!= NULL ) delete relfp;
-    if (  relip!= NULL ) delete relip;
-    if (  reltjreco != NULL) delete reltjreco;
-    if (  reltjmcp != NULL) delete reltjmcp;
-    if (  jets != NULL) delete  jets;
-    if (  finalcns != NULL) delete  finalcns;
-    if (  initialcns!= NULL ) delete   initialcns;
-    if ( reltrue_tj != NULL ) delete reltrue_tj;
+    // the navigators belong to MarlinUtil::RelationNavigatorCache
+    relfcn = NULL;
+    relicn = NULL;
+    relfp = NULL;
+    relip = NULL;
+    reltjreco = NULL;
+    reltjmcp = NULL;
+    reltrue_tj = NULL;
+    delete jets;
+    delete finalcns;
+    delete initialcns;
+    jets = NULL;
+    finalcns = NULL;
+    initialcns = NULL;
+    _jetKinematics.clear();
 }
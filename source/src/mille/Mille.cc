@@ -9,14 +9,125 @@
 
 #include "mille/Mille.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <thread>
+
+//___________________________________________________________________________
+
+// Single producer, single consumer ring of output blocks. The filled blocks
+// are counted by the producer and the written ones by the writing thread.
+// The mutex is held to sleep while the ring is full or empty, and briefly by
+// wake() after every block handed over or written, so that a thread checking
+// its condition cannot miss the change. Both happen once per block, not per
+// record.
+struct Mille::AsyncWriter
+{
+  AsyncWriter(std::ofstream &file, int nBlocks);
+  ~AsyncWriter();
+
+  void push(std::vector<char> &block); // swap block with an empty one of the ring
+  void drain();                        // wait until all blocks are written
+  void run();
+  void wake();
+
+  std::ofstream &myFile;
+  std::vector<std::vector<char> > myBlocks;
+  std::atomic<unsigned long> myNumFilled;
+  std::atomic<unsigned long> myNumWritten;
+  std::atomic<bool> myStop;
+  std::mutex myMutex;
+  std::condition_variable myCondition;
+  std::thread myThread;
+};
+
+//___________________________________________________________________________
+
+Mille::AsyncWriter::AsyncWriter(std::ofstream &file, int nBlocks) :
+  myFile(file), myBlocks(std::max(nBlocks, 1)),
+  myNumFilled(0), myNumWritten(0), myStop(false)
+{
+  myThread = std::thread(&AsyncWriter::run, this);
+}
+
+//___________________________________________________________________________
+
+Mille::AsyncWriter::~AsyncWriter()
+{
+  // the thread writes the remaining blocks before it stops
+  myStop = true;
+  this->wake();
+  myThread.join();
+}
+
+//___________________________________________________________________________
+
+void Mille::AsyncWriter::push(std::vector<char> &block)
+{
+  const unsigned long nFilled = myNumFilled.load(std::memory_order_relaxed);
+  if (nFilled - myNumWritten.load(std::memory_order_acquire) == myBlocks.size()) {
+    std::unique_lock<std::mutex> lock(myMutex);
+    myCondition.wait(lock, [&]{ return nFilled - myNumWritten.load(std::memory_order_acquire) < myBlocks.size(); });
+  }
+  block.swap(myBlocks[nFilled % myBlocks.size()]);
+  myNumFilled.store(nFilled + 1, std::memory_order_release);
+  this->wake();
+}
+
+//___________________________________________________________________________
+
+void Mille::AsyncWriter::drain()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+  myCondition.wait(lock, [&]{ return myNumWritten.load(std::memory_order_acquire) == myNumFilled.load(std::memory_order_relaxed); });
+}
+
+//___________________________________________________________________________
+
+void Mille::AsyncWriter::run()
+{
+  bool reported = false;
+  while (true) {
+    const unsigned long nWritten = myNumWritten.load(std::memory_order_relaxed);
+    if (nWritten == myNumFilled.load(std::memory_order_acquire)) {
+      std::unique_lock<std::mutex> lock(myMutex);
+      myCondition.wait(lock, [&]{ return myStop || nWritten != myNumFilled.load(std::memory_order_acquire); });
+      if (nWritten == myNumFilled.load(std::memory_order_acquire)) return; // stopped and all written
+    }
+
+    std::vector<char> &block = myBlocks[nWritten % myBlocks.size()];
+    myFile.write(block.data(), block.size());
+    if (!myFile && !reported) {
+      std::cerr << "Mille::AsyncWriter: Writing to the output file failed." << std::endl;
+      reported = true;
+    }
+    block.clear(); // the memory is reused by the producer
+    myNumWritten.store(nWritten + 1, std::memory_order_release);
+    this->wake();
+  }
+}
+
+//___________________________________________________________________________
+
+void Mille::AsyncWriter::wake()
+{
+  // taking the lock makes sure a thread checking its condition does not miss the change
+  { std::lock_guard<std::mutex> lock(myMutex); }
+  myCondition.notify_all();
+}
 
 //___________________________________________________________________________
 
 Mille::Mille(const char *outFileName, bool asBinary, bool writeZero) : 
   myOutFile(outFileName, (asBinary ? (std::ios::binary | std::ios::out) : std::ios::out)),
-  myAsBinary(asBinary), myWriteZero(writeZero), myBufferPos(-1), myHasSpecial(false)
+  myAsBinary(asBinary), myWriteZero(writeZero),
+  myBufferInt(myDefaultBufferSize), myBufferFloat(myDefaultBufferSize),
+  myBufferPos(-1), myHasSpecial(false), myBlockSize(myDefaultBlockSize), myNumRecords(0)
 {
   // opens outFileName, by default as binary file
 
@@ -35,7 +146,9 @@ Mille::Mille(const char *outFileName, bool asBinary, bool writeZero) :
 
 Mille::~Mille()
 {
-  // closes file
+  // writes the collected records and closes file
+  this->flush();
+  myAsyncWriter.reset();
   myOutFile.close();
 }
 
@@ -134,12 +247,27 @@ void Mille::end()
     const int numWordsToWrite = (myBufferPos + 1)*2;
 
     if (myAsBinary) {
-      myOutFile.write(reinterpret_cast<const char*>(&numWordsToWrite), 
-		      sizeof(numWordsToWrite));
-      myOutFile.write(reinterpret_cast<char*>(myBufferFloat), 
-		      (myBufferPos+1) * sizeof(myBufferFloat[0]));
-      myOutFile.write(reinterpret_cast<char*>(myBufferInt), 
-		      (myBufferPos+1) * sizeof(myBufferInt[0]));
+      const size_t arrayBytes  = (myBufferPos+1) * sizeof(myBufferFloat[0]);
+      const size_t recordBytes = sizeof(numWordsToWrite) + 2*arrayBytes;
+
+      if (myOutBlock.size() + recordBytes > myBlockSize) this->writeBlock();
+
+      if (recordBytes >= myBlockSize && !myAsyncWriter) { // large record: no need to copy it into the block
+	myOutFile.write(reinterpret_cast<const char*>(&numWordsToWrite), 
+			sizeof(numWordsToWrite));
+	myOutFile.write(reinterpret_cast<const char*>(myBufferFloat.data()), arrayBytes);
+	myOutFile.write(reinterpret_cast<const char*>(myBufferInt.data()), arrayBytes);
+      } else {
+	if (myOutBlock.capacity() < myBlockSize) myOutBlock.reserve(myBlockSize);
+	const size_t pos = myOutBlock.size();
+	myOutBlock.resize(pos + recordBytes);
+	char *record = &myOutBlock[pos];
+	std::memcpy(record, &numWordsToWrite, sizeof(numWordsToWrite));
+	record += sizeof(numWordsToWrite);
+	std::memcpy(record, myBufferFloat.data(), arrayBytes);
+	std::memcpy(record + arrayBytes, myBufferInt.data(), arrayBytes);
+	if (myOutBlock.size() >= myBlockSize) this->writeBlock(); // only a large record when asynchronous
+      }
     } else {
       myOutFile << numWordsToWrite << "\n";
       for (int i = 0; i < myBufferPos+1; ++i) {
@@ -152,12 +280,55 @@ void Mille::end()
       }
       myOutFile << "\n";
     }
+    ++myNumRecords;
   }
   myBufferPos = -1; // reset buffer for next set of derivatives
 }
 
 //___________________________________________________________________________
 
+void Mille::reserve(int nWords)
+{
+  // allocate the record buffer once instead of growing it for large records
+  if (nWords > static_cast<int>(myBufferInt.size())) this->resizeBuffer(nWords);
+}
+
+//___________________________________________________________________________
+
+void Mille::setBlockSize(unsigned int nBytes)
+{
+  // records are written in blocks of up to nBytes, 0 writes every record at once
+  myBlockSize = nBytes;
+  if (myOutBlock.size() > myBlockSize) this->writeBlock();
+}
+
+//___________________________________________________________________________
+
+void Mille::flush()
+{
+  // write the records collected so far, e.g. before reading the file
+  this->writeBlock();
+  if (myAsyncWriter) myAsyncWriter->drain();
+  myOutFile.flush();
+}
+
+//___________________________________________________________________________
+
+void Mille::setAsynchronous(bool async, int nBlocks)
+{
+  if (async && !myAsBinary) {
+    std::cerr << "Mille::setAsynchronous: Text output is always written synchronously."
+	      << std::endl;
+    return;
+  }
+  // the records collected so far are written before the mode changes
+  this->flush();
+  myAsyncWriter.reset();
+  if (async) myAsyncWriter.reset(new AsyncWriter(myOutFile, nBlocks));
+}
+
+//___________________________________________________________________________
+
 void Mille::newSet()
 {
   // initilise for new set of locals, e.g. new track
@@ -172,17 +343,47 @@ void Mille::newSet()
 bool Mille::checkBufferSize(int nLocal, int nGlobal)
 {
   // enough space for next nLocal + nGlobal derivatives incl. measurement?
+  // If not, the buffer grows up to the largest record pede can read.
+
+  const long long nNeeded = static_cast<long long>(myBufferPos) + nLocal + nGlobal + 3;
+  if (nNeeded <= static_cast<long long>(myBufferInt.size())) return true;
 
-  if (myBufferPos + nLocal + nGlobal + 2 >= myBufferSize) {
+  if (nNeeded > myMaxBufferSize) {
     ++(myBufferInt[0]); // increase error count
-    std::cerr << "Mille::checkBufferSize: Buffer too short (" 
-	      << myBufferSize << "),"
+    std::cerr << "Mille::checkBufferSize: Record too long (" 
+	      << myMaxBufferSize << "),"
 	      << "\n need space for nLocal (" << nLocal<< ")"
 	      << "/nGlobal (" << nGlobal << ") local/global derivatives, " 
 	      << myBufferPos + 1 << " already stored!"
 	      << std::endl;
     return false;
-  } else {
-    return true;
   }
+
+  // grow geometrically, so a long record costs only a few reallocations
+  this->resizeBuffer(std::max(nNeeded, 2*static_cast<long long>(myBufferInt.size())));
+  return true;
+}
+
+//___________________________________________________________________________
+
+void Mille::resizeBuffer(long long nWords)
+{
+  // the stored part of the current record is kept
+  const size_t newSize = std::min(nWords, static_cast<long long>(myMaxBufferSize));
+  myBufferInt.resize(newSize);
+  myBufferFloat.resize(newSize);
+}
+
+//___________________________________________________________________________
+
+void Mille::writeBlock()
+{
+  // write the collected records with one call, keeping the memory for the next block
+  if (myOutBlock.empty()) return;
+  if (myAsyncWriter) {
+    myAsyncWriter->push(myOutBlock); // myOutBlock is now an empty block of the ring
+    return;
+  }
+  myOutFile.write(myOutBlock.data(), myOutBlock.size());
+  myOutBlock.clear();
 }
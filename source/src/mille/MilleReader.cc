@@ -0,0 +1,229 @@
+/**
+ * \file MilleReader.cc
+ *  Reading of the binary and text files written by Mille.
+ */
+
+#include "mille/MilleReader.h"
+
+#include <cstring>
+#include <istream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+  // special block at pair pos: ( 0., 0 ) ( -nSpecial, 0 ), returns nSpecial or 0
+  inline int specialAt(const float *floats, const int *ints, int size, int pos)
+  {
+    if (pos + 1 < size && ints[pos] == 0 && floats[pos] == 0. && ints[pos+1] == 0 && floats[pos+1] < 0.) {
+      return static_cast<int>(-floats[pos+1]);
+    }
+    return 0;
+  }
+
+  // number of words of the binary record at pos, 0 if there is no complete valid record
+  inline int recordWords(const char *pos, const char *end)
+  {
+    if (end - pos < static_cast<long>(sizeof(int))) return 0;
+    int numWords;
+    std::memcpy(&numWords, pos, sizeof(numWords));
+    if (numWords < 2 || numWords % 2 != 0) return 0;
+    if (static_cast<size_t>(end - pos - sizeof(int)) / sizeof(int) < static_cast<size_t>(numWords)) return 0;
+    return numWords;
+  }
+}
+
+//___________________________________________________________________________
+
+bool MilleRecord::nextMeasurement(int &pos, Measurement &measurement) const
+{
+  while (pos < mySize) {
+    const int nSpecial = specialAt(myFloats, myInts, mySize, pos);
+    if (nSpecial > 0) { // not a measurement
+      pos += 2 + nSpecial;
+      continue;
+    }
+    if (myInts[pos] != 0) return false; // not the start of a measurement
+
+    // measurement, local derivatives up to the uncertainty, then global derivatives
+    measurement.rMeas = myFloats[pos];
+    int i = pos + 1;
+    measurement.derLc = myFloats + i;
+    measurement.localIndex = myInts + i;
+    while (i < mySize && myInts[i] != 0) ++i;
+    measurement.nLocal = i - pos - 1;
+    if (i == mySize) return false;
+
+    measurement.sigma = myFloats[i];
+    ++i;
+    measurement.derGl = myFloats + i;
+    measurement.label = myInts + i;
+    const int firstGlobal = i;
+    while (i < mySize && myInts[i] != 0) ++i;
+    measurement.nGlobal = i - firstGlobal;
+
+    pos = i;
+    return true;
+  }
+  return false;
+}
+
+//___________________________________________________________________________
+
+bool MilleRecord::getSpecial(int &nSpecial, const float *&floatings, const int *&integers) const
+{
+  int pos = 1;
+  Measurement measurement;
+  while (pos < mySize) {
+    nSpecial = specialAt(myFloats, myInts, mySize, pos);
+    if (nSpecial > 0) {
+      floatings = myFloats + pos + 2;
+      integers = myInts + pos + 2;
+      return pos + 2 + nSpecial <= mySize;
+    }
+    if (!this->nextMeasurement(pos, measurement)) break;
+  }
+  nSpecial = 0;
+  return false;
+}
+
+//___________________________________________________________________________
+
+MilleReader::iterator::iterator(const char *data, size_t begin, size_t end) :
+  myPos(data + begin), myEnd(data + end), myData(data), myStream(0), myOffset(begin), myValid(false)
+{
+  this->read();
+}
+
+//___________________________________________________________________________
+
+MilleReader::iterator::iterator(std::istream *stream) :
+  myPos(0), myEnd(0), myData(0), myStream(stream), myOffset(0), myValid(false)
+{
+  this->read();
+}
+
+//___________________________________________________________________________
+
+void MilleReader::iterator::read()
+{
+  myValid = false;
+
+  if (!myStream) {
+    // binary: the word count, then as many floats as ints
+    myOffset = myPos - myData;
+    const int numWords = recordWords(myPos, myEnd);
+    if (numWords == 0) return;
+
+    const int size = numWords / 2;
+    const char *floats = myPos + sizeof(int);
+    myRecord = MilleRecord(reinterpret_cast<const float*>(floats),
+			   reinterpret_cast<const int*>(floats + size * sizeof(float)), size);
+    myPos += sizeof(int) * (1 + numWords);
+    myValid = true;
+    return;
+  }
+
+  // text: the word count, a line of floats and a line of ints
+  *myStream >> std::ws;
+  if (myStream->eof()) myStream->clear(); // to get the offset of the end
+  const std::streampos offset = myStream->tellg();
+  if (offset != std::streampos(-1)) myOffset = offset;
+  int numWords = 0;
+  if (!(*myStream >> numWords) || numWords < 2 || numWords % 2 != 0) return;
+
+  const int size = numWords / 2;
+  myFloats.resize(size);
+  myInts.resize(size);
+  for (int i = 0; i < size; ++i) *myStream >> myFloats[i];
+  for (int i = 0; i < size; ++i) *myStream >> myInts[i];
+  if (!*myStream) return;
+
+  myValid = true;
+}
+
+//___________________________________________________________________________
+
+void MilleReader::iterator::point() const
+{
+  if (myStream) myRecord = MilleRecord(myFloats.data(), myInts.data(), myFloats.size());
+}
+
+//___________________________________________________________________________
+
+MilleReader::MilleReader(const std::string &fileName, bool asBinary) :
+  myAsBinary(asBinary), myData(0), mySize(0)
+{
+  if (!asBinary) {
+    myTextFile.reset(new std::ifstream(fileName.c_str()));
+    if (!*myTextFile) throw std::runtime_error("MilleReader: cannot open " + fileName);
+    myTextFile->seekg(0, std::ios::end);
+    mySize = myTextFile->tellg();
+    myTextFile->seekg(0, std::ios::beg);
+    return;
+  }
+
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("MilleReader: cannot open " + fileName);
+  struct stat info;
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    throw std::runtime_error("MilleReader: cannot read " + fileName);
+  }
+  mySize = info.st_size;
+  if (mySize > 0) {
+    void *data = ::mmap(0, mySize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("MilleReader: cannot map " + fileName);
+    }
+    myData = static_cast<const char*>(data);
+  }
+  ::close(fd);
+}
+
+//___________________________________________________________________________
+
+MilleReader::~MilleReader()
+{
+  if (myData) ::munmap(const_cast<char*>(myData), mySize);
+}
+
+//___________________________________________________________________________
+
+MilleReader::iterator MilleReader::begin()
+{
+  if (!myAsBinary) return iterator(myTextFile.get());
+  if (!myData) return iterator();
+  ::madvise(const_cast<char*>(myData), mySize, MADV_SEQUENTIAL);
+  return iterator(myData, 0, mySize);
+}
+
+//___________________________________________________________________________
+
+std::vector<MilleReader::iterator> MilleReader::split(int nChunks) const
+{
+  if (!myAsBinary) throw std::runtime_error("MilleReader::split: only binary files can be split");
+
+  // Records can only be found from the start of the file, so the word counts
+  // are followed once. This touches one word per record.
+  std::vector<iterator> chunks;
+  if (nChunks < 1) nChunks = 1;
+  const char *pos = myData;
+  const char *end = myData + mySize;
+  for (int i = 0; i < nChunks && myData; ++i) {
+    const size_t target = mySize / nChunks * i;
+    int numWords;
+    while (static_cast<size_t>(pos - myData) < target && (numWords = recordWords(pos, end)) != 0) {
+      pos += sizeof(int) * (1 + numWords);
+    }
+    chunks.push_back(iterator(myData, pos - myData, mySize));
+  }
+  while (static_cast<int>(chunks.size()) < nChunks) chunks.push_back(iterator());
+  chunks.push_back(iterator());
+  return chunks;
+}
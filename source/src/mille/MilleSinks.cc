@@ -0,0 +1,278 @@
+/**
+ * \file MilleSinks.cc
+ *  Per-thread Mille shards and their merge in event order.
+ */
+
+#include "mille/MilleSinks.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+  // read-only mapping of a shard file
+  class MappedShard
+  {
+  public:
+    MappedShard(const std::string &fileName) : myData(0), mySize(0) {
+      int fd = ::open(fileName.c_str(), O_RDONLY);
+      if (fd < 0) throw std::runtime_error("MilleSinkFactory: cannot open " + fileName);
+      struct stat info;
+      if (::fstat(fd, &info) != 0) {
+	::close(fd);
+	throw std::runtime_error("MilleSinkFactory: cannot read " + fileName);
+      }
+      mySize = info.st_size;
+      if (mySize > 0) {
+	void *data = ::mmap(0, mySize, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (data == MAP_FAILED) {
+	  ::close(fd);
+	  throw std::runtime_error("MilleSinkFactory: cannot map " + fileName);
+	}
+	::madvise(data, mySize, MADV_SEQUENTIAL);
+	myData = static_cast<const char*>(data);
+      }
+      ::close(fd);
+    }
+    ~MappedShard() { if (myData) ::munmap(const_cast<char*>(myData), mySize); }
+
+    MappedShard(const MappedShard&) = delete;
+    MappedShard& operator=(const MappedShard&) = delete;
+
+    const char *myData;
+    size_t mySize;
+  };
+
+  // event runs of one shard in the order they go to the merged file
+  struct ShardRuns
+  {
+    std::vector<size_t> offsets;  // byte offset of each run in the shard, plus the end
+    std::vector<size_t> order;    // run indices, stably sorted by event
+    size_t next;
+  };
+}
+
+//___________________________________________________________________________
+
+MilleSink::MilleSink(const std::string &shardFileName, bool asynchronous) :
+  myShardFileName(shardFileName), myMille(new Mille(shardFileName.c_str())), myEvent(0)
+{
+  if (asynchronous) myMille->setAsynchronous(true);
+}
+
+//___________________________________________________________________________
+
+void MilleSink::end()
+{
+  // count the record in the run of its event, if end() wrote one
+  const long long nRecords = myMille->getNumberOfRecords();
+  myMille->end();
+  if (myMille->getNumberOfRecords() == nRecords) return;
+  if (!myEventRuns.empty() && myEventRuns.back().event == myEvent) {
+    ++myEventRuns.back().nRecords;
+  } else {
+    const EventRun run = {myEvent, 1};
+    myEventRuns.push_back(run);
+  }
+}
+
+//___________________________________________________________________________
+
+void MilleSink::close()
+{
+  myMille.reset();
+}
+
+//___________________________________________________________________________
+
+MilleSinkFactory::MilleSinkFactory(const std::string &outFileName, bool asynchronous) :
+  myOutFileName(outFileName), myAsynchronous(asynchronous), myMerged(false)
+{
+}
+
+//___________________________________________________________________________
+
+MilleSinkFactory::~MilleSinkFactory()
+{
+  // shards that were neither merged nor listed stay on disk
+  this->closeSinks();
+}
+
+//___________________________________________________________________________
+
+MilleSink &MilleSinkFactory::getSink()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+  this->checkNotMerged();
+  MilleSink *&sink = mySinkOfThread[std::this_thread::get_id()];
+  if (!sink) {
+    mySinks.emplace_back(new MilleSink(myOutFileName + ".shard" + std::to_string(mySinks.size()),
+				       myAsynchronous));
+    sink = mySinks.back().get();
+  }
+  return *sink;
+}
+
+//___________________________________________________________________________
+
+std::vector<std::string> MilleSinkFactory::getShardFileNames() const
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+  std::vector<std::string> names;
+  for (size_t i = 0; i < mySinks.size(); ++i) names.push_back(mySinks[i]->getShardFileName());
+  return names;
+}
+
+//___________________________________________________________________________
+
+void MilleSinkFactory::closeSinks()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+  for (size_t i = 0; i < mySinks.size(); ++i) mySinks[i]->close();
+  mySinkOfThread.clear(); // threads asking again get new sinks
+}
+
+//___________________________________________________________________________
+
+void MilleSinkFactory::checkNotMerged() const
+{
+  // the shards of the sinks are gone after merge()
+  if (myMerged) throw std::runtime_error("MilleSinkFactory: " + myOutFileName + " was already merged");
+}
+
+//___________________________________________________________________________
+
+void MilleSinkFactory::writeFileList(const std::string &listFileName)
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    this->checkNotMerged();
+  }
+  this->closeSinks();
+
+  std::ofstream list(listFileName.c_str());
+  list << "Cfiles\n";
+  const std::vector<std::string> names = this->getShardFileNames();
+  for (size_t i = 0; i < names.size(); ++i) list << names[i] << "\n";
+  if (!list) throw std::runtime_error("MilleSinkFactory: cannot write " + listFileName);
+}
+
+//___________________________________________________________________________
+
+long long MilleSinkFactory::merge(bool removeShards)
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    this->checkNotMerged();
+  }
+  this->closeSinks();
+
+  const size_t nShards = mySinks.size();
+  std::vector<std::unique_ptr<MappedShard> > shards(nShards);
+  std::vector<ShardRuns> runs(nShards);
+
+  for (size_t s = 0; s < nShards; ++s) {
+    const MilleSink &sink = *mySinks[s];
+    shards[s].reset(new MappedShard(sink.getShardFileName()));
+    const MappedShard &shard = *shards[s];
+    const std::vector<MilleSink::EventRun> &events = sink.getEventRuns();
+
+    // a binary record is its number of words followed by that many words,
+    // the offset of a run is the offset of its first record
+    ShardRuns &shardRuns = runs[s];
+    shardRuns.offsets.reserve(events.size() + 1);
+    size_t pos = 0;
+    size_t run = 0;
+    long long nLeft = 0;
+    while (pos + sizeof(int) <= shard.mySize) {
+      int numWords;
+      std::memcpy(&numWords, shard.myData + pos, sizeof(numWords));
+      const size_t recordBytes = sizeof(int) * (1 + static_cast<size_t>(numWords));
+      if (numWords <= 0 || recordBytes > shard.mySize - pos) break;
+      if (nLeft == 0) {
+	if (run == events.size()) break;
+	shardRuns.offsets.push_back(pos);
+	nLeft = events[run++].nRecords;
+      }
+      --nLeft;
+      pos += recordBytes;
+    }
+    if (pos != shard.mySize || run != events.size() || nLeft != 0) {
+      throw std::runtime_error("MilleSinkFactory: " + sink.getShardFileName()
+			       + " does not contain the records written to it");
+    }
+    shardRuns.offsets.push_back(pos);
+
+    // workers usually get increasing event numbers, then no sorting is needed
+    shardRuns.order.resize(events.size());
+    for (size_t i = 0; i < events.size(); ++i) shardRuns.order[i] = i;
+    const auto earlier = [](const MilleSink::EventRun &a, const MilleSink::EventRun &b) { return a.event < b.event; };
+    if (!std::is_sorted(events.begin(), events.end(), earlier)) {
+      std::stable_sort(shardRuns.order.begin(), shardRuns.order.end(),
+		       [&](size_t a, size_t b) { return earlier(events[a], events[b]); });
+    }
+    shardRuns.next = 0;
+  }
+
+  std::ofstream outFile(myOutFileName.c_str(), std::ios::binary | std::ios::out);
+  if (!outFile) throw std::runtime_error("MilleSinkFactory: cannot open " + myOutFileName);
+
+  // k-way merge by ( event, shard ), copying adjacent runs at once
+  typedef std::pair<long long, size_t> Head;
+  std::priority_queue<Head, std::vector<Head>, std::greater<Head> > heads;
+  for (size_t s = 0; s < nShards; ++s) {
+    if (!runs[s].order.empty()) heads.push(Head(mySinks[s]->getEventRuns()[runs[s].order[0]].event, s));
+  }
+
+  long long nRecords = 0;
+  while (!heads.empty()) {
+    const size_t s = heads.top().second;
+    heads.pop();
+
+    ShardRuns &shardRuns = runs[s];
+    const std::vector<MilleSink::EventRun> &events = mySinks[s]->getEventRuns();
+
+    // take the runs of this shard that come before the head of the other
+    // shards and are adjacent in the shard, and write them with one call
+    const size_t first = shardRuns.order[shardRuns.next];
+    size_t last = first;
+    nRecords += events[first].nRecords;
+    ++shardRuns.next;
+    while (shardRuns.next < shardRuns.order.size()) {
+      const size_t i = shardRuns.order[shardRuns.next];
+      if (i != last + 1) break;
+      if (!heads.empty() && Head(events[i].event, s) > heads.top()) break;
+      last = i;
+      nRecords += events[i].nRecords;
+      ++shardRuns.next;
+    }
+    outFile.write(shards[s]->myData + shardRuns.offsets[first],
+		  shardRuns.offsets[last + 1] - shardRuns.offsets[first]);
+
+    if (shardRuns.next < shardRuns.order.size()) {
+      heads.push(Head(events[shardRuns.order[shardRuns.next]].event, s));
+    }
+  }
+
+  outFile.close();
+  if (!outFile) throw std::runtime_error("MilleSinkFactory: writing " + myOutFileName + " failed");
+
+  shards.clear();
+  if (removeShards) {
+    for (size_t s = 0; s < nShards; ++s) std::remove(mySinks[s]->getShardFileName().c_str());
+  }
+
+  std::lock_guard<std::mutex> lock(myMutex);
+  mySinks.clear();
+  myMerged = true;
+  return nRecords;
+}
@@ -0,0 +1,209 @@
+// Micro benchmarks of the computational kernels in MarlinUtil. They are not
+// part of the ctest suite, run them e.g. with
+//   ./benchmarks --reporter xml --out marlinutil-benchmarks.xml
+// to get machine readable timings that can be compared between releases.
+
+#include "EventGenerators.h"
+
+#include "ClusterShapes.h"
+#include "HelixClassT.h"
+#include "LCCylinderT.h"
+#include "NNClusters.h"
+#include "SimpleHelix.h"
+#include "WeightedPoints3D.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <iterator>
+#include <vector>
+
+using namespace benchmarks;
+
+namespace {
+constexpr unsigned trackSeed = 4711;
+constexpr unsigned showerSeed = 815;
+
+/// Minimal hit type for the NN clustering template
+template <typename FloatT> struct BenchmarkHit {
+  FloatT pos[3];
+  const FloatT* getPosition() const { return pos; }
+};
+
+/// Interleaved x,y,z array of the shower points
+template <typename FloatT> std::vector<FloatT> interleave(const ShowerPoints<FloatT>& points) {
+  std::vector<FloatT> xyz;
+  xyz.reserve(3 * points.size());
+  for (unsigned i = 0; i < points.size(); ++i) {
+    xyz.push_back(points.x[i]);
+    xyz.push_back(points.y[i]);
+    xyz.push_back(points.z[i]);
+  }
+  return xyz;
+}
+
+/// Points along a track with some smearing, for the helix fit
+ShowerPoints<float> trackPoints(const TrackParameters<double>& track, unsigned nPoints) {
+  SimpleHelix helix(track.d0, track.phi0, track.omega, track.z0, track.tanLambda, LCVector3D(0., 0., 0.));
+  std::mt19937 rng(trackSeed);
+  std::normal_distribution<double> smear(0., 0.01);
+
+  ShowerPoints<float> points;
+  for (unsigned i = 0; i < nPoints; ++i) {
+    const LCVector3D x = helix.getPosition(10. * (i + 1));
+    points.a.push_back(1.);
+    points.x.push_back(x.x() + smear(rng));
+    points.y.push_back(x.y() + smear(rng));
+    points.z.push_back(x.z() + smear(rng));
+  }
+  return points;
+}
+} // namespace
+
+TEMPLATE_TEST_CASE("HelixClassT", "[benchmark][helix]", float, double) {
+  const auto tracks = generateHelixTracks<TestType>(100, trackSeed);
+  const auto hits = interleave(generateEMShower<TestType>(1000, showerSeed));
+
+  std::vector<HelixClassT<TestType>> helices(tracks.size());
+  for (unsigned i = 0; i < tracks.size(); ++i) {
+    const auto& t = tracks[i];
+    helices[i].Initialize_Canonical(t.phi0, t.d0, t.z0, t.omega, t.tanLambda, 3.5);
+  }
+
+  BENCHMARK("getDistanceToPoint 100 tracks x 1000 hits") {
+    TestType sum = 0;
+    TestType distance[3];
+    for (const auto& helix : helices) {
+      for (unsigned i = 0; i < hits.size(); i += 3) {
+        helix.getDistanceToPoint(&hits[i], distance);
+        sum += distance[2];
+      }
+    }
+    return sum;
+  };
+
+  BENCHMARK("getDistanceToPoint with cut 100 tracks x 1000 hits") {
+    TestType sum = 0;
+    for (const auto& helix : helices) {
+      for (unsigned i = 0; i < hits.size(); i += 3) {
+        sum += helix.getDistanceToPoint(&hits[i], TestType(50.));
+      }
+    }
+    return sum;
+  };
+}
+
+TEST_CASE("SimpleHelix", "[benchmark][trajectory]") {
+  const auto tracks = generateHelixTracks<double>(50, trackSeed);
+  const auto hits = generateEMShower<double>(20, showerSeed);
+
+  std::vector<SimpleHelix> helices;
+  helices.reserve(tracks.size());
+  for (const auto& t : tracks) {
+    helices.emplace_back(t.d0, t.phi0, t.omega, t.z0, t.tanLambda, LCVector3D(0., 0., 0.));
+  }
+
+  BENCHMARK("getPathAt 50 tracks x 20 points") {
+    double sum = 0;
+    for (const auto& helix : helices) {
+      for (unsigned i = 0; i < hits.size(); ++i) {
+        sum += helix.getPathAt(LCVector3D(hits.x[i], hits.y[i], hits.z[i]));
+      }
+    }
+    return sum;
+  };
+
+  std::vector<const SimpleHelix*> helixPtrs;
+  for (const auto& helix : helices) {
+    helixPtrs.push_back(&helix);
+  }
+  const LCCylinder ecal(LCVector3D(0., 0., -2500.), LCVector3D(0., 0., 2500.), 1800.);
+
+  BENCHMARK("propagateToCylinder 50 tracks") { return SimpleHelix::propagateToCylinder(helixPtrs, ecal); };
+}
+
+TEMPLATE_TEST_CASE("LCCylinderT", "[benchmark][geometry]", float, double) {
+  const auto hits = generateHadronicShower<TestType>(10000, showerSeed);
+  const LCCylinderT<TestType> cylinder(Vector3T<TestType>(0, 0, -2500), Vector3T<TestType>(0, 0, 2500), 1800, true);
+
+  BENCHMARK("distance 10000 points") {
+    TestType sum = 0;
+    for (unsigned i = 0; i < hits.size(); ++i) {
+      sum += cylinder.distance(Vector3T<TestType>(hits.x[i], hits.y[i], hits.z[i]));
+    }
+    return sum;
+  };
+}
+
+TEST_CASE("ClusterShapes", "[benchmark][clustershapes]") {
+  auto em = generateEMShower<float>(500, showerSeed);
+  auto had = generateHadronicShower<float>(2000, showerSeed);
+
+  BENCHMARK("eigen system EM 500 hits") {
+    ClusterShapes shapes(em.size(), em.a.data(), em.x.data(), em.y.data(), em.z.data());
+    return shapes.getEigenVecInertia()[0];
+  };
+
+  BENCHMARK("eigen system hadronic 2000 hits") {
+    ClusterShapes shapes(had.size(), had.a.data(), had.x.data(), had.y.data(), had.z.data());
+    return shapes.getEigenVecInertia()[0];
+  };
+
+  BENCHMARK("fit3DProfile EM 500 hits") {
+    ClusterShapes shapes(em.size(), em.a.data(), em.x.data(), em.y.data(), em.z.data());
+    float chi2, a, b, c, d, xl0;
+    float xStart[3];
+    int indexStart;
+    float X0[2] = {3.50, 17.57};
+    float Rm[2] = {9.00, 17.19};
+    shapes.fit3DProfile(chi2, a, b, c, d, xl0, xStart, indexStart, X0, Rm);
+    return chi2;
+  };
+
+  auto track = trackPoints(generateHelixTracks<double>(1, trackSeed, 3.5, 2., 2.)[0], 200);
+
+  BENCHMARK("FitHelix 200 points") {
+    ClusterShapes shapes(track.size(), track.a.data(), track.x.data(), track.y.data(), track.z.data());
+    double par[5], dpar[5], chi2, distmax;
+    shapes.FitHelix(500, 0, 1, par, dpar, chi2, distmax);
+    return chi2;
+  };
+}
+
+TEST_CASE("WeightedPoints3D", "[benchmark][weightedpoints]") {
+  auto em = generateEMShower<double>(500, showerSeed);
+  auto had = generateHadronicShower<double>(2000, showerSeed);
+
+  BENCHMARK("eigen system EM 500 hits") {
+    WeightedPoints3D points(em.size(), em.a.data(), em.x.data(), em.y.data(), em.z.data());
+    return points.getEigenVecCartesian()[0] + points.getEigenValErrors()[0];
+  };
+
+  BENCHMARK("eigen system hadronic 2000 hits") {
+    WeightedPoints3D points(had.size(), had.a.data(), had.x.data(), had.y.data(), had.z.data());
+    return points.getEigenVecCartesian()[0] + points.getEigenValErrors()[0];
+  };
+}
+
+TEMPLATE_TEST_CASE("NNClusters", "[benchmark][cluster]", float, double) {
+  using Hit = BenchmarkHit<TestType>;
+
+  const auto shower = generateHadronicShower<TestType>(2000, showerSeed);
+  std::vector<Hit> hits(shower.size());
+  for (unsigned i = 0; i < shower.size(); ++i) {
+    hits[i] = Hit{{shower.x[i], shower.y[i], shower.z[i]}};
+  }
+
+  // includes filling the GenericHitVec, as clustering modifies the hits
+  BENCHMARK("cluster 2000 hits") {
+    GenericHitVec<Hit> hitVec;
+    for (auto& hit : hits) {
+      hitVec.push_back(new GenericHit<Hit>(&hit));
+    }
+    GenericClusterVec<Hit> clusters;
+    NNDistance<Hit, TestType> dist(20.);
+    cluster(hitVec.begin(), hitVec.end(), std::back_inserter(clusters), &dist);
+    return clusters.size();
+  };
+}
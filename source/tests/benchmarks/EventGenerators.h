@@ -0,0 +1,133 @@
+#ifndef MARLINUTIL_BENCHMARKS_EVENTGENERATORS_H
+#define MARLINUTIL_BENCHMARKS_EVENTGENERATORS_H 1
+
+// Reproducible synthetic events for the MarlinUtil benchmarks. All generators
+// take an explicit seed, so that the same inputs are used in every run and
+// timings of different releases can be compared directly.
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace benchmarks {
+
+/// Canonical helix parameters of a generated track
+template <typename FloatT> struct TrackParameters {
+  FloatT d0;
+  FloatT phi0;
+  FloatT omega;
+  FloatT z0;
+  FloatT tanLambda;
+};
+
+/// Tracks from the IP region with pt between ptMin and ptMax (GeV) in field bField (T)
+template <typename FloatT>
+std::vector<TrackParameters<FloatT>> generateHelixTracks(unsigned nTracks, unsigned seed, FloatT bField = 3.5,
+                                                         FloatT ptMin = 0.5, FloatT ptMax = 50.) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> phi(-M_PI, M_PI);
+  std::uniform_real_distribution<double> logPt(std::log(ptMin), std::log(ptMax));
+  std::uniform_real_distribution<double> cosTheta(-0.95, 0.95);
+  std::normal_distribution<double> d0(0., 0.05);
+  std::normal_distribution<double> z0(0., 0.5);
+  std::bernoulli_distribution charge(0.5);
+
+  std::vector<TrackParameters<FloatT>> tracks;
+  tracks.reserve(nTracks);
+  for (unsigned i = 0; i < nTracks; ++i) {
+    const double pt = std::exp(logPt(rng));
+    const double ct = cosTheta(rng);
+    const double q = charge(rng) ? 1. : -1.;
+    tracks.push_back({FloatT(d0(rng)), FloatT(phi(rng)), FloatT(q * 2.99792458E-4 * bField / pt), FloatT(z0(rng)),
+                      FloatT(ct / std::sqrt(1. - ct * ct))});
+  }
+  return tracks;
+}
+
+/// Point cloud of a shower, structure of arrays as used by ClusterShapes
+template <typename FloatT> struct ShowerPoints {
+  std::vector<FloatT> a;
+  std::vector<FloatT> x;
+  std::vector<FloatT> y;
+  std::vector<FloatT> z;
+
+  unsigned size() const { return a.size(); }
+};
+
+namespace detail {
+/// Shower hits along a direction starting at 'start' (mm). The longitudinal
+/// profile is a gamma distribution in units of lengthScale, the transverse
+/// profile exponential with scale radiusScale.
+template <typename FloatT>
+void addShower(ShowerPoints<FloatT>& points, unsigned nHits, double energy, const double* start, double theta,
+               double phi, double shape, double lengthScale, double radiusScale, std::mt19937& rng) {
+  std::gamma_distribution<double> longitudinal(shape, 1.);
+  std::exponential_distribution<double> transverse(1.);
+  std::uniform_real_distribution<double> azimuth(0., 2 * M_PI);
+  std::exponential_distribution<double> amplitude(1.);
+
+  const double dir[3] = {std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta)};
+  // two vectors perpendicular to dir
+  const double u[3] = {std::cos(theta) * std::cos(phi), std::cos(theta) * std::sin(phi), -std::sin(theta)};
+  const double v[3] = {-std::sin(phi), std::cos(phi), 0.};
+
+  const double meanAmplitude = energy / nHits;
+  for (unsigned i = 0; i < nHits; ++i) {
+    const double l = longitudinal(rng) * lengthScale;
+    const double r = transverse(rng) * radiusScale;
+    const double alpha = azimuth(rng);
+    const double cu = r * std::cos(alpha), cv = r * std::sin(alpha);
+
+    points.a.push_back(FloatT(meanAmplitude * amplitude(rng)));
+    points.x.push_back(FloatT(start[0] + l * dir[0] + cu * u[0] + cv * v[0]));
+    points.y.push_back(FloatT(start[1] + l * dir[1] + cu * u[1] + cv * v[1]));
+    points.z.push_back(FloatT(start[2] + l * dir[2] + cu * u[2] + cv * v[2]));
+  }
+}
+} // namespace detail
+
+/// Electromagnetic shower in a tungsten-like ECal starting at radius rStart (mm)
+template <typename FloatT>
+ShowerPoints<FloatT> generateEMShower(unsigned nHits, unsigned seed, double energy = 10., double rStart = 1800.) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> angle(0.5, 2.6);
+  const double theta = angle(rng), phi = angle(rng);
+  const double start[3] = {rStart * std::cos(phi), rStart * std::sin(phi), rStart / std::tan(theta)};
+
+  ShowerPoints<FloatT> points;
+  // X0 = 3.5 mm, Moliere radius = 9 mm
+  detail::addShower(points, nHits, energy, start, theta, phi, 4., 3.5, 9., rng);
+  return points;
+}
+
+/// Hadronic shower: a wide core plus a few displaced electromagnetic sub-showers
+template <typename FloatT>
+ShowerPoints<FloatT> generateHadronicShower(unsigned nHits, unsigned seed, double energy = 20.,
+                                            double rStart = 1800.) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> angle(0.5, 2.6);
+  std::normal_distribution<double> kink(0., 0.15);
+  std::uniform_real_distribution<double> depth(50., 600.);
+  const double theta = angle(rng), phi = angle(rng);
+  const double start[3] = {rStart * std::cos(phi), rStart * std::sin(phi), rStart / std::tan(theta)};
+
+  ShowerPoints<FloatT> points;
+  const unsigned nSub = 4;
+  const unsigned nCore = nHits / 2;
+  // interaction length ~ 200 mm, wide transverse profile
+  detail::addShower(points, nCore, 0.6 * energy, start, theta, phi, 2., 200., 60., rng);
+
+  for (unsigned i = 0; i < nSub; ++i) {
+    const unsigned n = (i + 1 < nSub) ? (nHits - nCore) / nSub : nHits - points.size();
+    const double l = depth(rng);
+    const double subStart[3] = {start[0] + l * std::sin(theta) * std::cos(phi),
+                                start[1] + l * std::sin(theta) * std::sin(phi), start[2] + l * std::cos(theta)};
+    detail::addShower(points, n, 0.4 * energy / nSub, subStart, theta + kink(rng), phi + kink(rng), 4., 17.6, 17.2,
+                      rng);
+  }
+  return points;
+}
+
+} // namespace benchmarks
+
+#endif
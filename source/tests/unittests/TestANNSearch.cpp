@@ -0,0 +1,145 @@
+#include <ANN/ANN.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+const int nPoints = 5000;
+const int nQueries = 3000;
+const int dim = 3;
+const int k = 6;
+
+// points on a coarse grid, so that many distances are equal
+struct Points {
+  ANNpointArray data = annAllocPts(nPoints, dim);
+  ANNpointArray queries = annAllocPts(nQueries, dim);
+
+  Points() {
+    std::mt19937 rng(11);
+    for (int i = 0; i < nPoints; ++i)
+      for (int d = 0; d < dim; ++d)
+        data[i][d] = rng() % 40;
+    for (int i = 0; i < nQueries; ++i)
+      for (int d = 0; d < dim; ++d)
+        queries[i][d] = (rng() % 900) * 0.05 - 2.;
+  }
+  ~Points() {
+    annDeallocPts(data);
+    annDeallocPts(queries);
+  }
+};
+
+void compareKSearch(ANNkd_tree& tree, ANNpointArray queries, double eps, int nThreads) {
+  std::vector<ANNidx> batchIdx(nQueries * k);
+  std::vector<ANNdist> batchDist(nQueries * k);
+  tree.annkSearchBatch(queries, nQueries, k, batchIdx.data(), batchDist.data(), eps, nThreads);
+
+  std::vector<ANNidx> idx(k);
+  std::vector<ANNdist> dist(k);
+  for (int i = 0; i < nQueries; ++i) {
+    tree.annkSearch(queries[i], k, idx.data(), dist.data(), eps);
+    REQUIRE(std::vector<ANNidx>(batchIdx.begin() + i * k, batchIdx.begin() + (i + 1) * k) == idx);
+    REQUIRE(std::vector<ANNdist>(batchDist.begin() + i * k, batchDist.begin() + (i + 1) * k) == dist);
+  }
+}
+
+void compareFRSearch(ANNkd_tree& tree, ANNpointArray queries, ANNdist sqRad, double eps, int nThreads) {
+  std::vector<ANNidx> batchIdx(nQueries * k);
+  std::vector<ANNdist> batchDist(nQueries * k);
+  std::vector<int> batchInRange(nQueries);
+  tree.annkFRSearchBatch(queries, nQueries, sqRad, k, batchIdx.data(), batchDist.data(), batchInRange.data(),
+                         eps, nThreads);
+
+  // without result arrays only the points in range are counted
+  std::vector<int> countOnly(nQueries);
+  tree.annkFRSearchBatch(queries, nQueries, sqRad, 0, nullptr, nullptr, countOnly.data(), eps, nThreads);
+
+  std::vector<ANNidx> idx(k);
+  std::vector<ANNdist> dist(k);
+  for (int i = 0; i < nQueries; ++i) {
+    const int inRange = tree.annkFRSearch(queries[i], sqRad, k, idx.data(), dist.data(), eps);
+    REQUIRE(batchInRange[i] == inRange);
+    REQUIRE(countOnly[i] == inRange);
+    REQUIRE(std::vector<ANNidx>(batchIdx.begin() + i * k, batchIdx.begin() + (i + 1) * k) == idx);
+    REQUIRE(std::vector<ANNdist>(batchDist.begin() + i * k, batchDist.begin() + (i + 1) * k) == dist);
+  }
+}
+
+// results of the single query searches, k neighbours per query
+struct SearchResults {
+  std::vector<ANNidx> kIdx = std::vector<ANNidx>(nQueries * k);
+  std::vector<ANNdist> kDist = std::vector<ANNdist>(nQueries * k);
+  std::vector<ANNidx> priIdx = std::vector<ANNidx>(nQueries * k);
+  std::vector<ANNdist> priDist = std::vector<ANNdist>(nQueries * k);
+  std::vector<ANNidx> frIdx = std::vector<ANNidx>(nQueries * k);
+  std::vector<ANNdist> frDist = std::vector<ANNdist>(nQueries * k);
+  std::vector<int> frInRange = std::vector<int>(nQueries);
+
+  bool operator==(const SearchResults& other) const {
+    return kIdx == other.kIdx && kDist == other.kDist && priIdx == other.priIdx && priDist == other.priDist &&
+           frIdx == other.frIdx && frDist == other.frDist && frInRange == other.frInRange;
+  }
+};
+
+// queries first, first + step, ... with the three single query searches
+void searchQueries(ANNkd_tree& tree, ANNpointArray queries, int first, int step, SearchResults& results) {
+  for (int i = first; i < nQueries; i += step) {
+    tree.annkSearch(queries[i], k, &results.kIdx[i * k], &results.kDist[i * k], 0.5);
+    tree.annkPriSearch(queries[i], k, &results.priIdx[i * k], &results.priDist[i * k], 0.5);
+    results.frInRange[i] = tree.annkFRSearch(queries[i], 9.0, k, &results.frIdx[i * k], &results.frDist[i * k], 0.0);
+  }
+}
+} // namespace
+
+TEST_CASE("ANN_BatchSearchMatchesSingleQueries", "[ann]") {
+  Points points;
+  std::unique_ptr<ANNkd_tree> trees[] = {
+      std::make_unique<ANNkd_tree>(points.data, nPoints, dim, 3),
+      std::make_unique<ANNbd_tree>(points.data, nPoints, dim, 3),
+  };
+
+  for (auto& tree : trees) {
+    for (int nThreads : {1, 4, 0}) {
+      compareKSearch(*tree, points.queries, 0.0, nThreads);
+      compareKSearch(*tree, points.queries, 0.5, nThreads);
+      compareFRSearch(*tree, points.queries, 4.0, 0.0, nThreads);
+      compareFRSearch(*tree, points.queries, 9.0, 0.5, nThreads);
+    }
+  }
+}
+
+TEST_CASE("ANN_ConcurrentSingleQueries", "[ann]") {
+  Points points;
+  std::unique_ptr<ANNkd_tree> trees[] = {
+      std::make_unique<ANNkd_tree>(points.data, nPoints, dim, 3),
+      std::make_unique<ANNbd_tree>(points.data, nPoints, dim, 3),
+  };
+
+  const int nThreads = 4;
+  for (auto& tree : trees) {
+    SearchResults serial;
+    searchQueries(*tree, points.queries, 0, 1, serial);
+
+    // every thread searches all queries into its own results, and its share
+    // of the queries into results shared with the other threads
+    std::vector<SearchResults> all(nThreads);
+    SearchResults shared;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+      threads.emplace_back([&, t]() {
+        searchQueries(*tree, points.queries, 0, 1, all[t]);
+        searchQueries(*tree, points.queries, t, nThreads, shared);
+      });
+    }
+    for (std::thread& thread : threads)
+      thread.join();
+
+    for (const SearchResults& results : all)
+      REQUIRE(results == serial);
+    REQUIRE(shared == serial);
+  }
+}
@@ -0,0 +1,555 @@
+#include "FPCCDClusterFinder.h"
+#include "FPCCDData.h"
+#include "FPCCDPixelHit.h"
+#include "FPCCDPixelLibrary.h"
+#include "TestFiles.h"
+
+#include <IMPL/LCCollectionVec.h>
+#include <IMPL/LCGenericObjectImpl.h>
+#include <lcio.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using TestHelpers::TemporaryFile;
+using TestHelpers::patch;
+
+namespace {
+// contents of one pixel as read back from FPCCDData
+struct Pixel {
+  int xi, zeta;
+  float edep;
+  FPCCDPixelHit::HitQuality_t quality;
+  std::vector<int> orderIDs;
+
+  bool operator==(const Pixel& other) const {
+    return xi == other.xi && zeta == other.zeta && edep == other.edep && quality == other.quality &&
+           orderIDs == other.orderIDs;
+  }
+};
+
+std::vector<Pixel> pixelsOf(FPCCDData& data, int layer, int ladder) {
+  std::vector<Pixel> pixels;
+  FPCCDPixelStore& store = data.getLadder(layer, ladder);
+  for (PixelIterator_t it = data.itBegin(layer, ladder); it != data.itEnd(layer, ladder); ++it) {
+    const int* orderIDs = store.getOrderIDs(*it);
+    pixels.push_back({it->getXiID(), it->getZetaID(), it->getEdep(), it->getQuality(),
+                      std::vector<int>(orderIDs, orderIDs + it->getSizeOfOrderID())});
+  }
+  return pixels;
+}
+
+void addHit(FPCCDData& data, int layer, int ladder, int xi, int zeta, float edep, int orderID, bool isSignal) {
+  FPCCDPixelHit hit(layer, ladder, xi, zeta, edep);
+  hit.setOrderID(orderID);
+  data.addPixelHit(hit, isSignal);
+}
+
+int floatWord(float value) {
+  int word;
+  std::memcpy(&word, &value, sizeof(word));
+  return word;
+}
+
+// Signal with two deposits in one pixel and pixels added out of order, background
+// with one pixel shared with the signal and two deposits in another pixel
+struct Overlay {
+  FPCCDData signal{2, 3}, background{2, 3};
+
+  Overlay() {
+    addHit(signal, 0, 1, 5, 10, 1.0f, 1, true);
+    addHit(signal, 0, 1, 5, 10, 0.5f, 2, true);
+    addHit(signal, 0, 1, 5, 3, 2.0f, 3, true);
+    addHit(signal, 1, 2, 0, 0, 4.0f, 4, true);
+
+    addHit(background, 0, 1, 5, 10, 0.25f, -1, false);
+    addHit(background, 0, 1, 7, 0, 8.0f, -1, false);
+    addHit(background, 0, 1, 7, 0, 1.0f, -2, false);
+  }
+};
+
+const std::vector<Pixel> expectedLadder01 = {
+    {5, 3, 2.0f, FPCCDPixelHit::kSingle, {3}},
+    {5, 10, 1.75f, FPCCDPixelHit::kBKGOverlap, {1, 2, -1}},
+    {7, 0, 9.0f, FPCCDPixelHit::kBKG, {-1, -2}},
+};
+const std::vector<Pixel> expectedLadder12 = {
+    {0, 0, 4.0f, FPCCDPixelHit::kSingle, {4}},
+};
+
+// many random deposits, enough to process the ladders in parallel
+void fillRandom(FPCCDData& data, std::mt19937& rng, int nHits, bool isSignal) {
+  for (int i = 0; i < nHits; ++i) {
+    FPCCDPixelHit hit(rng() % 6, rng() % 17, rng() % 100, rng() % 100, (rng() % 1000) * 0.001f);
+    for (unsigned k = rng() % 3; k > 0; --k)
+      hit.setOrderID(int(rng() % 100) - 1);
+    data.addPixelHit(hit, isSignal && rng() % 4 != 0);
+  }
+}
+
+// words of element i of an LCGenericObject collection
+std::vector<int> wordsOf(const IMPL::LCCollectionVec& col, int i) {
+  const auto* element = dynamic_cast<EVENT::LCGenericObject*>(col.getElementAt(i));
+  std::vector<int> words(element->getNInt());
+  for (int k = 0; k < element->getNInt(); ++k)
+    words[k] = element->getIntVal(k);
+  return words;
+}
+
+IMPL::LCGenericObjectImpl* elementOf(const std::vector<int>& words) {
+  auto* element = new IMPL::LCGenericObjectImpl;
+  for (unsigned k = 0; k < words.size(); ++k)
+    element->setIntVal(k, words[k]);
+  return element;
+}
+
+// library with the background of Overlay as first and the signal as second entry
+void writeLibrary(const std::string& fileName) {
+  std::remove(fileName.c_str());
+  Overlay overlay;
+  FPCCDPixelLibraryWriter writer(fileName, 2, 3);
+  writer.write(overlay.background);
+  writer.write(overlay.signal);
+  writer.flush();
+}
+
+std::vector<FPCCDPixelCluster> clustersOf(FPCCDData& data, bool diagonal) {
+  std::vector<FPCCDPixelCluster> clusters;
+  FPCCDClusterFinder(diagonal).findClusters(data, clusters);
+  return clusters;
+}
+
+bool sameClusters(const std::vector<FPCCDPixelCluster>& a, const std::vector<FPCCDPixelCluster>& b) {
+  if (a.size() != b.size())
+    return false;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (a[i].layer != b[i].layer || a[i].ladder != b[i].ladder || a[i].xi != b[i].xi || a[i].zeta != b[i].zeta ||
+        a[i].edep != b[i].edep || a[i].nPixels != b[i].nPixels || a[i].xiMin != b[i].xiMin ||
+        a[i].xiMax != b[i].xiMax || a[i].zetaMin != b[i].zetaMin || a[i].zetaMax != b[i].zetaMax ||
+        a[i].quality != b[i].quality)
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("FPCCDData_MergesDepositsInTheSamePixel", "[fpccd]") {
+  Overlay overlay;
+
+  REQUIRE(pixelsOf(overlay.signal, 0, 1) ==
+          std::vector<Pixel>({{5, 3, 2.0f, FPCCDPixelHit::kSingle, {3}},
+                              {5, 10, 1.5f, FPCCDPixelHit::kSignalOverlap, {1, 2}}}));
+  REQUIRE(pixelsOf(overlay.background, 0, 1) ==
+          std::vector<Pixel>({{5, 10, 0.25f, FPCCDPixelHit::kBKG, {-1}},
+                              {7, 0, 9.0f, FPCCDPixelHit::kBKG, {-1, -2}}}));
+}
+
+TEST_CASE("FPCCDData_AddBackground", "[fpccd]") {
+  Overlay overlay;
+  overlay.signal.Add(overlay.background);
+
+  REQUIRE(pixelsOf(overlay.signal, 0, 1) == expectedLadder01);
+  REQUIRE(pixelsOf(overlay.signal, 1, 2) == expectedLadder12);
+  REQUIRE(overlay.signal.getLadder(0, 0).empty());
+  REQUIRE(overlay.signal.getLadder(1, 1).empty());
+}
+
+TEST_CASE("FPCCDData_PackAndUnpack", "[fpccd]") {
+  Overlay overlay;
+  overlay.signal.Add(overlay.background);
+
+  IMPL::LCCollectionVec col(lcio::LCIO::LCGENERICOBJECT);
+  overlay.signal.packPixelHits(col);
+  REQUIRE(overlay.signal.sizeHint() == 0);
+
+  // one element per ladder with hits, all words written as one block
+  REQUIRE(col.getNumberOfElements() == 2);
+  const std::vector<int> expectedWords = {
+      0 << 8 | 1,
+      FPCCDPixelHit::kSingle << 29 | 5 << 16 | 3, floatWord(2.0f), 1, 3,
+      FPCCDPixelHit::kBKGOverlap << 29 | 5 << 16 | 10, floatWord(1.75f), 3, 1, 2, -1,
+      FPCCDPixelHit::kBKG << 29 | 7 << 16 | 0, floatWord(9.0f), 2, -1, -2,
+  };
+  REQUIRE(wordsOf(col, 0) == expectedWords);
+
+  FPCCDData unpacked(2, 3);
+  REQUIRE(unpacked.unpackPixelHits(col) == 4);
+  REQUIRE(pixelsOf(unpacked, 0, 1) == expectedLadder01);
+  REQUIRE(pixelsOf(unpacked, 1, 2) == expectedLadder12);
+}
+
+TEST_CASE("FPCCDData_UnpackTruncatedElement", "[fpccd]") {
+  // the second pixel claims more order IDs than the element holds
+  IMPL::LCCollectionVec col(lcio::LCIO::LCGENERICOBJECT);
+  col.addElement(elementOf({1 << 8 | 2, 5 << 16 | 3, floatWord(2.0f), 1, 3, 5 << 16 | 4, floatWord(1.0f), 4, 7}));
+
+  FPCCDData unpacked(2, 3);
+  REQUIRE(unpacked.unpackPixelHits(col) == 1);
+  REQUIRE(pixelsOf(unpacked, 1, 2) == std::vector<Pixel>({{5, 3, 2.0f, FPCCDPixelHit::kSingle, {3}}}));
+}
+
+TEST_CASE("FPCCDData_PackCompressed", "[fpccd]") {
+  Overlay overlay;
+  overlay.signal.Add(overlay.background);
+  IMPL::LCCollectionVec col(lcio::LCIO::LCGENERICOBJECT);
+  overlay.signal.setPackFormat(FPCCDData::kCompressedFormat);
+  overlay.signal.packPixelHits(col);
+
+  // cell, quality and order IDs are 1 to 3 bytes each, edep 4 bytes
+  const std::vector<int> words = wordsOf(col, 0);
+  REQUIRE(words.size() == 3 + 7);
+  REQUIRE(words[0] == (FPCCDData::kCompressedFormat << 16 | 0 << 8 | 1));
+  REQUIRE(words[1] == 3);
+  REQUIRE(words[2] == 0);
+
+  FPCCDData unpacked(2, 3);
+  REQUIRE(unpacked.unpackPixelHits(col) == 4);
+  REQUIRE(pixelsOf(unpacked, 0, 1) == expectedLadder01);
+  REQUIRE(pixelsOf(unpacked, 1, 2) == expectedLadder12);
+}
+
+TEST_CASE("FPCCDData_PackQuantised", "[fpccd]") {
+  Overlay overlay;
+  overlay.signal.Add(overlay.background);
+  IMPL::LCCollectionVec col(lcio::LCIO::LCGENERICOBJECT);
+  overlay.signal.setPackFormat(FPCCDData::kCompressedFormat, 0.5f);
+  overlay.signal.packPixelHits(col);
+  REQUIRE(wordsOf(col, 0)[2] == floatWord(0.5f));
+
+  // 1.75 is rounded to 2.0, the other deposits are multiples of the quantum
+  std::vector<Pixel> expected = expectedLadder01;
+  expected[1].edep = 2.0f;
+  FPCCDData unpacked(2, 3);
+  REQUIRE(unpacked.unpackPixelHits(col) == 4);
+  REQUIRE(pixelsOf(unpacked, 0, 1) == expected);
+  REQUIRE(pixelsOf(unpacked, 1, 2) == expectedLadder12);
+}
+
+TEST_CASE("FPCCDData_PackQuantisedLargeEdep", "[fpccd]") {
+  // beyond 2^31 quanta, stored as the largest value instead of overflowing
+  FPCCDData data(1, 1);
+  addHit(data, 0, 0, 1, 1, 1e12f, 1, true);
+  addHit(data, 0, 0, 1, 2, -1e12f, 2, true);
+  data.setPackFormat(FPCCDData::kCompressedFormat, 1.0f);
+  IMPL::LCCollectionVec col(lcio::LCIO::LCGENERICOBJECT);
+  data.packPixelHits(col);
+
+  FPCCDData unpacked(1, 1);
+  REQUIRE(unpacked.unpackPixelHits(col) == 2);
+  const std::vector<Pixel> pixels = pixelsOf(unpacked, 0, 0);
+  REQUIRE(pixels[0].edep == 2147483647.0f);
+  REQUIRE(pixels[1].edep == -2147483648.0f);
+}
+
+TEST_CASE("FPCCDData_UnpackTruncatedCompressedElement", "[fpccd]") {
+  Overlay overlay;
+  overlay.signal.Add(overlay.background);
+  overlay.signal.setPackFormat(FPCCDData::kCompressedFormat);
+  IMPL::LCCollectionVec packed(lcio::LCIO::LCGENERICOBJECT);
+  overlay.signal.packPixelHits(packed);
+
+  // without the last word the third pixel is incomplete
+  std::vector<int> words = wordsOf(packed, 0);
+  words.pop_back();
+  IMPL::LCCollectionVec col(lcio::LCIO::LCGENERICOBJECT);
+  col.addElement(elementOf(words));
+
+  FPCCDData unpacked(2, 3);
+  REQUIRE(unpacked.unpackPixelHits(col) == 2);
+  REQUIRE(pixelsOf(unpacked, 0, 1) == std::vector<Pixel>(expectedLadder01.begin(), expectedLadder01.begin() + 2));
+}
+
+TEST_CASE("FPCCDData_UnpackCompressedTooManyOrderIDs", "[fpccd]") {
+  // cell 5 with 16383 order IDs, more than the element has bytes
+  IMPL::LCCollectionVec col(lcio::LCIO::LCGENERICOBJECT);
+  col.addElement(elementOf({FPCCDData::kCompressedFormat << 16 | 0 << 8 | 1, 1, 0, 0x03FFFF05, 0}));
+
+  std::ostringstream messages;
+  std::streambuf* cerr = std::cerr.rdbuf(messages.rdbuf());
+  FPCCDData unpacked(2, 3);
+  const int nHits = unpacked.unpackPixelHits(col);
+  std::cerr.rdbuf(cerr);
+
+  REQUIRE(nHits == 0);
+  REQUIRE(messages.str() == "FPCCDData::unpackPixelHits: truncated compressed data for layer 0 ladder 1\n");
+}
+
+TEST_CASE("FPCCDData_UnpackUnknownVersion", "[fpccd]") {
+  // an element of a later format version is skipped, the others are read
+  IMPL::LCCollectionVec col(lcio::LCIO::LCGENERICOBJECT);
+  col.addElement(elementOf({2 << 16 | 0 << 8 | 1, 5 << 16 | 3, floatWord(2.0f), 1, 3}));
+  col.addElement(elementOf({1 << 8 | 2, 5 << 16 | 3, floatWord(2.0f), 1, 3}));
+
+  FPCCDData unpacked(2, 3);
+  REQUIRE(unpacked.unpackPixelHits(col) == 1);
+  REQUIRE(unpacked.getLadder(0, 1).empty());
+  REQUIRE(pixelsOf(unpacked, 1, 2) == std::vector<Pixel>({{5, 3, 2.0f, FPCCDPixelHit::kSingle, {3}}}));
+}
+
+TEST_CASE("FPCCDData_UnpackLadderOutOfRange", "[fpccd]") {
+  // elements for layer 2 and ladder 3 of a detector with 2 layers of 3 ladders are skipped, in both formats
+  IMPL::LCCollectionVec col(lcio::LCIO::LCGENERICOBJECT);
+  col.addElement(elementOf({2 << 8 | 0, 5 << 16 | 3, floatWord(2.0f), 1, 3}));
+  col.addElement(elementOf({0 << 8 | 3, 5 << 16 | 3, floatWord(2.0f), 1, 3}));
+  col.addElement(elementOf({FPCCDData::kCompressedFormat << 16 | 255 << 8 | 255, 1, 0, 0x00000403, 0}));
+  col.addElement(elementOf({1 << 8 | 2, 5 << 16 | 3, floatWord(2.0f), 1, 3}));
+
+  FPCCDData unpacked(2, 3);
+  REQUIRE(unpacked.unpackPixelHits(col) == 1);
+  REQUIRE(pixelsOf(unpacked, 1, 2) == std::vector<Pixel>({{5, 3, 2.0f, FPCCDPixelHit::kSingle, {3}}}));
+}
+
+TEST_CASE("FPCCDData_ParallelAddMatchesSerial", "[fpccd]") {
+  FPCCDData serial(6, 17), parallel(6, 17), background(6, 17);
+  std::mt19937 rng(7), sameRng(7);
+  fillRandom(serial, rng, 3000, true);
+  fillRandom(parallel, sameRng, 3000, true);
+  fillRandom(background, rng, 100000, false);
+
+  // above the size from which Add() distributes the ladders over the threads
+  REQUIRE(background.sizeHint() >= 65536);
+  serial.setNumberOfThreads(1);
+  parallel.setNumberOfThreads(4);
+  serial.Add(background);
+  parallel.Add(background);
+
+  for (int layer = 0; layer < 6; ++layer) {
+    for (int ladder = 0; ladder < 17; ++ladder) {
+      REQUIRE(pixelsOf(parallel, layer, ladder) == pixelsOf(serial, layer, ladder));
+    }
+  }
+}
+
+TEST_CASE("FPCCDClusterFinder_Connectivity", "[fpccd]") {
+  FPCCDData data(2, 3);
+  // two pixels sharing a corner
+  addHit(data, 1, 2, 1, 1, 1.0f, 1, true);
+  addHit(data, 1, 2, 2, 2, 1.0f, 2, true);
+  // an L of pixels sharing edges
+  addHit(data, 1, 2, 5, 5, 1.0f, 3, true);
+  addHit(data, 1, 2, 5, 6, 1.0f, 4, true);
+  addHit(data, 1, 2, 6, 6, 1.0f, 5, true);
+
+  std::vector<FPCCDPixelCluster> clusters = clustersOf(data, true);
+  REQUIRE(clusters.size() == 2);
+  REQUIRE(clusters[0].nPixels == 2);
+  REQUIRE(clusters[1].nPixels == 3);
+  REQUIRE(clusters[0].layer == 1);
+  REQUIRE(clusters[0].ladder == 2);
+
+  clusters = clustersOf(data, false);
+  REQUIRE(clusters.size() == 3);
+  REQUIRE(clusters[0].nPixels == 1);
+  REQUIRE(clusters[1].nPixels == 1);
+  REQUIRE(clusters[2].nPixels == 3);
+}
+
+TEST_CASE("FPCCDClusterFinder_Columns", "[fpccd]") {
+  FPCCDData data(1, 1);
+  // a row across three columns
+  addHit(data, 0, 0, 3, 10, 1.0f, 1, true);
+  addHit(data, 0, 0, 4, 10, 1.0f, 2, true);
+  addHit(data, 0, 0, 5, 10, 1.0f, 3, true);
+  // separated by an empty column, and by an empty pixel in the same column
+  addHit(data, 0, 0, 7, 10, 1.0f, 4, true);
+  addHit(data, 0, 0, 3, 12, 1.0f, 5, true);
+  // two pixels of column 20 only joined through column 21
+  addHit(data, 0, 0, 20, 0, 1.0f, 6, true);
+  addHit(data, 0, 0, 20, 2, 1.0f, 7, true);
+  addHit(data, 0, 0, 21, 0, 1.0f, 8, true);
+  addHit(data, 0, 0, 21, 1, 1.0f, 9, true);
+  addHit(data, 0, 0, 21, 2, 1.0f, 10, true);
+
+  for (bool diagonal : {true, false}) {
+    std::vector<FPCCDPixelCluster> clusters = clustersOf(data, diagonal);
+    // ordered by first pixel, sorted by xi and then zeta
+    REQUIRE(clusters.size() == 4);
+    REQUIRE(clusters[0].nPixels == 3);
+    REQUIRE(clusters[0].xiMin == 3);
+    REQUIRE(clusters[0].xiMax == 5);
+    REQUIRE(clusters[0].zetaMin == 10);
+    REQUIRE(clusters[0].zetaMax == 10);
+    REQUIRE(clusters[1].nPixels == 1);
+    REQUIRE(clusters[1].zetaMin == 12);
+    REQUIRE(clusters[2].nPixels == 1);
+    REQUIRE(clusters[2].xiMin == 7);
+    REQUIRE(clusters[3].nPixels == 5);
+    REQUIRE(clusters[3].xiMin == 20);
+    REQUIRE(clusters[3].xiMax == 21);
+    REQUIRE(clusters[3].zetaMin == 0);
+    REQUIRE(clusters[3].zetaMax == 2);
+  }
+}
+
+TEST_CASE("FPCCDClusterFinder_Centroid", "[fpccd]") {
+  SECTION("weighted by edep") {
+    FPCCDData data(1, 1);
+    addHit(data, 0, 0, 2, 3, 1.0f, 1, true);
+    addHit(data, 0, 0, 2, 4, 3.0f, 2, true);
+    addHit(data, 0, 0, 3, 4, 4.0f, 3, true);
+
+    std::vector<FPCCDPixelCluster> clusters = clustersOf(data, true);
+    REQUIRE(clusters.size() == 1);
+    REQUIRE(clusters[0].edep == 8.0f);
+    REQUIRE(clusters[0].xi == 2.5f);
+    REQUIRE(clusters[0].zeta == 3.875f);
+  }
+
+  SECTION("mean position without edep") {
+    FPCCDData data(1, 1);
+    addHit(data, 0, 0, 2, 3, 0.0f, 1, true);
+    addHit(data, 0, 0, 2, 4, 0.0f, 2, true);
+    addHit(data, 0, 0, 3, 4, 0.0f, 3, true);
+    addHit(data, 0, 0, 3, 5, 0.0f, 4, true);
+
+    std::vector<FPCCDPixelCluster> clusters = clustersOf(data, true);
+    REQUIRE(clusters.size() == 1);
+    REQUIRE(clusters[0].edep == 0.0f);
+    REQUIRE(clusters[0].xi == 2.5f);
+    REQUIRE(clusters[0].zeta == 4.0f);
+  }
+}
+
+TEST_CASE("FPCCDClusterFinder_Quality", "[fpccd]") {
+  FPCCDData data(1, 1);
+  // signal pixels
+  addHit(data, 0, 0, 0, 0, 1.0f, 1, true);
+  addHit(data, 0, 0, 0, 1, 1.0f, 2, true);
+  // signal pixels, one of them made by two hits
+  addHit(data, 0, 0, 10, 0, 1.0f, 3, true);
+  addHit(data, 0, 0, 10, 1, 1.0f, 4, true);
+  addHit(data, 0, 0, 10, 1, 1.0f, 5, true);
+  // a signal pixel next to a background pixel
+  addHit(data, 0, 0, 20, 0, 1.0f, 6, true);
+  addHit(data, 0, 0, 20, 1, 1.0f, -1, false);
+  // background pixels
+  addHit(data, 0, 0, 30, 0, 1.0f, -2, false);
+  addHit(data, 0, 0, 30, 1, 1.0f, -3, false);
+
+  std::vector<FPCCDPixelCluster> clusters = clustersOf(data, true);
+  REQUIRE(clusters.size() == 4);
+  REQUIRE(clusters[0].quality == FPCCDPixelHit::kSingle);
+  REQUIRE(clusters[1].quality == FPCCDPixelHit::kSignalOverlap);
+  REQUIRE(clusters[2].quality == FPCCDPixelHit::kBKGOverlap);
+  REQUIRE(clusters[3].quality == FPCCDPixelHit::kBKG);
+}
+
+TEST_CASE("FPCCDClusterFinder_ParallelMatchesSerial", "[fpccd]") {
+  FPCCDData data(6, 17);
+  std::mt19937 rng(11);
+  fillRandom(data, rng, 100000, true);
+
+  // above the size from which the ladders are distributed over the threads
+  REQUIRE(data.sizeHint() >= 65536);
+  data.setNumberOfThreads(1);
+  std::vector<FPCCDPixelCluster> serial = clustersOf(data, true);
+  data.setNumberOfThreads(4);
+  std::vector<FPCCDPixelCluster> parallel = clustersOf(data, true);
+
+  REQUIRE(serial.size() > 1000);
+  REQUIRE(sameClusters(parallel, serial));
+}
+
+TEST_CASE("FPCCDPixelLibrary_AddEntry", "[fpccd]") {
+  TemporaryFile file("TestFPCCDData_Library.bkg");
+  writeLibrary(file.name);
+
+  const FPCCDPixelLibrary library(file.name);
+  REQUIRE(library.getNLayers() == 2);
+  REQUIRE(library.getNLadders() == 3);
+  REQUIRE(library.getNumberOfEntries() == 2);
+  REQUIRE(library.getEndOfRecords() == std::filesystem::file_size(file.name));
+  REQUIRE(library.getEntry(0).getNPixels() == 2);
+
+  Overlay overlay;
+  overlay.signal.Add(library.getEntry(0));
+  REQUIRE(pixelsOf(overlay.signal, 0, 1) == expectedLadder01);
+  REQUIRE(pixelsOf(overlay.signal, 1, 2) == expectedLadder12);
+
+  REQUIRE_THROWS_AS(FPCCDPixelLibraryWriter(file.name, 2, 4), std::runtime_error);
+}
+
+TEST_CASE("FPCCDPixelLibrary_AppendAfterTornEntry", "[fpccd]") {
+  TemporaryFile file("TestFPCCDData_Torn.bkg");
+  writeLibrary(file.name);
+  std::filesystem::resize_file(file.name, std::filesystem::file_size(file.name) - 12);
+  REQUIRE(FPCCDPixelLibrary(file.name).getNumberOfEntries() == 1);
+
+  // the torn second entry is replaced by the appended one
+  {
+    Overlay overlay;
+    FPCCDPixelLibraryWriter writer(file.name, 2, 3);
+    writer.write(overlay.background);
+  }
+
+  const FPCCDPixelLibrary library(file.name);
+  REQUIRE(library.getNumberOfEntries() == 2);
+  REQUIRE(library.getEndOfRecords() == std::filesystem::file_size(file.name));
+  REQUIRE(library.getEntry(1).getNPixels() == 2);
+}
+
+TEST_CASE("FPCCDPixelLibrary_InconsistentEntry", "[fpccd]") {
+  using namespace FPCCDLibraryFormat;
+  TemporaryFile file("TestFPCCDData_Inconsistent.bkg");
+  const size_t entry = sizeof(FileHeader);
+
+  // layout of the first entry, the background of Overlay
+  EntryHeader header{};
+  header.headerSize = sizeof(EntryHeader);
+  header.nPixels = 2;
+  header.nOrderIDs = 3;
+  const EntryLayout layout = entryLayout(header, 2 * 3);
+
+  SECTION("record size of zero") {
+    writeLibrary(file.name);
+    patch<uint64_t>(file.name, entry + offsetof(EntryHeader, recordSize), 0);
+    REQUIRE_THROWS_AS(FPCCDPixelLibrary(file.name), std::runtime_error);
+  }
+
+  SECTION("entry smaller than its arrays") {
+    writeLibrary(file.name);
+    patch<uint32_t>(file.name, entry + offsetof(EntryHeader, nPixels), 1000);
+    REQUIRE_THROWS_AS(FPCCDPixelLibrary(file.name), std::runtime_error);
+  }
+
+  SECTION("ladder beyond the pixels") {
+    writeLibrary(file.name);
+    patch<uint32_t>(file.name, entry + layout.ladderBegin + 3 * sizeof(uint32_t), 3);
+    REQUIRE_THROWS_AS(FPCCDPixelLibrary(file.name), std::runtime_error);
+  }
+
+  SECTION("decreasing ladder begin") {
+    writeLibrary(file.name);
+    patch<uint32_t>(file.name, entry + layout.ladderBegin + 3 * sizeof(uint32_t), 1);
+    REQUIRE_THROWS_AS(FPCCDPixelLibrary(file.name), std::runtime_error);
+  }
+
+  SECTION("order IDs beyond the entry") {
+    writeLibrary(file.name);
+    patch<uint32_t>(file.name, entry + layout.pixels + offsetof(FPCCDPixel, orderBegin), 3);
+    REQUIRE_THROWS_AS(FPCCDPixelLibrary(file.name), std::runtime_error);
+  }
+
+  SECTION("pixels of a ladder not sorted by cell") {
+    writeLibrary(file.name);
+    patch<uint32_t>(file.name, entry + layout.pixels + sizeof(FPCCDPixel) + offsetof(FPCCDPixel, cellWord), 5 << 16 | 10);
+    REQUIRE_THROWS_AS(FPCCDPixelLibrary(file.name), std::runtime_error);
+  }
+
+  SECTION("unknown hit quality") {
+    writeLibrary(file.name);
+    patch<uint32_t>(file.name, entry + layout.pixels + offsetof(FPCCDPixel, quality), 4);
+    REQUIRE_THROWS_AS(FPCCDPixelLibrary(file.name), std::runtime_error);
+  }
+}
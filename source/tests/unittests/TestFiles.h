@@ -0,0 +1,32 @@
+#ifndef TestFiles_h
+#define TestFiles_h 1
+
+// file helpers for the unit tests of the binary file formats
+
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace TestHelpers {
+// file name in the temporary directory, removed at the end of the test
+struct TemporaryFile {
+  const std::string name;
+  explicit TemporaryFile(const std::string& fileName)
+      : name((std::filesystem::temp_directory_path() / fileName).string()) {
+    std::remove(name.c_str());
+  }
+  ~TemporaryFile() { std::remove(name.c_str()); }
+};
+
+// overwrite the bytes at pos with value
+template <typename T>
+void patch(const std::string& fileName, std::size_t pos, T value) {
+  std::fstream file(fileName, std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(pos);
+  file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+} // namespace TestHelpers
+
+#endif
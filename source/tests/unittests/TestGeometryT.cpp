@@ -0,0 +1,111 @@
+#include "LCCylinder.h"
+#include "LCLine3D.h"
+#include "LCPlane3D.h"
+#include "LineClass.h"
+
+#include "CircleT.h"
+#include "LCCylinderT.h"
+#include "LCLine3DT.h"
+#include "LCPlane3DT.h"
+#include "LineClassT.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// The templated geometry classes should give the same results as the CLHEP
+// based ones they are modelled on
+TEMPLATE_TEST_CASE("LCLine3DT_vs_LCLine3D", "[geometry-templates]", float, double) {
+  using Vec = Vector3T<TestType>;
+
+  const LCLine3D line(LCVector3D(1., 2., 3.), LCVector3D(0.3, -0.4, 1.2));
+  const LCLine3DT<TestType> lineT(Vec(1, 2, 3), Vec(0.3, -0.4, 1.2));
+
+  const LCVector3D point(-5., 7., 11.);
+  const auto pointT = Vec::from(point);
+
+  REQUIRE(lineT.projectPoint(pointT) == Catch::Approx(line.projectPoint(point)).epsilon(1e-5));
+  REQUIRE(lineT.distance(pointT) == Catch::Approx(line.distance(point)).epsilon(1e-5));
+
+  const LCPlane3D plane(LCVector3D(1., 1., 1.), LCVector3D(0., 0., 4.));
+  const LCPlane3DT<TestType> planeT(Vec(1, 1, 1), Vec(0, 0, 4));
+  REQUIRE(planeT.distance(pointT) == Catch::Approx(plane.distance(point)).epsilon(1e-5));
+
+  bool exists = false, existsT = false;
+  const double s = line.intersectionWithPlane(plane, exists);
+  const TestType sT = lineT.intersectionWithPlane(planeT, existsT);
+  REQUIRE(exists == existsT);
+  REQUIRE(sT == Catch::Approx(s).epsilon(1e-5));
+}
+
+TEMPLATE_TEST_CASE("LCCylinderT_vs_LCCylinder", "[geometry-templates]", float, double) {
+  using Vec = Vector3T<TestType>;
+
+  for (bool endPlane : {false, true}) {
+    const LCCylinder cylinder(LCVector3D(1., 0., 0.), LCVector3D(3., 0., 0.), 1., endPlane);
+    const LCCylinderT<TestType> cylinderT(Vec(1, 0, 0), Vec(3, 0, 0), 1, endPlane);
+
+    for (const auto& point : {LCVector3D(0.9, 0.1, 0.), LCVector3D(2., 0.5, 0.2), LCVector3D(3.5, 2., -1.),
+                              LCVector3D(1.1, 0.2, 0.3)}) {
+      int code = -1, codeT = -1;
+      const LCVector3D proj = cylinder.projectPoint(point, code);
+      const auto projT = cylinderT.projectPoint(Vec::from(point), codeT);
+
+      REQUIRE(code == codeT);
+      REQUIRE(projT.x() == Catch::Approx(proj.x()).margin(1e-5));
+      REQUIRE(projT.y() == Catch::Approx(proj.y()).margin(1e-5));
+      REQUIRE(projT.z() == Catch::Approx(proj.z()).margin(1e-5));
+      REQUIRE(cylinderT.isInside(Vec::from(point)) == cylinder.isInside(point));
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("LineClassT_vs_LineClass", "[geometry-templates]", float, double) {
+  using Vec = Vector3T<TestType>;
+
+  float x0[3] = {1.f, -2.f, 0.5f};
+  float ax[3] = {0.f, 3.f, 4.f};
+  LineClass line(x0, ax);
+  const LineClassT<TestType> lineT(Vec(1, -2, 0.5), Vec(0, 3, 4));
+
+  for (const auto& p : {Vec(1, -2, 0.5), Vec(4, 1, 2), Vec(-3, 7, -6)}) {
+    float point[3] = {float(p.x()), float(p.y()), float(p.z())};
+    float pos[3];
+    const float dist = line.getDistanceToPoint(point, pos);
+
+    Vec posT;
+    REQUIRE(lineT.getDistanceToPoint(p, posT) == Catch::Approx(dist).margin(1e-5));
+    REQUIRE(posT.x() == Catch::Approx(pos[0]).margin(1e-5));
+    REQUIRE(posT.y() == Catch::Approx(pos[1]).margin(1e-5));
+    REQUIRE(posT.z() == Catch::Approx(pos[2]).margin(1e-5));
+  }
+
+  // the point of closest approach of (1, 5, 1.5) is x0 + ax, at distance 5
+  TestType point[3] = {1, 5, 1.5};
+  TestType pos[3];
+  REQUIRE(lineT.getDistanceToPoint(point, pos) == Catch::Approx(5).epsilon(1e-5));
+  REQUIRE(pos[0] == Catch::Approx(1).epsilon(1e-5));
+  REQUIRE(pos[1] == Catch::Approx(1).epsilon(1e-5));
+  REQUIRE(pos[2] == Catch::Approx(4.5).epsilon(1e-5));
+}
+
+TEMPLATE_TEST_CASE("CircleT_ThroughThreePoints", "[geometry-templates]", float, double) {
+  using Vec = Vector3T<TestType>;
+
+  // points on the circle around (1, 2) with radius 5, z is ignored
+  const CircleT<TestType> circle(Vec(6, 2, 1), Vec(1, 7, -3), Vec(-2, -2, 10));
+  REQUIRE(circle.GetRadius() == Catch::Approx(5).epsilon(1e-5));
+  REQUIRE(circle.GetCenter().x() == Catch::Approx(1).epsilon(1e-5));
+  REQUIRE(circle.GetCenter().y() == Catch::Approx(2).epsilon(1e-5));
+
+  // the same circle far from the origin
+  const CircleT<TestType> shifted(Vec(106, 202, 0), Vec(101, 207, 0), Vec(98, 198, 0));
+  REQUIRE(shifted.GetRadius() == Catch::Approx(5).epsilon(1e-4));
+  REQUIRE(shifted.GetCenter().x() == Catch::Approx(101).epsilon(1e-5));
+  REQUIRE(shifted.GetCenter().y() == Catch::Approx(202).epsilon(1e-5));
+
+  // colinear and coinciding points give no circle
+  REQUIRE(CircleT<TestType>(Vec(0, 0, 0), Vec(1, 1, 0), Vec(3, 3, 0)).GetRadius() == -1);
+  REQUIRE(CircleT<TestType>(Vec(1, 1, 0), Vec(1, 1, 0), Vec(2, 3, 0)).GetRadius() == -1);
+  REQUIRE(CircleT<TestType>().GetRadius() == -1);
+}
@@ -0,0 +1,99 @@
+#include "MCBalance.h"
+#include "MarlinUtil.h"
+
+#include <IMPL/LCCollectionVec.h>
+#include <IMPL/LCEventImpl.h>
+#include <IMPL/MCParticleImpl.h>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+namespace {
+// Stable particles: a charged pion and an electron close to the beam axis, a charged pion, a
+// photon, a K0 and a neutralino in the barrel. The decayed parent of the photon is not counted.
+struct BalanceEvent {
+  IMPL::LCEventImpl evt;
+  IMPL::LCCollectionVec* mcParticles = new IMPL::LCCollectionVec(lcio::LCIO::MCPARTICLE);
+
+  enum { forwardPion, forwardElectron, pion, photon, kaon, neutralino, pi0, nParticles };
+  std::vector<IMPL::MCParticleImpl*> particles;
+
+  BalanceEvent() {
+    evt.addCollection(mcParticles, "MCParticle");
+    add(211, 1.f, {0.05, 0., 5.});
+    add(11, -1.f, {0., -0.1, -8.});
+    add(-211, -1.f, {3., 0., 1.});
+    add(22, 0.f, {0., 2., 0.5});
+    add(311, 0.f, {-1., 1., 0.});
+    add(1000022, 0.f, {0., 1., 0.}, 50.);
+    add(111, 0.f, {0., 2., 0.5}, 0.135, 2);
+    particles[photon]->addParent(particles[pi0]);
+  }
+
+  void add(int pdg, float charge, std::vector<double> mom, double mass = 0., int generatorStatus = 1) {
+    auto* mcp = new IMPL::MCParticleImpl;
+    mcp->setPDG(pdg);
+    mcp->setCharge(charge);
+    mcp->setMass(mass);
+    mcp->setMomentum(mom.data());
+    mcp->setGeneratorStatus(generatorStatus);
+    mcParticles->addElement(mcp);
+    particles.push_back(mcp);
+  }
+
+  double energy(int i) const { return particles[i]->getEnergy(); }
+};
+} // namespace
+
+TEST_CASE("MCBalance_LegacyCategories", "[mcbalance]") {
+  const BalanceEvent event;
+  MarlinUtil::MCBalance balance(MarlinUtil::MCBalance::legacyCategories());
+  const MarlinUtil::MCBalance::Result result = balance.compute(event.mcParticles);
+  const auto& sums = result.categories;
+
+  // the beam tube comes first, whatever the particle
+  REQUIRE(sums[MarlinUtil::MCBalance::beamTube].n == 2);
+  REQUIRE(sums[MarlinUtil::MCBalance::beamTube].energy ==
+          Catch::Approx(event.energy(BalanceEvent::forwardPion) + event.energy(BalanceEvent::forwardElectron)));
+  REQUIRE(sums[MarlinUtil::MCBalance::electrons].n == 0);
+  REQUIRE(sums[MarlinUtil::MCBalance::photons].n == 1);
+
+  // the neutral neutralino counts as charged hadron, only K0 is left over
+  REQUIRE(sums[MarlinUtil::MCBalance::chargedHadrons].n == 2);
+  REQUIRE(sums[MarlinUtil::MCBalance::chargedHadrons].energy ==
+          Catch::Approx(event.energy(BalanceEvent::pion) + event.energy(BalanceEvent::neutralino)));
+  REQUIRE(result.unclassifiedPDGCodes == std::vector<int>{311});
+  REQUIRE(result.unclassified.energy == Catch::Approx(event.energy(BalanceEvent::kaon)));
+}
+
+TEST_CASE("MCBalance_GetMC_Balance", "[mcbalance]") {
+  BalanceEvent event;
+  double accumulatedEnergies[21] = {};
+  MarlinUtil::getMC_Balance(&event.evt, accumulatedEnergies);
+
+  REQUIRE(accumulatedEnergies[1] ==
+          Catch::Approx(event.energy(BalanceEvent::forwardPion) + event.energy(BalanceEvent::forwardElectron)));
+  REQUIRE(accumulatedEnergies[11] == 2);
+  REQUIRE(accumulatedEnergies[3] == 0.);
+  REQUIRE(accumulatedEnergies[5] == Catch::Approx(event.energy(BalanceEvent::photon)));
+  REQUIRE(accumulatedEnergies[9] ==
+          Catch::Approx(event.energy(BalanceEvent::pion) + event.energy(BalanceEvent::neutralino)));
+  REQUIRE(accumulatedEnergies[19] == 2);
+  REQUIRE(accumulatedEnergies[6] == 0.);
+}
+
+TEST_CASE("MCBalance_DefaultCategories", "[mcbalance]") {
+  BalanceEvent event;
+  const MarlinUtil::MCEnergyBalance b = MarlinUtil::getMCEnergyBalance(&event.evt);
+
+  REQUIRE(b.nBeamTube == 2);
+  REQUIRE(b.nPhotons == 1);
+
+  // only charged particles are charged hadrons, the neutralino is unclassified like the K0
+  REQUIRE(b.nChargedHadrons == 1);
+  REQUIRE(b.chargedHadronEnergy == Catch::Approx(event.energy(BalanceEvent::pion)));
+  REQUIRE(b.unclassifiedPDGCodes == std::vector<int>{311, 1000022});
+  REQUIRE(b.totalEnergy == Catch::Approx(event.energy(BalanceEvent::pion) + event.energy(BalanceEvent::photon)));
+}
@@ -0,0 +1,213 @@
+#include "MCGraphFile.h"
+#include "MCGraphWriter.h"
+#include "TestFiles.h"
+#include "TestTrueJets.h"
+
+#include <IMPL/LCCollectionVec.h>
+#include <IMPL/LCEventImpl.h>
+#include <IMPL/MCParticleImpl.h>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using TestHelpers::TemporaryFile;
+using TestHelpers::patch;
+
+namespace {
+// Event with a particle that has two parents: 0 -> 1, 2 ; 1 -> 3 ; 2 -> 3
+struct TestEvent {
+  IMPL::LCEventImpl evt;
+  IMPL::LCCollectionVec* mcParticles = new IMPL::LCCollectionVec(lcio::LCIO::MCPARTICLE);
+  std::vector<IMPL::MCParticleImpl*> particles;
+
+  TestEvent(int run, int event) {
+    evt.setRunNumber(run);
+    evt.setEventNumber(event);
+    evt.addCollection(mcParticles, "MCParticle");
+
+    for (int i = 0; i < 4; ++i) {
+      auto* mcp = new IMPL::MCParticleImpl;
+      const double mom[3] = {1. + i, -2. * i, 0.5};
+      const double vtx[3] = {0.1 * i, 0., -3. * i};
+      mcp->setMomentum(mom);
+      mcp->setMass(0.1 * i);
+      mcp->setVertex(vtx);
+      mcp->setPDG(211 + i);
+      mcp->setGeneratorStatus(i == 3 ? 1 : 2);
+      mcp->setSimulatorStatus(10 * i);
+      mcParticles->addElement(mcp);
+      particles.push_back(mcp);
+    }
+    particles[1]->addParent(particles[0]);
+    particles[2]->addParent(particles[0]);
+    particles[3]->addParent(particles[1]);
+    particles[3]->addParent(particles[2]);
+  }
+};
+
+void writeEvents(const std::string& fileName) {
+  std::remove(fileName.c_str());
+  MarlinUtil::MCGraphWriter writer(fileName);
+  TestEvent first(1, 7), second(1, 8);
+  writer.write(&first.evt, first.mcParticles);
+  writer.write(&second.evt, second.mcParticles);
+  writer.flush();
+}
+
+} // namespace
+
+TEST_CASE("MCGraphFile_RoundTrip", "[mcgraph]") {
+  TemporaryFile file("TestMCGraphFile_RoundTrip.mcgraph");
+  writeEvents(file.name);
+
+  const MarlinUtil::MCGraphReader reader(file.name);
+  REQUIRE(reader.getNumberOfEvents() == 2);
+  REQUIRE(reader.getEndOfRecords() == std::filesystem::file_size(file.name));
+
+  const TestEvent expected(1, 7);
+  for (size_t e = 0; e < 2; ++e) {
+    const MarlinUtil::MCGraphReader::Event event = reader.getEvent(e);
+    REQUIRE(event.header->runNumber == 1);
+    REQUIRE(event.header->eventNumber == int(7 + e));
+    REQUIRE(event.size() == 4);
+    REQUIRE(event.trueJet == nullptr);
+
+    for (unsigned i = 0; i < event.size(); ++i) {
+      const auto* mcp = expected.particles[i];
+      REQUIRE(event.px[i] == mcp->getMomentum()[0]);
+      REQUIRE(event.py[i] == mcp->getMomentum()[1]);
+      REQUIRE(event.pz[i] == mcp->getMomentum()[2]);
+      REQUIRE(event.energy[i] == Catch::Approx(mcp->getEnergy()));
+      REQUIRE(event.mass[i] == Catch::Approx(mcp->getMass()));
+      REQUIRE(event.vz[i] == mcp->getVertex()[2]);
+      REQUIRE(event.pdg[i] == mcp->getPDG());
+      REQUIRE(event.generatorStatus[i] == mcp->getGeneratorStatus());
+      REQUIRE(event.simulatorStatus[i] == mcp->getSimulatorStatus());
+    }
+
+    REQUIRE(event.numberOfParents(0) == 0);
+    REQUIRE(event.numberOfParents(3) == 2);
+    REQUIRE(event.parents[event.parentOffsets[3]] == 1);
+    REQUIRE(event.parents[event.parentOffsets[3] + 1] == 2);
+    REQUIRE(event.numberOfDaughters(0) == 2);
+    REQUIRE(event.daughters[event.daughterOffsets[0]] == 1);
+    REQUIRE(event.daughters[event.daughterOffsets[0] + 1] == 2);
+    REQUIRE(event.numberOfDaughters(3) == 0);
+  }
+}
+
+TEST_CASE("MCGraphFile_EmptyTrueJets", "[mcgraph]") {
+  TemporaryFile file("TestMCGraphFile_EmptyTrueJets.mcgraph");
+  TestEvent event(1, 7);
+  event.evt.addCollection(new IMPL::LCCollectionVec(lcio::LCIO::RECONSTRUCTEDPARTICLE), "TrueJets");
+
+  // an event without true jets has none of the link collections either
+  TestHelpers::TrueJets trueJets;
+  trueJets.getall(&event.evt);
+  REQUIRE(trueJets.njets() == 0);
+  {
+    MarlinUtil::MCGraphWriter writer(file.name);
+    writer.write(&event.evt, event.mcParticles, &trueJets);
+  }
+  trueJets.delall();
+
+  const MarlinUtil::MCGraphReader reader(file.name);
+  REQUIRE(reader.getNumberOfEvents() == 1);
+  const MarlinUtil::MCGraphReader::Event written = reader.getEvent(0);
+  REQUIRE(written.trueJet != nullptr);
+  for (unsigned i = 0; i < written.size(); ++i) {
+    REQUIRE(written.trueJet[i] == -1);
+  }
+}
+
+TEST_CASE("MCGraphFile_TruncatedFile", "[mcgraph]") {
+  TemporaryFile file("TestMCGraphFile_Truncated.mcgraph");
+  writeEvents(file.name);
+
+  size_t firstRecordEnd = 0;
+  {
+    const MarlinUtil::MCGraphReader reader(file.name);
+    firstRecordEnd = sizeof(MarlinUtil::MCGraph::FileHeader) + reader.getEvent(0).header->recordSize;
+  }
+
+  // a job that did not finish leaves a torn last record, which is ignored
+  std::filesystem::resize_file(file.name, std::filesystem::file_size(file.name) - 12);
+  {
+    const MarlinUtil::MCGraphReader reader(file.name);
+    REQUIRE(reader.getNumberOfEvents() == 1);
+    REQUIRE(reader.getEndOfRecords() == firstRecordEnd);
+    REQUIRE(reader.getEvent(0).header->eventNumber == 7);
+  }
+
+  std::filesystem::resize_file(file.name, firstRecordEnd + 4);
+  REQUIRE(MarlinUtil::MCGraphReader(file.name).getNumberOfEvents() == 1);
+
+  std::filesystem::resize_file(file.name, sizeof(MarlinUtil::MCGraph::FileHeader));
+  REQUIRE(MarlinUtil::MCGraphReader(file.name).getNumberOfEvents() == 0);
+
+  std::filesystem::resize_file(file.name, 4);
+  REQUIRE_THROWS_AS(MarlinUtil::MCGraphReader(file.name), std::runtime_error);
+}
+
+TEST_CASE("MCGraphFile_AppendAfterTornRecord", "[mcgraph]") {
+  TemporaryFile file("TestMCGraphFile_Append.mcgraph");
+  writeEvents(file.name);
+  std::filesystem::resize_file(file.name, std::filesystem::file_size(file.name) - 12);
+
+  // the torn record of event 8 is replaced by the appended event
+  {
+    MarlinUtil::MCGraphWriter writer(file.name);
+    TestEvent third(1, 9);
+    writer.write(&third.evt, third.mcParticles);
+  }
+
+  const MarlinUtil::MCGraphReader reader(file.name);
+  REQUIRE(reader.getNumberOfEvents() == 2);
+  REQUIRE(reader.getEndOfRecords() == std::filesystem::file_size(file.name));
+  REQUIRE(reader.getEvent(0).header->eventNumber == 7);
+  REQUIRE(reader.getEvent(1).header->eventNumber == 9);
+  REQUIRE(reader.getEvent(1).numberOfParents(3) == 2);
+}
+
+TEST_CASE("MCGraphFile_InconsistentHeaders", "[mcgraph]") {
+  using namespace MarlinUtil::MCGraph;
+  TemporaryFile file("TestMCGraphFile_Inconsistent.mcgraph");
+  const size_t record = sizeof(FileHeader);
+
+  SECTION("file header smaller than FileHeader") {
+    writeEvents(file.name);
+    patch<uint32_t>(file.name, offsetof(FileHeader, headerSize), 0);
+    REQUIRE_THROWS_AS(MarlinUtil::MCGraphReader(file.name), std::runtime_error);
+  }
+
+  SECTION("record size of zero") {
+    writeEvents(file.name);
+    patch<uint64_t>(file.name, record + offsetof(EventHeader, recordSize), 0);
+    REQUIRE_THROWS_AS(MarlinUtil::MCGraphReader(file.name), std::runtime_error);
+  }
+
+  SECTION("record header smaller than EventHeader") {
+    writeEvents(file.name);
+    patch<uint32_t>(file.name, record + offsetof(EventHeader, headerSize), 8);
+    REQUIRE_THROWS_AS(MarlinUtil::MCGraphReader(file.name), std::runtime_error);
+  }
+
+  SECTION("record smaller than its columns") {
+    writeEvents(file.name);
+    patch<uint32_t>(file.name, record + offsetof(EventHeader, nParticles), 1000);
+    REQUIRE_THROWS_AS(MarlinUtil::MCGraphReader(file.name), std::runtime_error);
+  }
+
+  SECTION("columns not matching the header") {
+    writeEvents(file.name);
+    patch<uint32_t>(file.name, record + offsetof(EventHeader, nParticles), 2);
+    REQUIRE_THROWS_AS(MarlinUtil::MCGraphReader(file.name), std::runtime_error);
+  }
+}
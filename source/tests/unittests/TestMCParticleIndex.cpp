@@ -0,0 +1,78 @@
+#include "MCParticleIndex.h"
+#include "MarlinUtil.h"
+
+#include <IMPL/MCParticleImpl.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+// Small decay chain with a particle that has two parents:
+//   0 -> 1, 2 ; 1 -> 3, 4 ; 2 -> 4 ; 4 -> 5
+struct TestGraph {
+  std::vector<std::unique_ptr<IMPL::MCParticleImpl>> owned;
+  lcio::MCParticleVec particles;
+
+  TestGraph() {
+    for (int i = 0; i < 6; ++i) {
+      owned.emplace_back(new IMPL::MCParticleImpl);
+      particles.push_back(owned.back().get());
+    }
+    owned[1]->setGeneratorStatus(1);
+    owned[2]->setGeneratorStatus(2);
+    link(1, 0);
+    link(2, 0);
+    link(3, 1);
+    link(4, 1);
+    link(4, 2);
+    link(5, 4);
+  }
+
+  void link(int daughter, int parent) { owned[daughter]->addParent(owned[parent].get()); }
+};
+} // namespace
+
+TEST_CASE("MCParticleIndex_MatchesRecursiveQueries", "[mcparticleindex]") {
+  TestGraph graph;
+  const auto& p = graph.particles;
+  const MarlinUtil::MCParticleIndex index(p);
+
+  REQUIRE(index.size() == p.size());
+  REQUIRE_FALSE(index.hasCycles());
+
+  for (auto* daughter : p) {
+    for (auto* parent : p) {
+      REQUIRE(index.isDaughterOf(daughter, parent) == MarlinUtil::isDaughterOf(daughter, parent));
+    }
+  }
+
+  for (auto* mcp : p) {
+    auto fast = MarlinUtil::getAllMCDaughters(mcp, index);
+    auto slow = MarlinUtil::getAllMCDaughters(mcp);
+    REQUIRE(fast.front() == mcp);
+    std::sort(fast.begin(), fast.end());
+    std::sort(slow.begin(), slow.end());
+    slow.erase(std::unique(slow.begin(), slow.end()), slow.end());
+    REQUIRE(fast == slow);
+  }
+
+  // 5 descends from the stable particle 1 and, via 2, from the root 0
+  const lcio::MCParticleVec parents = MarlinUtil::getAllMCParents(p[5], index);
+  REQUIRE(parents == lcio::MCParticleVec({p[1], p[0]}));
+}
+
+TEST_CASE("MCParticleIndex_DetectsLoops", "[mcparticleindex]") {
+  TestGraph graph;
+  const auto& p = graph.particles;
+  graph.link(1, 5);
+
+  const MarlinUtil::MCParticleIndex index(p);
+
+  REQUIRE(index.hasCycles());
+  REQUIRE(index.getNumberOfCycleLinks() == 1);
+  REQUIRE(index.isDaughterOf(p[5], p[0]));
+  REQUIRE_FALSE(index.isDaughterOf(p[0], p[5]));
+}
@@ -0,0 +1,114 @@
+#include "MCTree.h"
+
+#include <IMPL/LCCollectionVec.h>
+#include <IMPL/MCParticleImpl.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+// Particle 3 has two parents: 0 -> 1, 2 ; 1 -> 3 ; 2 -> 3 ; 3 -> 4.
+// The energies fall along the tree, 10, 5, 4, 3 and 0.5 GeV.
+struct TestTree {
+  IMPL::LCCollectionVec col{lcio::LCIO::MCPARTICLE};
+  std::vector<IMPL::MCParticleImpl*> particles;
+
+  TestTree() {
+    const double energies[5] = {10., 5., 4., 3., 0.5};
+    for (int i = 0; i < 5; ++i) {
+      auto* mcp = new IMPL::MCParticleImpl;
+      const double mom[3] = {energies[i], 0., 0.};
+      mcp->setMomentum(mom);
+      mcp->setPDG(100 + i);
+      col.addElement(mcp);
+      particles.push_back(mcp);
+    }
+    particles[1]->addParent(particles[0]);
+    particles[2]->addParent(particles[0]);
+    particles[3]->addParent(particles[1]);
+    particles[3]->addParent(particles[2]);
+    particles[4]->addParent(particles[3]);
+  }
+};
+
+// one printed line: collection index, generation below the first particle and whether the
+// particle only refers to an earlier line
+struct Line {
+  int index;
+  int depth;
+  bool seeAbove;
+  bool operator==(const Line& other) const {
+    return index == other.index && depth == other.depth && seeAbove == other.seeAbove;
+  }
+};
+
+struct Printout {
+  std::vector<Line> lines;
+  std::string summary;
+};
+
+Printout printTree(TestTree& tree, const MCTree::PrintOptions& options) {
+  std::ostringstream out;
+  MCTree(&tree.col).printTree(out, options);
+
+  Printout printout;
+  std::istringstream in(out.str());
+  std::string text;
+  while (std::getline(in, text)) {
+    if (text.find(" MC particles printed") != std::string::npos) {
+      printout.summary = text;
+      continue;
+    }
+    // "<index>  <4 blanks per generation>\-> <pdg>", the arrow is missing for the first particles
+    std::istringstream fields(text);
+    int index = -1;
+    if (!(fields >> index)) continue;
+    const size_t indentBegin = text.find_first_of(' ', text.find_first_not_of(' ')) + 2;
+    const size_t arrow = text.find("\\-> ");
+    const int depth = arrow == std::string::npos ? 0 : int(arrow - indentBegin) / 4;
+    printout.lines.push_back({index, depth, text.find("(see above)") != std::string::npos});
+  }
+  return printout;
+}
+} // namespace
+
+TEST_CASE("MCTree_PrintTree", "[mctree]") {
+  TestTree tree;
+  const Printout printout = printTree(tree, MCTree::PrintOptions());
+
+  // particle 3 is printed with its daughter below its first parent only
+  const std::vector<Line> expected = {{0, 0, false}, {1, 1, false}, {3, 2, false},
+                                      {4, 3, false}, {2, 1, false}, {3, 2, true}};
+  REQUIRE(printout.lines == expected);
+  REQUIRE(printout.summary == " 5 of 5 MC particles printed");
+}
+
+TEST_CASE("MCTree_PrintTreeMaxDepth", "[mctree]") {
+  TestTree tree;
+  MCTree::PrintOptions options;
+  options.maxDepth = 1;
+  const Printout printout = printTree(tree, options);
+
+  const std::vector<Line> expected = {{0, 0, false}, {1, 1, false}, {2, 1, false}};
+  REQUIRE(printout.lines == expected);
+  REQUIRE(printout.summary == " 3 of 5 MC particles printed");
+}
+
+TEST_CASE("MCTree_PrintTreeMinEnergy", "[mctree]") {
+  TestTree tree;
+  MCTree::PrintOptions options;
+
+  // particles below the cut are skipped with all their daughters
+  options.minEnergy = 4.5;
+  Printout printout = printTree(tree, options);
+  REQUIRE(printout.lines == std::vector<Line>{{0, 0, false}, {1, 1, false}});
+  REQUIRE(printout.summary == " 2 of 5 MC particles printed");
+
+  options.minEnergy = 20.;
+  printout = printTree(tree, options);
+  REQUIRE(printout.lines.empty());
+  REQUIRE(printout.summary == " 0 of 5 MC particles printed");
+}
@@ -0,0 +1,168 @@
+#include "mille/Mille.h"
+#include "mille/MilleSinks.h"
+#include "TestFiles.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using TestHelpers::TemporaryFile;
+
+namespace {
+std::string contentOf(const std::string& fileName) {
+  std::ifstream file(fileName, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// records of one event: event % 3 tracks of up to 5 measurements, every
+// fifth track with special values and every 50th event with a long track
+template <class Writer>
+void writeEvent(Writer& writer, int event) {
+  const float derLc[3] = {1.f, 0.5f, 0.f};
+  for (int track = 0; track < event % 3; ++track) {
+    if ((event + track) % 5 == 0) {
+      const float floatings[2] = {float(event), 2.f};
+      const int integers[2] = {track, -1};
+      writer.special(2, floatings, integers);
+    }
+    const int nMeas = event % 50 == 0 ? 400 : 1 + (event + track) % 5;
+    for (int m = 0; m < nMeas; ++m) {
+      const float derGl[4] = {float(m % 3), 1.f, 0.f, -2.f};
+      const int label[4] = {1 + m, 100 + event % 7, 200, 300 + track};
+      writer.mille(3, derLc, 4, derGl, label, 0.01f * event, 0.1f);
+    }
+    writer.end();
+  }
+}
+
+const int nEvents = 1000;
+} // namespace
+
+TEST_CASE("Mille_LongRecord", "[mille]") {
+  // records longer than the initial 5000 pairs of the buffer, with output
+  // blocks larger and smaller than a record
+  const int nMeasurements = 1000;
+  const int nPairs = 1 + 7 * nMeasurements; // error count, rMeas, 2 local, sigma, 3 global
+  for (unsigned int blockSize : {1u << 22, 1024u}) {
+    TemporaryFile file("TestMille_LongRecord.bin");
+    {
+      Mille mille(file.name.c_str(), true);
+      mille.setBlockSize(blockSize);
+      for (int r = 0; r < 3; ++r) {
+        for (int m = 0; m < nMeasurements; ++m) {
+          const float derLc[2] = {1.f, 0.5f};
+          const float derGl[3] = {1.f + r, 2.f, -1.f};
+          const int label[3] = {10, 20 + m, 1000 + r};
+          mille.mille(2, derLc, 3, derGl, label, 0.25f * m, 0.5f);
+        }
+        mille.end();
+      }
+    }
+
+    // each record is its length in words, the floats and the ints
+    std::ifstream in(file.name, std::ios::binary);
+    int r = 0;
+    int nWords = 0;
+    while (in.read(reinterpret_cast<char*>(&nWords), sizeof(nWords))) {
+      REQUIRE(nWords == 2 * nPairs);
+      std::vector<float> floats(nPairs);
+      std::vector<int> ints(nPairs);
+      REQUIRE(in.read(reinterpret_cast<char*>(floats.data()), nPairs * sizeof(float)));
+      REQUIRE(in.read(reinterpret_cast<char*>(ints.data()), nPairs * sizeof(int)));
+      REQUIRE(floats[0] == 0.f);
+      REQUIRE(ints[0] == 0);
+      REQUIRE(floats[nPairs - 4] == 0.5f); // sigma of the last measurement
+      REQUIRE(floats[nPairs - 3] == 1.f + r);
+      REQUIRE(ints[nPairs - 2] == 20 + nMeasurements - 1);
+      REQUIRE(ints[nPairs - 1] == 1000 + r);
+      ++r;
+    }
+    REQUIRE(r == 3);
+  }
+}
+
+TEST_CASE("Mille_AsynchronousMatchesSynchronous", "[mille]") {
+  TemporaryFile synchronous("TestMille_Synchronous.bin"), asynchronous("TestMille_Asynchronous.bin");
+  {
+    Mille mille(synchronous.name.c_str());
+    for (int event = 0; event < nEvents; ++event)
+      writeEvent(mille, event);
+  }
+  {
+    // blocks smaller than the long records, passed through a ring of two blocks
+    Mille mille(asynchronous.name.c_str());
+    mille.setBlockSize(256);
+    mille.setAsynchronous(true, 2);
+    for (int event = 0; event < nEvents; ++event)
+      writeEvent(mille, event);
+  }
+
+  REQUIRE(contentOf(synchronous.name).size() > 100000);
+  REQUIRE(contentOf(asynchronous.name) == contentOf(synchronous.name));
+}
+
+TEST_CASE("MilleSinkFactory_MergeMatchesSynchronous", "[mille]") {
+  TemporaryFile synchronous("TestMille_Reference.bin"), merged("TestMille_Merged.bin");
+  long long nRecords = 0;
+  {
+    Mille mille(synchronous.name.c_str());
+    for (int event = 0; event < nEvents; ++event)
+      writeEvent(mille, event);
+    nRecords = mille.getNumberOfRecords();
+  }
+
+  // the events are handed out to the threads as they become free
+  MilleSinkFactory factory(merged.name, true);
+  std::atomic<int> nextEvent(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&factory, &nextEvent]() {
+      MilleSink& sink = factory.getSink();
+      for (int event = nextEvent++; event < nEvents; event = nextEvent++) {
+        sink.setEvent(event);
+        writeEvent(sink, event);
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  const std::vector<std::string> shards = factory.getShardFileNames();
+  REQUIRE(factory.merge() == nRecords);
+  REQUIRE(contentOf(merged.name) == contentOf(synchronous.name));
+  for (const std::string& shard : shards)
+    REQUIRE(!std::filesystem::exists(shard));
+
+  // the factory is done after the merge
+  REQUIRE(factory.getShardFileNames().empty());
+  REQUIRE_THROWS_AS(factory.getSink(), std::runtime_error);
+  REQUIRE_THROWS_AS(factory.merge(), std::runtime_error);
+  REQUIRE(contentOf(merged.name) == contentOf(synchronous.name));
+}
+
+TEST_CASE("MilleSinkFactory_MergeUnorderedEvents", "[mille]") {
+  TemporaryFile synchronous("TestMille_UnorderedReference.bin"), merged("TestMille_Unordered.bin");
+  {
+    Mille mille(synchronous.name.c_str());
+    for (int event : {1, 1, 4, 5})
+      writeEvent(mille, event);
+  }
+
+  // records of the same event stay in the order they were written
+  MilleSinkFactory factory(merged.name);
+  MilleSink& sink = factory.getSink();
+  for (int event : {5, 1, 4, 1}) {
+    sink.setEvent(event);
+    writeEvent(sink, event);
+  }
+  REQUIRE(sink.getEventRuns().size() == 4);
+  REQUIRE(factory.merge() == 5);
+  REQUIRE(contentOf(merged.name) == contentOf(synchronous.name));
+}
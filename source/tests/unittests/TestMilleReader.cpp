@@ -0,0 +1,197 @@
+#include "mille/Mille.h"
+#include "mille/MilleReader.h"
+#include "TestFiles.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using TestHelpers::TemporaryFile;
+
+namespace {
+const int nRecords = 50;
+
+// record r: 1 + r % 4 measurements with 2 local and 3 global derivatives,
+// every tenth record with special values
+void writeRecords(const std::string& fileName, bool asBinary) {
+  Mille mille(fileName.c_str(), asBinary);
+  for (int r = 0; r < nRecords; ++r) {
+    if (r % 10 == 0) {
+      const float floatings[2] = {1.5f, float(r)};
+      const int integers[2] = {7, r};
+      mille.special(2, floatings, integers);
+    }
+    for (int m = 0; m <= r % 4; ++m) {
+      const float derLc[2] = {1.f, 0.5f};
+      const float derGl[3] = {1.f + r, 2.f, -1.f};
+      const int label[3] = {10, 20 + m, 1000 + r};
+      mille.mille(2, derLc, 3, derGl, label, 0.25f * m, 0.5f);
+    }
+    mille.end();
+  }
+}
+
+// number of the record written by writeRecords, from its last global label
+int recordNumber(const MilleRecord& record) {
+  int pos = 1;
+  MilleRecord::Measurement measurement;
+  return record.nextMeasurement(pos, measurement) ? measurement.label[2] - 1000 : -1;
+}
+
+void checkRecord(const MilleRecord& record, int r) {
+  REQUIRE(record.getErrorCount() == 0);
+
+  int pos = 1;
+  int nMeasurements = 0;
+  MilleRecord::Measurement measurement;
+  while (record.nextMeasurement(pos, measurement)) {
+    REQUIRE(measurement.rMeas == 0.25f * nMeasurements);
+    REQUIRE(measurement.sigma == 0.5f);
+    REQUIRE(measurement.nLocal == 2);
+    REQUIRE(measurement.derLc[1] == 0.5f);
+    REQUIRE(measurement.localIndex[1] == 2);
+    REQUIRE(measurement.nGlobal == 3);
+    REQUIRE(measurement.derGl[0] == 1.f + r);
+    REQUIRE(measurement.label[1] == 20 + nMeasurements);
+    REQUIRE(measurement.label[2] == 1000 + r);
+    ++nMeasurements;
+  }
+  REQUIRE(pos == record.size());
+  REQUIRE(nMeasurements == 1 + r % 4);
+
+  int nSpecial = 0;
+  const float* floatings = nullptr;
+  const int* integers = nullptr;
+  REQUIRE(record.getSpecial(nSpecial, floatings, integers) == (r % 10 == 0));
+  if (r % 10 == 0) {
+    REQUIRE(nSpecial == 2);
+    REQUIRE(floatings[1] == float(r));
+    REQUIRE(integers[0] == 7);
+  }
+}
+
+void checkFile(const std::string& fileName, bool asBinary) {
+  MilleReader reader(fileName, asBinary);
+  int r = 0;
+  MilleReader::iterator it = reader.begin();
+  for (; it != reader.end(); ++it)
+    checkRecord(*it, r++);
+  REQUIRE(r == nRecords);
+  REQUIRE(it.getOffset() == reader.getFileSize());
+}
+} // namespace
+
+TEST_CASE("MilleReader_Binary", "[mille]") {
+  TemporaryFile file("TestMilleReader.bin");
+  writeRecords(file.name, true);
+  checkFile(file.name, true);
+}
+
+TEST_CASE("MilleReader_Text", "[mille]") {
+  TemporaryFile file("TestMilleReader.txt");
+  writeRecords(file.name, false);
+  checkFile(file.name, false);
+
+  MilleReader reader(file.name, false);
+  REQUIRE_THROWS_AS(reader.split(2), std::runtime_error);
+}
+
+TEST_CASE("MilleReader_Split", "[mille]") {
+  TemporaryFile file("TestMilleReader_Split.bin");
+  writeRecords(file.name, true);
+  const MilleReader reader(file.name, true);
+
+  // every record is in exactly one chunk, in the order of the file
+  for (int nChunks : {1, 2, 3, 7, nRecords, 2 * nRecords}) {
+    const std::vector<MilleReader::iterator> chunks = reader.split(nChunks);
+    REQUIRE(chunks.size() == size_t(nChunks + 1));
+    int r = 0;
+    for (int i = 0; i < nChunks; ++i) {
+      for (MilleReader::iterator it = chunks[i]; it != chunks[i + 1]; ++it)
+        REQUIRE(recordNumber(*it) == r++);
+    }
+    REQUIRE(r == nRecords);
+  }
+}
+
+TEST_CASE("MilleReader_TruncatedLastRecord", "[mille]") {
+  TemporaryFile binary("TestMilleReader_Truncated.bin"), text("TestMilleReader_Truncated.txt");
+  writeRecords(binary.name, true);
+  writeRecords(text.name, false);
+  std::filesystem::resize_file(binary.name, std::filesystem::file_size(binary.name) - 4);
+  std::filesystem::resize_file(text.name, std::filesystem::file_size(text.name) - 8);
+
+  for (const std::string& fileName : {binary.name, text.name}) {
+    const bool asBinary = fileName == binary.name;
+    MilleReader reader(fileName, asBinary);
+    int r = 0;
+    MilleReader::iterator it = reader.begin();
+    for (; it != reader.end(); ++it)
+      REQUIRE(recordNumber(*it) == r++);
+
+    // reading stops before the torn record
+    REQUIRE(r == nRecords - 1);
+    REQUIRE(it.getOffset() < reader.getFileSize());
+  }
+
+  const MilleReader reader(binary.name, true);
+  const std::vector<MilleReader::iterator> chunks = reader.split(4);
+  int r = 0;
+  for (int i = 0; i < 4; ++i) {
+    for (MilleReader::iterator it = chunks[i]; it != chunks[i + 1]; ++it)
+      ++r;
+  }
+  REQUIRE(r == nRecords - 1);
+}
+
+TEST_CASE("MilleReader_LongRecord", "[mille]") {
+  // records longer than the initial 5000 pairs of the Mille buffer, with
+  // output blocks larger and smaller than a record
+  const int nMeasurements = 1000;
+  for (unsigned int blockSize : {1u << 22, 1024u}) {
+    TemporaryFile file("TestMilleReader_LongRecord.bin");
+    {
+      Mille mille(file.name.c_str(), true);
+      mille.setBlockSize(blockSize);
+      for (int r = 0; r < 3; ++r) {
+        for (int m = 0; m < nMeasurements; ++m) {
+          const float derLc[2] = {1.f, 0.5f};
+          const float derGl[3] = {1.f + r, 2.f, -1.f};
+          const int label[3] = {10, 20 + m, 1000 + r};
+          mille.mille(2, derLc, 3, derGl, label, 0.25f * m, 0.5f);
+        }
+        mille.end();
+      }
+      REQUIRE(mille.getNumberOfRecords() == 3);
+    }
+
+    MilleReader reader(file.name, true);
+    int r = 0;
+    MilleReader::iterator it = reader.begin();
+    for (; it != reader.end(); ++it, ++r) {
+      const MilleRecord& record = *it;
+      REQUIRE(record.size() > 5000);
+      REQUIRE(record.getErrorCount() == 0);
+
+      int pos = 1;
+      int m = 0;
+      MilleRecord::Measurement measurement;
+      while (record.nextMeasurement(pos, measurement)) {
+        REQUIRE(measurement.rMeas == 0.25f * m);
+        REQUIRE(measurement.nLocal == 2);
+        REQUIRE(measurement.nGlobal == 3);
+        REQUIRE(measurement.derGl[0] == 1.f + r);
+        REQUIRE(measurement.label[1] == 20 + m);
+        REQUIRE(measurement.label[2] == 1000 + r);
+        ++m;
+      }
+      REQUIRE(pos == record.size());
+      REQUIRE(m == nMeasurements);
+    }
+    REQUIRE(r == 3);
+    REQUIRE(it.getOffset() == reader.getFileSize());
+  }
+}
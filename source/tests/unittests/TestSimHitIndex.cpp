@@ -0,0 +1,121 @@
+#include "MarlinUtil.h"
+#include "SimHitIndex.h"
+
+#include <IMPL/CalorimeterHitImpl.h>
+#include <IMPL/LCCollectionVec.h>
+#include <IMPL/LCEventImpl.h>
+#include <IMPL/MCParticleImpl.h>
+#include <IMPL/SimCalorimeterHitImpl.h>
+#include <IMPL/SimTrackerHitImpl.h>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+namespace {
+// Three MC particles, hits in two collections of each hit type. Particle 0 has three tracker hits
+// and contributes twice to one calorimeter hit, particle 1 has one tracker hit and one
+// contribution, particle 2 has no hits at all.
+struct SimHitEvent {
+  IMPL::LCEventImpl evt;
+  std::vector<IMPL::MCParticleImpl*> particles;
+  std::vector<IMPL::SimTrackerHitImpl*> trackerHits;
+  std::vector<IMPL::SimCalorimeterHitImpl*> caloHits;
+
+  SimHitEvent() {
+    auto* mcParticles = new IMPL::LCCollectionVec(lcio::LCIO::MCPARTICLE);
+    for (int i = 0; i < 3; ++i) {
+      particles.push_back(new IMPL::MCParticleImpl);
+      mcParticles->addElement(particles.back());
+    }
+    evt.addCollection(mcParticles, "MCParticle");
+
+    const int trackerHitParticles[2][2] = {{0, 1}, {0, 0}};
+    for (int c = 0; c < 2; ++c) {
+      auto* col = new IMPL::LCCollectionVec(lcio::LCIO::SIMTRACKERHIT);
+      for (int i : trackerHitParticles[c]) {
+        trackerHits.push_back(new IMPL::SimTrackerHitImpl);
+        trackerHits.back()->setMCParticle(particles[i]);
+        col->addElement(trackerHits.back());
+      }
+      evt.addCollection(col, c == 0 ? "VXDCollection" : "SITCollection");
+    }
+
+    for (int c = 0; c < 2; ++c) {
+      auto* col = new IMPL::LCCollectionVec(lcio::LCIO::SIMCALORIMETERHIT);
+      caloHits.push_back(new IMPL::SimCalorimeterHitImpl);
+      col->addElement(caloHits.back());
+      evt.addCollection(col, c == 0 ? "EcalBarrelCollection" : "HcalBarrelCollection");
+    }
+    caloHits[0]->addMCParticleContribution(particles[0], 0.25f, 1.f);
+    caloHits[0]->addMCParticleContribution(particles[1], 0.5f, 1.f);
+    caloHits[1]->addMCParticleContribution(particles[0], 1.5f, 2.f);
+
+    for (int c = 0; c < 2; ++c) {
+      auto* col = new IMPL::LCCollectionVec(lcio::LCIO::CALORIMETERHIT);
+      for (float energy : {1.f + c, 0.5f}) {
+        auto* hit = new IMPL::CalorimeterHitImpl;
+        hit->setEnergy(energy);
+        col->addElement(hit);
+      }
+      evt.addCollection(col, c == 0 ? "ECALBarrel" : "HCALBarrel");
+    }
+  }
+};
+} // namespace
+
+TEST_CASE("SimHitIndex_Lookups", "[simhitindex]") {
+  SimHitEvent event;
+  const MarlinUtil::SimHitIndex index(&event.evt);
+
+  // in the order of the collections of the event
+  const std::vector<lcio::SimTrackerHit*> expected = {event.trackerHits[0], event.trackerHits[2],
+                                                      event.trackerHits[3]};
+  REQUIRE(index.getSimTrackerHits(event.particles[0]) == expected);
+  REQUIRE(index.getSimTrackerHits(event.particles[1]).size() == 1);
+  REQUIRE(index.getSimTrackerHits(event.particles[2]).empty());
+
+  const auto& contributions = index.getCaloContributions(event.particles[0]);
+  REQUIRE(contributions.size() == 2);
+  REQUIRE(contributions[0].hit == event.caloHits[0]);
+  REQUIRE(contributions[0].index == 0);
+  REQUIRE(contributions[1].hit == event.caloHits[1]);
+  REQUIRE(contributions[1].index == 0);
+  REQUIRE(index.getCaloContributions(event.particles[1])[0].index == 1);
+  REQUIRE(index.getCaloContributions(event.particles[2]).empty());
+
+  REQUIRE(index.getSimCalorimeterEnergy(event.particles[0]) == Catch::Approx(1.75));
+  REQUIRE(index.getSimCalorimeterEnergy(event.particles[1]) == Catch::Approx(0.5));
+  REQUIRE(index.getSimCalorimeterEnergy(event.particles[2]) == 0.);
+  REQUIRE(index.getCalorimeterEnergy() == Catch::Approx(4.));
+
+  // a particle that is not in the event at all
+  IMPL::MCParticleImpl other;
+  REQUIRE(index.getSimTrackerHits(&other).empty());
+  REQUIRE(index.getCaloContributions(&other).empty());
+  REQUIRE(index.getSimCalorimeterEnergy(&other) == 0.);
+}
+
+TEST_CASE("SimHitIndex_MarlinUtilOverloads", "[simhitindex]") {
+  SimHitEvent event;
+  const MarlinUtil::SimHitIndex index(&event.evt);
+
+  // the versions taking the index give the same results as the scans of the event
+  for (auto* mcp : event.particles) {
+    REQUIRE(MarlinUtil::countAllSimTrackerHits(index, mcp) == MarlinUtil::countAllSimTrackerHits(&event.evt, mcp));
+
+    double fromIndex = -1., fromEvent = -1.;
+    REQUIRE(MarlinUtil::countAllSimCalorimeterHits(index, mcp, fromIndex) ==
+            MarlinUtil::countAllSimCalorimeterHits(&event.evt, mcp, fromEvent));
+    REQUIRE(fromIndex == Catch::Approx(fromEvent));
+  }
+  REQUIRE(MarlinUtil::countAllSimTrackerHits(index, event.particles[0]) == 3);
+
+  double energy = -1.;
+  REQUIRE(MarlinUtil::countAllSimCalorimeterHits(index, event.particles[0], energy) == 2);
+  REQUIRE(energy == Catch::Approx(1.75));
+
+  REQUIRE(MarlinUtil::getEnergyDepositedInFullCalorimeter(index) == Catch::Approx(4.));
+  REQUIRE(MarlinUtil::getEnergyDepositedInFullCalorimeter(&event.evt) == Catch::Approx(4.));
+}
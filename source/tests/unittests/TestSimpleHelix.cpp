@@ -0,0 +1,69 @@
+#include "SimpleHelix.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// Compare the analytic jacobian of SimpleHelix against a numerical
+// differentiation of getPosition and the momentum along the helix
+TEST_CASE("SimpleHelix_Jacobian", "[simplehelix-errors]") {
+  const std::array<double, 5> params = {1.3, 0.7, -0.002, 2.0, 0.8};
+  const double bz = 3.5;
+  const double s = 350.;
+  const LCVector3D ref(0., 0., 0.);
+
+  auto makeHelix = [&](const std::array<double, 5>& p) {
+    SimpleHelix helix(p[0], p[1], p[2], p[3], p[4], ref);
+    helix.setBz(bz);
+    return helix;
+  };
+
+  const auto jacobian = makeHelix(params).getJacobian(s);
+
+  for (int k = 0; k < 5; ++k) {
+    const double h = 1e-6 * std::max(1., std::fabs(params[k]));
+    auto pp = params, pm = params;
+    pp[k] += h;
+    pm[k] -= h;
+
+    const auto hp = makeHelix(pp), hm = makeHelix(pm);
+    const LCVector3D dx = (hp.getPosition(s) - hm.getPosition(s)) / (2 * h);
+
+    const double ptp = 2.99792458E-4 * bz / std::fabs(pp[2]);
+    const double ptm = 2.99792458E-4 * bz / std::fabs(pm[2]);
+    const LCVector3D up = hp.getDirection(s), um = hm.getDirection(s);
+    const LCVector3D dp = (ptp / up.perp() * up - ptm / um.perp() * um) / (2 * h);
+
+    for (int i = 0; i < 3; ++i) {
+      REQUIRE(jacobian[i][k] == Catch::Approx(dx[i]).margin(1e-5));
+      REQUIRE(jacobian[i + 3][k] == Catch::Approx(dp[i]).margin(1e-5));
+    }
+  }
+}
+
+TEST_CASE("SimpleHelix_PositionErrors", "[simplehelix-errors]") {
+  LCErrorMatrix errors(5, 0);
+  errors[0][0] = 0.01;   // d0
+  errors[3][3] = 0.04;   // z0
+
+  SimpleHelix helix(0., 0., 0.001, 0., 0.5, LCVector3D(0., 0., 0.), &errors);
+
+  // at the reference point d0 and z0 are the only contributions
+  LCErrorMatrix posErrors;
+  helix.getPosition(0., &posErrors);
+
+  REQUIRE(posErrors.num_row() == 3);
+  REQUIRE(posErrors[1][1] == Catch::Approx(0.01));
+  REQUIRE(posErrors[2][2] == Catch::Approx(0.04));
+  REQUIRE(posErrors[0][0] == Catch::Approx(0.).margin(1e-12));
+
+  // constraining to the plane x = 100 removes the error along the track
+  const auto states = SimpleHelix::propagateToPlane({&helix}, LCPlane3D(LCVector3D(1., 0., 0.), 100.));
+  REQUIRE(states.size() == 1);
+  REQUIRE(states[0].exists);
+  REQUIRE(states[0].errors[0][0] == Catch::Approx(0.).margin(1e-9));
+  REQUIRE(states[0].errors[2][2] == Catch::Approx(0.04));
+}
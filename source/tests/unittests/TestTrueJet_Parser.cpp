@@ -0,0 +1,142 @@
+#include "TestTrueJets.h"
+#include "TrueJet_Parser.h"
+
+#include <IMPL/LCCollectionVec.h>
+#include <IMPL/LCEventImpl.h>
+#include <IMPL/MCParticleImpl.h>
+#include <IMPL/ReconstructedParticleImpl.h>
+#include <UTIL/LCRelationNavigator.h>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+// Two true jets. Jet 0 holds particle 1, its decay product 2 and the FSR photon 3 (weight -1), and
+// comes from quark 0. Jet 1 holds particle 4. Particles 1 and 2 are seen, 3 and 4 are not.
+struct TrueJetEvent {
+  IMPL::LCEventImpl evt;
+  std::vector<IMPL::MCParticleImpl*> particles;
+  std::vector<IMPL::ReconstructedParticleImpl*> jets;
+
+  TrueJetEvent(int run, int event, bool withRecoMCTruthLink) {
+    evt.setRunNumber(run);
+    evt.setEventNumber(event);
+
+    auto* mcParticles = new IMPL::LCCollectionVec(lcio::LCIO::MCPARTICLE);
+    for (int i = 0; i < 5; ++i) {
+      auto* mcp = new IMPL::MCParticleImpl;
+      const double mom[3] = {1. + i, -0.5 * i, 2. - i};
+      mcp->setMomentum(mom);
+      mcp->setMass(0.1 * i);
+      mcParticles->addElement(mcp);
+      particles.push_back(mcp);
+    }
+    particles[2]->addParent(particles[1]);
+    evt.addCollection(mcParticles, "MCParticle");
+
+    auto* trueJets = new IMPL::LCCollectionVec(lcio::LCIO::RECONSTRUCTEDPARTICLE);
+    for (int i = 0; i < 2; ++i) {
+      jets.push_back(new IMPL::ReconstructedParticleImpl);
+      trueJets->addElement(jets.back());
+    }
+    evt.addCollection(trueJets, "TrueJets");
+    evt.addCollection(new IMPL::LCCollectionVec(lcio::LCIO::RECONSTRUCTEDPARTICLE), "FinalColourNeutrals");
+    evt.addCollection(new IMPL::LCCollectionVec(lcio::LCIO::RECONSTRUCTEDPARTICLE), "InitialColourNeutrals");
+
+    UTIL::LCRelationNavigator jetParticles(lcio::LCIO::RECONSTRUCTEDPARTICLE, lcio::LCIO::MCPARTICLE);
+    jetParticles.addRelation(jets[0], particles[1], 1.f);
+    jetParticles.addRelation(jets[0], particles[2], 1.f);
+    jetParticles.addRelation(jets[0], particles[3], -1.f);
+    jetParticles.addRelation(jets[1], particles[4], 1.f);
+    evt.addCollection(jetParticles.createLCCollection(), "TrueJetMCParticleLink");
+
+    UTIL::LCRelationNavigator finalElementons(lcio::LCIO::RECONSTRUCTEDPARTICLE, lcio::LCIO::MCPARTICLE);
+    finalElementons.addRelation(jets[0], particles[0], 1.f);
+    evt.addCollection(finalElementons.createLCCollection(), "FinalElementonLink");
+
+    if (withRecoMCTruthLink) {
+      auto* pfos = new IMPL::LCCollectionVec(lcio::LCIO::RECONSTRUCTEDPARTICLE);
+      UTIL::LCRelationNavigator recoTruth(lcio::LCIO::RECONSTRUCTEDPARTICLE, lcio::LCIO::MCPARTICLE);
+      for (int i : {1, 2}) {
+        auto* pfo = new IMPL::ReconstructedParticleImpl;
+        pfos->addElement(pfo);
+        recoTruth.addRelation(pfo, particles[i], 1.f);
+      }
+      evt.addCollection(pfos, "PandoraPFOs");
+      evt.addCollection(recoTruth.createLCCollection(), "RecoMCTruthLink");
+    }
+  }
+
+  // four-vector sum of the given particles, component 0 is E
+  std::vector<double> sum(const std::vector<int>& indices) const {
+    std::vector<double> p4(4, 0.);
+    for (int i : indices) {
+      p4[0] += particles[i]->getEnergy();
+      for (int k = 0; k < 3; ++k) {
+        p4[k + 1] += particles[i]->getMomentum()[k];
+      }
+    }
+    return p4;
+  }
+};
+
+double massOf(const std::vector<double>& p4) {
+  return std::sqrt(p4[0] * p4[0] - p4[1] * p4[1] - p4[2] * p4[2] - p4[3] * p4[3]);
+}
+} // namespace
+
+TEST_CASE("TrueJet_Parser_Kinematics", "[truejet]") {
+  TrueJetEvent event(1, 1, true);
+  TestHelpers::TrueJets trueJets;
+  trueJets.getall(&event.evt);
+  REQUIRE(trueJets.njets() == 2);
+
+  // the FSR photon counts as true
+  const std::vector<double> true0 = event.sum({1, 2, 3});
+  REQUIRE(trueJets.Etrue(0) == Catch::Approx(true0[0]));
+  for (int k = 0; k < 3; ++k) {
+    REQUIRE(trueJets.ptrue(0)[k] == Catch::Approx(true0[k + 1]));
+    REQUIRE(trueJets.p4true(0)[k + 1] == Catch::Approx(true0[k + 1]));
+  }
+  REQUIRE(trueJets.Mtrue(0) == Catch::Approx(massOf(true0)));
+  REQUIRE(trueJets.Etrue(1) == Catch::Approx(event.particles[4]->getEnergy()));
+
+  // the decay product of the seen particle 1 is not counted again
+  const std::vector<double> seen0 = event.sum({1});
+  REQUIRE(trueJets.Etrueseen(0) == Catch::Approx(seen0[0]));
+  for (int k = 0; k < 3; ++k) {
+    REQUIRE(trueJets.ptrueseen(0)[k] == Catch::Approx(seen0[k + 1]));
+    REQUIRE(trueJets.p4trueseen(0)[k + 1] == Catch::Approx(seen0[k + 1]));
+  }
+  REQUIRE(trueJets.Mtrueseen(0) == Catch::Approx(massOf(seen0)));
+  REQUIRE(trueJets.Etrueseen(1) == 0.);
+
+  REQUIRE(trueJets.Equark(0) == Catch::Approx(event.particles[0]->getEnergy()));
+  REQUIRE(trueJets.Mquark(0) == Catch::Approx(event.particles[0]->getMass()));
+  REQUIRE(trueJets.pquark(0)[2] == Catch::Approx(event.particles[0]->getMomentum()[2]));
+  REQUIRE(trueJets.Equark(1) == 0.);
+
+  // the values do not depend on how often or in which order they are asked for
+  REQUIRE(trueJets.Etrueseen(1) == 0.);
+  REQUIRE(trueJets.Etrueseen(0) == Catch::Approx(seen0[0]));
+  trueJets.delall();
+}
+
+TEST_CASE("TrueJet_Parser_RecoMCTruthLinkOnFirstUse", "[truejet]") {
+  TrueJetEvent event(1, 2, false);
+  TestHelpers::TrueJets trueJets;
+  trueJets.getall(&event.evt);
+
+  // the true values do not need the RecoMCTruthLink
+  REQUIRE(trueJets.reltrue_tj == nullptr);
+  REQUIRE(trueJets.Etrue(0) == Catch::Approx(event.sum({1, 2, 3})[0]));
+  REQUIRE(trueJets.reltrue_tj == nullptr);
+
+  // without the link nothing is seen
+  REQUIRE(trueJets.Etrueseen(0) == 0.);
+  REQUIRE(trueJets.reltrue_tj != nullptr);
+  trueJets.delall();
+}
@@ -0,0 +1,26 @@
+#ifndef TestTrueJets_h
+#define TestTrueJets_h 1
+
+// TrueJet_Parser for the unit tests that need the TrueJet collections
+
+#include "TrueJet_Parser.h"
+
+namespace TestHelpers {
+// TrueJet_Parser reading the collections with the names the TrueJet processor writes
+struct TrueJets : TrueJet_Parser {
+  TrueJets() {
+    _trueJetCollectionName = "TrueJets";
+    _finalColourNeutralCollectionName = "FinalColourNeutrals";
+    _initialColourNeutralCollectionName = "InitialColourNeutrals";
+    _trueJetPFOLink = "TrueJetPFOLink";
+    _trueJetMCParticleLink = "TrueJetMCParticleLink";
+    _finalElementonLink = "FinalElementonLink";
+    _initialElementonLink = "InitialElementonLink";
+    _finalColourNeutralLink = "FinalColourNeutralLink";
+    _initialColourNeutralLink = "InitialColourNeutralLink";
+    _recoMCTruthLink = "RecoMCTruthLink";
+  }
+};
+} // namespace TestHelpers
+
+#endif
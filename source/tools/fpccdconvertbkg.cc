@@ -0,0 +1,51 @@
+/** Converts FPCCD background pixel hits from LCIO files (LCGenericObject
+ *  collections in the format of FPCCDData.h) to a memory mappable
+ *  FPCCDPixelLibrary, one library entry per event.
+ *
+ *  usage: fpccdconvertbkg [-c collection] [-l layers] [-d ladders] library.bkg input.slcio [input.slcio ...]
+ */
+#include "FPCCDPixelLibrary.h"
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+  std::string colName="VTXPixelHits";
+  int nLayers=6;
+  int nLadders=17;
+  std::vector<std::string> args;
+
+  for(int i=1; i<argc; i++){
+    std::string arg=argv[i];
+    if( ( arg == "-c" || arg == "-l" || arg == "-d" ) && i+1 < argc ) {
+      std::string value=argv[++i];
+      if( arg == "-c" ) { colName=value; }
+      else if( arg == "-l" ) { nLayers=std::atoi(value.c_str()); }
+      else { nLadders=std::atoi(value.c_str()); }
+    }
+    else {
+      args.push_back(arg);
+    }
+  }
+
+  if( args.size() < 2 || nLayers <= 0 || nLadders <= 0 ) {
+    std::cout << "usage: " << argv[0] << " [-c collection] [-l layers] [-d ladders] library.bkg input.slcio [input.slcio ...]" << std::endl
+              << "  appends the pixel hits of every event to the library, defaults: -c VTXPixelHits -l 6 -d 17" << std::endl;
+    return 1;
+  }
+
+  try {
+    std::vector<std::string> inputs(args.begin()+1, args.end());
+    int nEvents=FPCCDPixelLibraryWriter::convert(inputs, colName, args[0], nLayers, nLadders);
+    std::cout << "converted " << nEvents << " events to " << args[0] << std::endl;
+  }
+  catch(std::exception &e) {
+    std::cerr << "fpccdconvertbkg: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
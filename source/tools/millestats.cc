@@ -0,0 +1,229 @@
+/** Statistics of a Mille file (the input of pede): numbers of records and
+ *  measurements, records with measurements dropped by Mille, the distribution
+ *  of the normalised residuals rMeas/sigma and, per global label, the number
+ *  of measurements and the mean and rms of the derivatives. Binary files are
+ *  read in parallel chunks.
+ *
+ *  usage: millestats [-t] [-j threads] [-l labels.txt] mp2input.bin
+ */
+#include "mille/MilleReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+  const int nPullBins=40;        // bins of 0.5 in rMeas/sigma from -10 to 10
+  const double pullRange=10.;
+
+  // Neumaier compensated sum, the rounding errors of the additions are
+  // collected in compensation, so the sum hardly depends on the order of the
+  // values or on how they are split into chunks
+  struct CompensatedSum {
+    double sum=0, compensation=0;
+
+    void add(double value){
+      double t=sum+value;
+      compensation += ( std::fabs(sum) >= std::fabs(value) ? ( sum-t )+value : ( value-t )+sum );
+      sum=t;
+    }
+    void add(const CompensatedSum &other){ add(other.sum); add(other.compensation); }
+    double value() const { return sum+compensation; }
+  };
+
+  struct LabelStatistics {
+    long long n=0;
+    CompensatedSum sumDer{}, sumDer2{};
+  };
+
+  struct Statistics {
+    long long nRecords=0;
+    long long nMeasurements=0;
+    long long nLocal=0;
+    long long nGlobal=0;
+    long long nRecordsWithDropped=0;
+    long long nDropped=0;
+    long long nSpecial=0;
+    long long nMalformed=0;
+    long long nNotFinite=0;        // measurements with rMeas/sigma inf or nan, not in pulls
+    std::vector<long long> pulls=std::vector<long long>(nPullBins+2, 0);   // with under- and overflow
+    std::unordered_map<int, LabelStatistics> labels{};
+
+    void add(const MilleRecord &record){
+      nRecords++;
+      if( record.getErrorCount() > 0 ) {
+        nRecordsWithDropped++;
+        nDropped += record.getErrorCount();
+      }
+
+      int nSpecialValues;
+      const float *floatings;
+      const int *integers;
+      if( record.getSpecial(nSpecialValues, floatings, integers) ) { nSpecial++; }
+
+      int pos=1;
+      MilleRecord::Measurement measurement;
+      while( record.nextMeasurement(pos, measurement) ) {
+        nMeasurements++;
+        nLocal += measurement.nLocal;
+        nGlobal += measurement.nGlobal;
+
+        double pull=measurement.rMeas/measurement.sigma;
+        if( !std::isfinite(pull) ) {
+          nNotFinite++;
+        } else {
+          int bin=( pull < -pullRange ? 0 : pull >= pullRange ? nPullBins+1 : 1+int( ( pull+pullRange )*nPullBins/( 2*pullRange ) ) );
+          pulls[std::min(bin, nPullBins+1)]++;
+        }
+
+        for(int i=0; i<measurement.nGlobal; i++){
+          LabelStatistics &label=labels[measurement.label[i]];
+          label.n++;
+          label.sumDer.add(measurement.derGl[i]);
+          label.sumDer2.add(double(measurement.derGl[i])*measurement.derGl[i]);
+        }
+      }
+      if( pos != record.size() ) { nMalformed++; }
+    }
+
+    void add(const Statistics &other){
+      nRecords += other.nRecords;
+      nMeasurements += other.nMeasurements;
+      nLocal += other.nLocal;
+      nGlobal += other.nGlobal;
+      nRecordsWithDropped += other.nRecordsWithDropped;
+      nDropped += other.nDropped;
+      nSpecial += other.nSpecial;
+      nMalformed += other.nMalformed;
+      nNotFinite += other.nNotFinite;
+      for(int i=0; i<nPullBins+2; i++){ pulls[i] += other.pulls[i]; }
+      for(const auto &entry : other.labels){
+        LabelStatistics &label=labels[entry.first];
+        label.n += entry.second.n;
+        label.sumDer.add(entry.second.sumDer);
+        label.sumDer2.add(entry.second.sumDer2);
+      }
+    }
+  };
+}
+
+int main(int argc, char **argv)
+{
+  bool asBinary=true;
+  int nThreads=std::max(1u, std::thread::hardware_concurrency());
+  std::string labelFileName;
+  std::vector<std::string> args;
+
+  for(int i=1; i<argc; i++){
+    std::string arg=argv[i];
+    if( arg == "-t" ) { asBinary=false; }
+    else if( ( arg == "-j" || arg == "-l" ) && i+1 < argc ) {
+      std::string value=argv[++i];
+      if( arg == "-j" ) { nThreads=std::atoi(value.c_str()); }
+      else { labelFileName=value; }
+    }
+    else {
+      args.push_back(arg);
+    }
+  }
+
+  if( args.size() != 1 || nThreads <= 0 ) {
+    std::cout << "usage: " << argv[0] << " [-t] [-j threads] [-l labels.txt] mp2input.bin" << std::endl
+              << "  -t : the file is a text file written by Mille with asBinary=false" << std::endl
+              << "  -j : number of threads reading a binary file, default: number of cores" << std::endl
+              << "  -l : write the statistics of every global label to labels.txt" << std::endl;
+    return 1;
+  }
+
+  Statistics total;
+  std::size_t bytesRead=0;
+  std::size_t fileSize=0;
+
+  try {
+    MilleReader reader(args[0], asBinary);
+    fileSize=reader.getFileSize();
+
+    if( asBinary ) {
+      std::vector<MilleReader::iterator> chunks=reader.split(nThreads);
+      std::vector<Statistics> chunkStatistics(nThreads);
+      std::vector<std::size_t> chunkEnd(nThreads, 0);
+
+      std::vector<std::thread> threads;
+      for(int i=0; i<nThreads; i++){
+        threads.emplace_back([&, i](){
+            MilleReader::iterator it=chunks[i];
+            for(; it!=chunks[i+1]; ++it){ chunkStatistics[i].add(*it); }
+            chunkEnd[i]=it.getOffset();
+          });
+      }
+      for(auto &thread : threads){ thread.join(); }
+
+      // chunks are merged in order; the counts do not depend on the number of
+      // threads, the compensated sums of the derivatives only in the last bits
+      for(int i=0; i<nThreads; i++){
+        total.add(chunkStatistics[i]);
+        bytesRead=std::max(bytesRead, chunkEnd[i]);
+      }
+    }
+    else {
+      MilleReader::iterator it=reader.begin();
+      for(; it!=reader.end(); ++it){ total.add(*it); }
+      bytesRead=it.getOffset();
+    }
+  }
+  catch(std::exception &e) {
+    std::cerr << "millestats: " << e.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "file                            : " << args[0] << std::endl
+            << "records                         : " << total.nRecords << std::endl
+            << "measurements                    : " << total.nMeasurements << std::endl
+            << "local derivatives               : " << total.nLocal << std::endl
+            << "global derivatives              : " << total.nGlobal << std::endl
+            << "global labels                   : " << total.labels.size() << std::endl
+            << "records with special data       : " << total.nSpecial << std::endl
+            << "records with dropped data       : " << total.nRecordsWithDropped
+            << " (" << total.nDropped << " measurements dropped by Mille)" << std::endl
+            << "malformed records               : " << total.nMalformed << std::endl;
+  if( bytesRead < fileSize ) {
+    std::cout << "unreadable bytes at end of file : " << fileSize-bytesRead << " from byte " << bytesRead << std::endl;
+  }
+
+  std::cout << std::endl << "rMeas/sigma distribution" << std::endl;
+  std::cout << "         < " << std::setw(5) << -pullRange << " : " << total.pulls[0] << std::endl;
+  for(int i=1; i<=nPullBins; i++){
+    double low=-pullRange+( i-1 )*2*pullRange/nPullBins;
+    std::cout << std::setw(6) << low << " .. " << std::setw(5) << low+2*pullRange/nPullBins << " : " << total.pulls[i] << std::endl;
+  }
+  std::cout << "        >= " << std::setw(5) << pullRange << " : " << total.pulls[nPullBins+1] << std::endl;
+  std::cout << std::setw(16) << "inf or nan" << " : " << total.nNotFinite << std::endl;
+
+  if( !labelFileName.empty() ) {
+    std::ofstream labelFile(labelFileName.c_str());
+    std::map<int, LabelStatistics> sorted(total.labels.begin(), total.labels.end());
+    labelFile << "# label  measurements  mean_derivative  rms_derivative" << std::endl;
+    for(const auto &entry : sorted){
+      const LabelStatistics &label=entry.second;
+      double mean=label.sumDer.value()/label.n;
+      double rms=std::sqrt(label.sumDer2.value()/label.n);
+      labelFile << entry.first << " " << label.n << " " << mean << " " << rms << "\n";
+    }
+    if( !labelFile ) {
+      std::cerr << "millestats: cannot write " << labelFileName << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}